@@ -147,24 +147,9 @@ struct queued_action_execute_event_t : public event_t
     action -> queue_event = nullptr;
 
     // Sanity check assert to catch violations. Will only trigger (if ever) with off gcd actions,
-    // and even then only in the case of bugs.
-    assert( action -> cooldown -> ready <= sim().current_time() );
-
-    // On very very rare occasions, charge-based cooldowns (which update through an event, but
-    // indicate readiness through cooldown_t::ready) can have their recharge event and the
-    // queued-action-execute event occur on the same timestamp in such a way that the events flip to
-    // the wrong order (queued-action-execute comes before recharge event). If this is the case, we
-    // need to flip them around to ensure that the sim internal state checks do not fail. The
-    // solution is to simply recreate the queued-action-execute event on the same timestamp, which
-    // will once again flip the ordering (i.e., lets the recharge event occur first).
-    if ( action -> cooldown -> charges > 1 && action -> cooldown -> current_charge == 0 &&
-         action -> cooldown -> recharge_event &&
-         action -> cooldown -> recharge_event -> remains() == timespan_t::zero() )
-    {
-      action -> queue_event = make_event<queued_action_execute_event_t>( sim(), action, timespan_t::zero(), off_gcd );
-      // Note, processing ends here
-      return;
-    }
+    // and even then only in the case of bugs. Charges regained on this timestamp count as up, so
+    // the queued execution no longer depends on the ordering of recharge events.
+    assert( action -> cooldown -> up() );
 
     if ( off_gcd )
     {
@@ -273,10 +258,9 @@ struct aoe_target_list_callback_t
   aoe_target_list_callback_t( action_t* a ) :
     action( a ) {}
 
-  void operator()(player_t*)
+  void operator()( player_t* t )
   {
-    // Invalidate target cache
-    action -> target_cache.is_valid = false;
+    action -> update_target_cache( t );
   }
 };
 
@@ -604,12 +588,7 @@ action_t::~action_t()
   delete interrupt_if_expr;
   delete early_chain_if_expr;
 
-  while ( state_cache != 0 )
-  {
-    action_state_t* s = state_cache;
-    state_cache = s -> next;
-    delete s;
-  }
+  // Released states are owned by player -> state_pool
 }
 
 /**
@@ -646,28 +625,29 @@ void action_t::parse_spell_data( const spell_data_t& spell_data )
     cooldown -> duration = spell_data.cooldown();
   }
 
-  if (spell_data._power)
+  const std::vector<const spellpower_data_t*>* power = spell_data.power_list();
+  if (power)
   {
-    if (spell_data._power->size() == 1 && spell_data._power -> at( 0 ) -> aura_id() == 0 )
+    if (power->size() == 1 && power -> at( 0 ) -> aura_id() == 0 )
     {
-      resource_current = spell_data._power->at(0)->resource();
+      resource_current = power->at(0)->resource();
     }
     else
     {
       // Find the first power entry without a aura id
-      std::vector<const spellpower_data_t*>::iterator it = std::find_if(
-          spell_data._power -> begin(), spell_data._power -> end(),
+      std::vector<const spellpower_data_t*>::const_iterator it = std::find_if(
+          power -> begin(), power -> end(),
           power_entry_without_aura() );
-      if (it != spell_data._power -> end())
+      if (it != power -> end())
       {
         resource_current = (*it) -> resource();
       }
     }
   }
 
-  for ( size_t i = 0; spell_data._power && i < spell_data._power -> size(); i++ )
+  for ( size_t i = 0; power && i < power -> size(); i++ )
   {
-    const spellpower_data_t* pd = ( *spell_data._power )[ i ];
+    const spellpower_data_t* pd = ( *power )[ i ];
 
     if ( pd -> _cost != 0 )
       base_costs[ pd -> resource() ] = pd -> cost();
@@ -826,6 +806,39 @@ void action_t::parse_target_str()
   }
 }
 
+// action_t::callback_mask ==================================================
+
+uint64_t action_t::callback_mask( const std::vector<action_callback_t*>& list )
+{
+  auto it = range::find_if( callback_masks, [ &list ]( const callback_mask_t& m ) { return m.list == &list; } );
+  if ( it != callback_masks.end() && it -> size == list.size() )
+  {
+    return it -> mask;
+  }
+
+  uint64_t mask = 0;
+  for ( size_t i = 0, end = std::min( list.size(), size_t( 64 ) ); i < end; ++i )
+  {
+    if ( list[ i ] -> can_trigger( this ) )
+    {
+      mask |= uint64_t( 1 ) << i;
+    }
+  }
+
+  if ( it != callback_masks.end() )
+  {
+    it -> size = list.size();
+    it -> mask = mask;
+  }
+  else
+  {
+    callback_mask_t m = { &list, list.size(), mask };
+    callback_masks.push_back( m );
+  }
+
+  return mask;
+}
+
 // action_t::parse_options ==================================================
 
 void action_t::parse_options( const std::string& options_str )
@@ -1267,6 +1280,9 @@ void action_t::consume_resource()
                    resource_consumed, util::resource_type_string( cr ),
                    name(), player -> resources.current[ cr ] );
 
+  if ( sim -> trace )
+    sim -> trace -> consume( this, cr, resource_consumed, player -> resources.current[ cr ] );
+
   stats -> consume_resource( current_resource(), resource_consumed );
 }
 
@@ -1333,11 +1349,88 @@ std::vector< player_t* >& action_t::target_list() const
     if ( sim -> distance_targeting_enabled )
       check_distance_targeting( target_cache.list );
     target_cache.is_valid = true;
+    target_cache.is_default = ! sim -> distance_targeting_enabled && is_default_target_list( target_cache.list );
+    target_cache.primary = target;
+    target_cache.size = target_cache.list.size();
+    sim -> target_cache_rebuilds++;
   }
 
   return target_cache.list;
 }
 
+// action_t::is_default_target_list =========================================
+
+// Returns true if tl is the list action_t::available_targets() would produce
+
+bool action_t::is_default_target_list( const std::vector< player_t* >& tl ) const
+{
+  size_t idx = 0;
+  if ( ! target -> is_sleeping() )
+  {
+    if ( tl.empty() || tl[ 0 ] != target )
+      return false;
+    idx++;
+  }
+
+  for ( size_t i = 0, actors = sim -> target_non_sleeping_list.size(); i < actors; i++ )
+  {
+    player_t* t = sim -> target_non_sleeping_list[ i ];
+    if ( ! t -> is_enemy() || t == target )
+      continue;
+
+    if ( idx == tl.size() || tl[ idx ] != t )
+      return false;
+    idx++;
+  }
+
+  return idx == tl.size();
+}
+
+// action_t::update_target_cache ============================================
+
+// Apply a change of sim -> target_non_sleeping_list to the target cache. A default target list
+// is updated in place, mirroring how the active enemy list itself changed (push_back on arise,
+// unordered erase on demise), so the result is identical to a full rebuild. Everything else
+// is invalidated, and rebuilt on the next target_list() call.
+
+void action_t::update_target_cache( player_t* changed ) const
+{
+  if ( ! target_cache.is_valid )
+    return;
+
+  std::vector< player_t* >& tl = target_cache.list;
+  const auto& actors = sim -> target_non_sleeping_list.data();
+
+  if ( ! target_cache.is_default || target_cache.primary != target || changed == target ||
+       target_cache.size != tl.size() )
+  {
+    target_cache.is_valid = false;
+    return;
+  }
+
+  auto it = range::find( tl, changed );
+
+  // Arise, the enemy was appended to the active enemy list
+  if ( it == tl.end() )
+  {
+    tl.push_back( changed );
+  }
+  // Demise, the last enemy of the active enemy list was moved to the position of the removed one,
+  // unless it is the primary target, which is kept at the front of the target list.
+  else if ( *it != tl.back() && ! actors.empty() && actors.back() == tl.back() )
+  {
+    tl.erase( it );
+  }
+  else
+  {
+    *it = tl.back();
+    tl.pop_back();
+  }
+
+  target_cache.size = tl.size();
+  sim -> target_cache_updates++;
+}
+
 player_t* action_t::find_target_by_number( int number ) const
 {
   std::vector< player_t* >& tl = target_list();
@@ -1424,6 +1517,11 @@ void action_t::execute()
                    player -> resources.current[ player -> primary_resource() ] );
   }
 
+  if ( sim -> trace && ! dual )
+  {
+    sim -> trace -> execute( this, player -> resources.current[ player -> primary_resource() ] );
+  }
+
   hit_any_target = false;
   num_targets_hit = 0;
   interrupt_immediate_occurred = false;
@@ -1515,13 +1613,13 @@ void action_t::execute()
       // "On spell cast", only performed for foreground actions
       if ( ( pt2 = execute_state -> cast_proc_type2() ) != PROC2_INVALID )
       {
-        action_callback_t::trigger( player -> callbacks.procs[ pt ][ pt2 ], this, execute_state );
+        player -> callbacks.trigger( pt, pt2, this, execute_state );
       }
 
       // "On an execute result"
       if ( ( pt2 = execute_state -> execute_proc_type2() ) != PROC2_INVALID )
       {
-        action_callback_t::trigger( player -> callbacks.procs[ pt ][ pt2 ], this, execute_state );
+        player -> callbacks.trigger( pt, pt2, this, execute_state );
       }
     }
   }
@@ -1896,10 +1994,13 @@ bool action_t::ready()
     cycle_targets = 0;
     bool found_ready = false;
 
-    // Note, need to take a copy of the original target list here, instead of a reference. Otherwise
-    // if spell_targets (or any expression that uses the target list) modifies it, the loop below
-    // may break, since the number of elements on the vector is not the same as it originally was
-    std::vector< player_t* > ctl = target_list();
+    // Note, need to iterate over a copy of the original target list here, instead of the list
+    // itself. Otherwise if spell_targets (or any expression that uses the target list) modifies it,
+    // the loop below may break, since the number of elements on the vector is not the same as it
+    // originally was. The copy goes into cycle_target_list, which keeps its capacity between calls;
+    // this is not reentrant for the action, as cycle_targets is cleared during the loop.
+    std::vector< player_t* >& ctl = cycle_target_list;
+    ctl = target_list();
     size_t num_targets = ctl.size();
 
     if ( ( max_cycle_targets > 0 ) && ( ( size_t ) max_cycle_targets < num_targets ) )
@@ -2446,6 +2547,10 @@ expr_t* action_t::create_expression( const std::string& name_str )
       {
         return cooldown -> remains().total_seconds();
       }
+      if ( cooldown -> up() )
+      {
+        return 0.0;
+      }
       auto ready_at = ( cooldown -> ready - cooldown -> player -> cooldown_tolerance() );
       auto current_time = cooldown -> sim.current_time();
       if ( ready_at <= current_time )
@@ -3249,6 +3354,11 @@ void action_t::impact( action_state_t* s )
     {
       sim -> out_log.printf( "Target %s avoids %s %s (%s)", s -> target -> name(), player -> name(), name(), util::result_type_string( s -> result ) );
     }
+
+    if ( sim -> trace )
+    {
+      sim -> trace -> avoid( s );
+    }
   }
 }
 
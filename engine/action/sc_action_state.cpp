@@ -9,14 +9,21 @@ action_state_t* action_t::get_state( const action_state_t* other )
 {
   action_state_t* s = nullptr;
 
-  if ( state_cache )
+  if ( state_cache && *state_cache )
   {
-    s           = state_cache;
-    state_cache = s->next;
+    s            = *state_cache;
+    *state_cache = s->next;
   }
   else
   {
     s = new_state();
+
+    if ( !state_cache )
+      state_cache = &( player->state_pool.free_list( s ) );
+
+    player->state_pool.n_allocated++;
+    if ( sim->current_iteration > 0 )
+      player->state_pool.n_steady_allocated++;
   }
 
   s->action = this;
@@ -40,8 +47,31 @@ action_state_t* action_t::new_state()
 void action_t::release_state( action_state_t* s )
 {
   assert( s->action == this );
-  s->next     = state_cache;
-  state_cache = s;
+
+  // States may be created with new_state() directly, bind to the free list on release then
+  if ( !state_cache )
+    state_cache = &( player->state_pool.free_list( s ) );
+
+  assert( typeid( *s ) == typeid( **state_cache ) || !*state_cache );
+  s->next      = *state_cache;
+  *state_cache = s;
+}
+
+action_state_t*& action_state_pool_t::free_list( const action_state_t* state )
+{
+  return free_lists[ typeid( *state ) ];
+}
+
+action_state_pool_t::~action_state_pool_t()
+{
+  for ( auto& entry : free_lists )
+  {
+    while ( action_state_t* s = entry.second )
+    {
+      entry.second = s->next;
+      delete s;
+    }
+  }
 }
 
 // Initialize contains all variables that must be reset every time a new
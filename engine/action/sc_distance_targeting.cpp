@@ -46,12 +46,18 @@ bool action_t::execute_targeting( action_t* action ) const
 std::vector<player_t*> action_t::targets_in_range_list(
     std::vector<player_t*>& tl ) const
 {
+  if ( range > 0.0 )
+  {
+    sim->actor_grid.query( player->x_position, player->y_position, range, false );
+  }
+
   size_t i = tl.size();
   while ( i > 0 )
   {
     i--;
     player_t* target_ = tl[ i ];
-    if ( range > 0.0 && target_->get_player_distance( *player ) > range )
+    if ( range > 0.0 && ( !sim->actor_grid.candidate( target_ ) ||
+                          target_->get_player_distance( *player ) > range ) )
     {
       tl.erase( tl.begin() + i );
     }
@@ -68,6 +74,31 @@ std::vector<player_t*> action_t::targets_in_range_list(
 std::vector<player_t*> action_t::check_distance_targeting(
     std::vector<player_t*>& tl ) const
 {
+  // All targets are tested against the same location and distance, select the ones that can be
+  // close enough from the spatial index, so the rest can be discarded without a distance check.
+  bool indexed = true;
+  if ( radius > 0 && range > 0 )
+  {
+    if ( ground_aoe && parent_dot && parent_dot->is_ticking() )
+      sim->actor_grid.query( parent_dot->state->original_x,
+                             parent_dot->state->original_y, radius, true );
+    else if ( ground_aoe && execute_state )
+      sim->actor_grid.query( execute_state->original_x,
+                             execute_state->original_y, radius, true );
+    else
+      sim->actor_grid.query( target->x_position, target->y_position, radius,
+                             false );
+  }
+  else if ( radius > 0 || range > 0 )
+  {
+    sim->actor_grid.query( player->x_position, player->y_position,
+                           radius > 0 ? radius : range, true );
+  }
+  else
+  {
+    indexed = false;
+  }
+
   size_t i = tl.size();
   while ( i > 0 )
   {
@@ -89,6 +120,10 @@ std::vector<player_t*> action_t::check_distance_targeting(
       {
         tl.erase( tl.begin() + i );
       }
+      else if ( indexed && !sim->actor_grid.candidate( t ) )
+      {
+        tl.erase( tl.begin() + i );
+      }
       else if ( radius > 0 && range > 0 )
       {  // Abilities with range/radius radiate from the target.
         if ( ground_aoe && parent_dot && parent_dot->is_ticking() )
@@ -165,7 +200,7 @@ player_t* action_t::select_target_if_target()
     return target;
   }
 
-  std::vector<player_t*> master_list;
+  std::vector<player_t*>& master_list = target_if_list;
   if ( sim->distance_targeting_enabled )
   {
     if ( !target_cache.is_valid )
@@ -298,6 +333,111 @@ void player_t::init_distance_targeting()
   x_position = -1 * base.distance;
 }
 
+// Actor grid ================================================================
+
+// actor_grid_t::actor_grid_t ==================================================
+
+actor_grid_t::actor_grid_t( sim_t& s, double cs )
+  : sim( s ),
+    cell_size( cs ),
+    is_valid( false ),
+    max_combat_reach( 0 ),
+    generation( 0 ),
+    query_id( 0 )
+{
+}
+
+// actor_grid_t::cell ==========================================================
+
+int actor_grid_t::cell( double coord ) const
+{
+  return static_cast<int>( std::floor( coord / cell_size ) );
+}
+
+// actor_grid_t::key ===========================================================
+
+uint64_t actor_grid_t::key( int cx, int cy )
+{
+  // Bias the signed cell coordinates, so keys of a column are ordered by y
+  return ( static_cast<uint64_t>( static_cast<uint32_t>( cx ) ^ 0x80000000u ) << 32 ) |
+         ( static_cast<uint32_t>( cy ) ^ 0x80000000u );
+}
+
+// actor_grid_t::rebuild =======================================================
+
+void actor_grid_t::rebuild()
+{
+  generation++;
+  cells.clear();
+  max_combat_reach = 0;
+
+  if ( indexed.size() < sim.actor_list.size() )
+  {
+    indexed.resize( sim.actor_list.size() );
+    selected.resize( sim.actor_list.size() );
+  }
+
+  for ( player_t* actor : sim.target_non_sleeping_list )
+  {
+    cells.push_back( std::make_pair( key( cell( actor->x_position ), cell( actor->y_position ) ), actor ) );
+    indexed[ actor->actor_index ] = generation;
+    max_combat_reach = std::max( max_combat_reach, actor->combat_reach );
+  }
+
+  std::sort( cells.begin(), cells.end(),
+             []( const std::pair<uint64_t, player_t*>& l, const std::pair<uint64_t, player_t*>& r ) {
+               return l.first < r.first;
+             } );
+
+  is_valid = true;
+}
+
+// actor_grid_t::query =========================================================
+
+void actor_grid_t::query( double x, double y, double distance, bool with_combat_reach )
+{
+  if ( !is_valid )
+    rebuild();
+
+  query_id++;
+
+  // Distances are compared with util::approx_sqrt(), leave some room for its error
+  double d = ( distance + ( with_combat_reach ? max_combat_reach : 0 ) ) * 1.01 + 0.01;
+  int cx0 = cell( x - d ), cx1 = cell( x + d );
+  int cy0 = cell( y - d ), cy1 = cell( y + d );
+
+  // Large areas relative to the number of actors are cheaper to scan directly
+  if ( static_cast<size_t>( cx1 - cx0 + 1 ) >= cells.size() )
+  {
+    for ( const auto& entry : cells )
+    {
+      const player_t* actor = entry.second;
+      if ( std::fabs( actor->x_position - x ) <= d && std::fabs( actor->y_position - y ) <= d )
+        selected[ actor->actor_index ] = query_id;
+    }
+    return;
+  }
+
+  for ( int cx = cx0; cx <= cx1; cx++ )
+  {
+    uint64_t last = key( cx, cy1 );
+    auto it = std::lower_bound( cells.begin(), cells.end(), key( cx, cy0 ),
+                                []( const std::pair<uint64_t, player_t*>& e, uint64_t k ) { return e.first < k; } );
+    for ( ; it != cells.end() && it->first <= last; ++it )
+      selected[ it->second->actor_index ] = query_id;
+  }
+}
+
+// actor_grid_t::candidate =====================================================
+
+bool actor_grid_t::candidate( const player_t* actor ) const
+{
+  if ( actor->actor_index >= indexed.size() || indexed[ actor->actor_index ] != generation )
+    return true;
+
+  return selected[ actor->actor_index ] == query_id;
+}
+
 // Generic helper functions ==================================================
 
 // Approximation of square root ==============================================
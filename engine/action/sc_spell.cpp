@@ -391,6 +391,11 @@ void heal_t::assess_damage( dmg_e heal_type,
                      s -> target -> name(), s -> result_total, s -> result_amount,
                      util::result_type_string( s -> result ) );
     }
+
+    if ( sim -> trace )
+    {
+      sim -> trace -> heal( s, -1, 0 );
+    }
   }
   else // HEAL_OVER_TIME
   {
@@ -403,6 +408,12 @@ void heal_t::assess_damage( dmg_e heal_type,
                      s -> target -> name(), s -> result_total, s -> result_amount,
                      util::result_type_string( s -> result ) );
     }
+
+    if ( sim -> trace )
+    {
+      dot_t* dot = get_dot( s -> target );
+      sim -> trace -> heal( s, dot -> current_tick, dot -> num_ticks );
+    }
   }
 
   // New callback system; proc spells on impact. 
@@ -413,7 +424,7 @@ void heal_t::assess_damage( dmg_e heal_type,
     proc_types pt = s -> proc_type();
     proc_types2 pt2 = s -> impact_proc_type2();
     if ( pt != PROC1_INVALID && pt2 != PROC2_INVALID )
-      action_callback_t::trigger( player -> callbacks.procs[ pt ][ pt2 ], this, s );
+      player -> callbacks.trigger( pt, pt2, this, s );
   }
 
   if ( player -> record_healing() )
@@ -838,6 +838,8 @@ void buff_t::decrement( int    stacks,
   {
     int old_stack = current_stack;
 
+    update_regen();
+
     if ( requires_invalidation ) invalidate_cache();
 
     if ( as<std::size_t>( current_stack ) < stack_uptime.size() )
@@ -937,26 +939,7 @@ void buff_t::start( int        stacks,
 
   start_count++;
 
-  if ( player && change_regen_rate )
-    player -> do_dynamic_regen();
-  else if ( change_regen_rate )
-  {
-    for ( size_t i = 0, end = sim -> player_non_sleeping_list.size(); i < end; i++ )
-    {
-      player_t* actor = sim -> player_non_sleeping_list[ i ];
-      if ( actor -> regen_type != REGEN_DYNAMIC || actor -> is_pet() )
-        continue;
-
-      for (auto & elem : invalidate_list)
-      {
-        if ( actor -> regen_caches[ elem ] )
-        {
-          actor -> do_dynamic_regen();
-          break;
-        }
-      }
-    }
-  }
+  update_regen();
 
   int before_stacks = stack();
 
@@ -1081,6 +1064,8 @@ void buff_t::bump( int stacks, double value )
 {
   if ( _max_stack == 0 ) return;
 
+  update_regen();
+
   current_value = value;
 
   if ( requires_invalidation ) invalidate_cache();
@@ -1245,26 +1230,7 @@ void buff_t::expire( timespan_t delay )
   assert( as<std::size_t>( current_stack ) < stack_uptime.size() );
   stack_uptime[ current_stack ].update( false, sim -> current_time() );
 
-  if ( player && change_regen_rate )
-    player -> do_dynamic_regen();
-  else if ( change_regen_rate )
-  {
-    for ( size_t i = 0, end = sim -> player_non_sleeping_list.size(); i < end; i++ )
-    {
-      player_t* actor = sim -> player_non_sleeping_list[ i ];
-      if ( actor -> regen_type != REGEN_DYNAMIC || actor -> is_pet() )
-        continue;
-
-      for (auto & elem : invalidate_list)
-      {
-        if ( actor -> regen_caches[ elem ] )
-        {
-          actor -> do_dynamic_regen();
-          break;
-        }
-      }
-    }
-  }
+  update_regen();
 
   int old_stack = current_stack;
 
@@ -1353,6 +1319,11 @@ void buff_t::aura_gain()
         sim -> out_log.printf( "Raid gains %s ( value=%.2f )", s.c_str(), current_value );
     }
   }
+
+  if ( sim -> trace && ( ! player || ! player -> is_sleeping() ) )
+  {
+    sim -> trace -> buff_gain( this );
+  }
 }
 
 // buff_t::aura_loss ========================================================
@@ -1368,6 +1339,11 @@ void buff_t::aura_loss()
   {
     if ( sim -> log ) sim -> out_log.printf( "Raid loses %s",  name_str.c_str() );
   }
+
+  if ( sim -> trace && ( ! player || ! player -> is_sleeping() ) )
+  {
+    sim -> trace -> buff_loss( this );
+  }
 }
 
 // buff_t::reset ============================================================
@@ -1705,6 +1681,38 @@ expr_t* buff_t::create_expression(  std::string buff_name,
   return nullptr;
 }
 
+// buff_t::update_regen =====================================================
+
+// Regenerate resources up to now at the current rate, before the buff changes the regen rate of
+// its player (or of all players, for an aura) by starting, expiring or changing its stacks or value
+void buff_t::update_regen()
+{
+  if ( ! change_regen_rate )
+    return;
+
+  if ( player )
+  {
+    player -> do_dynamic_regen();
+    return;
+  }
+
+  for ( size_t i = 0, end = sim -> player_non_sleeping_list.size(); i < end; i++ )
+  {
+    player_t* actor = sim -> player_non_sleeping_list[ i ];
+    if ( actor -> regen_type != REGEN_DYNAMIC || actor -> is_pet() )
+      continue;
+
+    for (auto & elem : invalidate_list)
+    {
+      if ( actor -> regen_caches[ elem ] )
+      {
+        actor -> do_dynamic_regen();
+        break;
+      }
+    }
+  }
+}
+
 #if defined(SC_USE_STAT_CACHE)
 
 // buff_t::invalidate_cache =================================================
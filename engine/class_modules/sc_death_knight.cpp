@@ -820,6 +820,7 @@ public:
   void      invalidate_cache( cache_e ) override;
   double resource_loss( resource_e resource_type, double amount, gain_t* g = nullptr, action_t* a = nullptr ) override;
   void      merge( player_t& other ) override;
+  bool      merges_module_data() const override { return true; }
   void      analyze( sim_t& sim ) override;
 
   double    runes_per_second() const;
@@ -847,7 +848,7 @@ public:
     death_knight_td_t*& td = target_data[ target ];
     if ( ! td )
     {
-      td = new death_knight_td_t( target, const_cast<death_knight_t*>(this) );
+      td = target_data.create( target, const_cast<death_knight_t*>(this) );
     }
     return td;
   }
@@ -5582,7 +5583,7 @@ struct antimagic_shell_t : public death_knight_spell_t
       if ( new_cd < timespan_t::from_seconds( 15.0 ) )
         new_cd = timespan_t::from_seconds( 15.0 );
 
-      cooldown -> duration = new_cd;
+      cooldown -> set_duration( new_cd );
     }
 
     death_knight_spell_t::execute();
@@ -1845,11 +1845,13 @@ struct fel_barrage_t : public demon_hunter_spell_t
   {
     /* Override persistent multiplier and just return the charge multiplier.
     This value will be used to modify the tick_state. */
+    cooldown -> update_charges();
     return ( double )cooldown -> current_charge / cooldown -> charges;
   }
 
   void update_ready( timespan_t cd_duration ) override
   {
+    cooldown -> update_charges();
     assert( cooldown -> current_charge > 0 );
 
     /* A bit of a dirty hack to consume all charges. Just consume all but one
@@ -3231,7 +3233,7 @@ struct blade_dance_base_t : public demon_hunter_attack_t
 
   virtual void execute() override
   {
-    cooldown -> duration = data().cooldown();
+    cooldown -> set_duration( data().cooldown() );
 
     demon_hunter_attack_t::execute();
 
@@ -7129,7 +7131,7 @@ demon_hunter_td_t* demon_hunter_t::get_target_data( player_t* target ) const
   auto& td = _target_data[ target ];
   if ( !td )
   {
-    td = new demon_hunter_td_t( target, const_cast<demon_hunter_t&>( *this ) );
+    td = _target_data.create( target, const_cast<demon_hunter_t&>( *this ) );
   }
   return td;
 }
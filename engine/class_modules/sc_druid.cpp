@@ -728,6 +728,7 @@ public:
     regen_type = REGEN_DYNAMIC;
     regen_caches[ CACHE_HASTE ] = true;
     regen_caches[ CACHE_ATTACK_HASTE ] = true;
+    regen_caches[ CACHE_SPELL_HASTE ] = true; // Moonkin Form mana regen
   }
 
   virtual           ~druid_t();
@@ -748,6 +749,7 @@ public:
   virtual void      arise() override;
   virtual void      reset() override;
   virtual void      merge( player_t& other ) override;
+  virtual bool      merges_module_data() const override { return true; }
   virtual timespan_t available() const override;
   virtual double    composite_armor_multiplier() const override;
   virtual double    composite_attack_power_multiplier() const override;
@@ -1176,6 +1178,7 @@ struct moonkin_form_t : public druid_buff_t< buff_t >
     base_t( p, buff_creator_t( &p, "moonkin_form", p.spec.moonkin_form )
             .add_invalidate( CACHE_PLAYER_DAMAGE_MULTIPLIER )
             .add_invalidate( CACHE_ARMOR )
+            .affects_regen( true ) // druid_t::mana_regen_per_second
             .chance( 1.0 ) )
   {}
 
@@ -2151,13 +2154,17 @@ public:
 
       if ( sim -> log )
       {
-        sim -> out_log.printf( "%s consumes %d %s for %s (0)",
+        sim -> out_log.printf( "%s consumes %.1f %s for %s (%.0f)",
           player -> name(),
-          consumed,
+          ( double ) consumed,
           util::resource_type_string( RESOURCE_COMBO_POINT ),
-          name() );
+          name(),
+          player -> resources.current[ RESOURCE_COMBO_POINT ] );
       }
 
+      if ( sim -> trace )
+        sim -> trace -> consume( this, RESOURCE_COMBO_POINT, consumed, player -> resources.current[ RESOURCE_COMBO_POINT ] );
+
       stats -> consume_resource( RESOURCE_COMBO_POINT, consumed );
 
       if ( p() -> spec.predatory_swiftness -> ok() )
@@ -7810,7 +7817,7 @@ druid_td_t* druid_t::get_target_data( player_t* target ) const
   druid_td_t*& td = target_data[ target ];
   if ( ! td )
   {
-    td = new druid_td_t( *target, const_cast<druid_t&>( *this ) );
+    td = target_data.create( *target, const_cast<druid_t&>( *this ) );
   }
   return td;
 }
@@ -510,7 +510,7 @@ public:
   virtual hunter_td_t* get_target_data( player_t* target ) const override
   {
     hunter_td_t*& td = target_data[target];
-    if ( !td ) td = new hunter_td_t( target, const_cast<hunter_t*>( this ) );
+    if ( !td ) td = target_data.create( target, const_cast<hunter_t*>( this ) );
     return td;
   }
 
@@ -1354,7 +1354,7 @@ public:
   {
     hunter_main_pet_td_t*& td = target_data[target];
     if ( !td )
-      td = new hunter_main_pet_td_t( target, const_cast<hunter_main_pet_t*>( this ) );
+      td = target_data.create( target, const_cast<hunter_main_pet_t*>( this ) );
     return td;
   }
 
@@ -4911,6 +4911,7 @@ struct snake_hunter_t: public hunter_spell_t
   {
     hunter_spell_t::execute();
 
+    p() -> cooldowns.mongoose_bite -> update_charges();
     while( p() -> cooldowns.mongoose_bite -> current_charge != 3 )
       p() -> cooldowns.mongoose_bite -> reset( true );
   }
@@ -5601,6 +5602,7 @@ void hunter_t::create_buffs()
 
   buffs.dire_beast = 
     buff_creator_t( this, 120694, "dire_beast" )
+      .affects_regen( true )
       .max_stack( 8 )
       .stack_behavior( BUFF_STACK_ASYNCHRONOUS )
       .period( timespan_t::zero() )
@@ -5680,6 +5682,7 @@ void hunter_t::create_buffs()
 
   buffs.steady_focus 
     = buff_creator_t( this, 193534, "steady_focus" )
+        .affects_regen( true ) // Also regenerates focus for the pet, see hunter_main_pet_t::regen
         .chance( talents.steady_focus -> ok() );
 
   buffs.t18_2p_rapid_fire = 
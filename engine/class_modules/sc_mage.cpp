@@ -607,7 +607,7 @@ public:
     mage_td_t*& td = target_data[ target ];
     if ( ! td )
     {
-      td = new mage_td_t( target, const_cast<mage_t*>(this) );
+      td = target_data.create( target, const_cast<mage_t*>(this) );
     }
     return td;
   }
@@ -835,7 +835,7 @@ struct water_elemental_pet_t : public mage_pet_t
   {
     water_elemental_pet_td_t*& td = target_data[ target ];
     if ( !td )
-      td = new water_elemental_pet_td_t(
+      td = target_data.create(
           target, const_cast<water_elemental_pet_t*>( this ) );
     return td;
   }
@@ -8054,7 +8054,8 @@ void mage_t::create_buffs()
 
   // Legendary
   buffs.cord_of_infinity   = buff_creator_t( this, "cord_of_infinity", find_spell( 209316 ) )
-                                             .default_value( find_spell( 209311 ) -> effectN( 1 ).percent() );
+                                             .default_value( find_spell( 209311 ) -> effectN( 1 ).percent() )
+                                             .affects_regen( true );
   buffs.magtheridons_might = buff_creator_t( this, "magtheridons_might", find_spell( 214404 ) );
   buffs.zannesu_journey    = buff_creator_t( this, "zannesu_journey", find_spell( 226852 ) );
   buffs.lady_vashjs_grasp  = new buffs::lady_vashjs_grasp_t( this );
@@ -607,6 +607,10 @@ public:
     pets::storm_earth_and_fire_pet_t* sef[ SEF_PET_MAX ];
   } pet;
 
+  // Reused by create_storm_earth_and_fire_target_list(), so (re)targeting the clones does not
+  // allocate a new list every time
+  mutable std::vector<player_t*> sef_target_list;
+
   // Options
   struct options_t
   {
@@ -736,7 +740,7 @@ public:
     monk_td_t*& td = target_data[target];
     if ( !td )
     {
-      td = new monk_td_t( target, const_cast<monk_t*>( this ) );
+      td = target_data.create( target, const_cast<monk_t*>( this ) );
     }
     return td;
   }
@@ -763,7 +767,7 @@ public:
   bool has_stagger();
 
   // Storm Earth and Fire targeting logic
-  std::vector<player_t*> create_storm_earth_and_fire_target_list() const;
+  std::vector<player_t*>& create_storm_earth_and_fire_target_list() const;
   void retarget_storm_earth_and_fire( pet_t* pet, std::vector<player_t*>& targets, size_t n_targets ) const;
   void retarget_storm_earth_and_fire_pets() const;
 };
@@ -1514,7 +1518,7 @@ public:
     sef_td_t*& td = target_data[ target ];
     if ( ! td )
     {
-      td = new sef_td_t( target, const_cast< storm_earth_and_fire_pet_t*>( this ) );
+      td = target_data.create( target, const_cast< storm_earth_and_fire_pet_t*>( this ) );
     }
     return td;
   }
@@ -1851,9 +1855,9 @@ public:
 
     /* Iterate through power entries, and find if there are resources linked to one of our stances
     */
-    for ( size_t i = 0; ab::data()._power && i < ab::data()._power -> size(); i++ )
+    for ( size_t i = 0; i < ab::data().power_count(); i++ )
     {
-      const spellpower_data_t* pd = ( *ab::data()._power )[i];
+      const spellpower_data_t* pd = &( ab::data().powerN( i + 1 ) );
       switch ( pd -> aura_id() )
       {
       case 137023:
@@ -3899,7 +3903,7 @@ struct touch_of_karma_t: public monk_melee_attack_t
     if ( new_cd < data_cooldown )
       new_cd = data_cooldown;
 
-    cooldown -> duration = new_cd;
+    cooldown -> set_duration( new_cd );
 
     monk_melee_attack_t::execute();
 
@@ -4155,7 +4159,7 @@ struct storm_earth_and_fire_t: public monk_spell_t
   // Normal summon that summons the pets, they seek out proper targeets
   void normal_summon()
   {
-    auto targets = p() -> create_storm_earth_and_fire_target_list();
+    auto& targets = p() -> create_storm_earth_and_fire_target_list();
     auto n_targets = targets.size();
 
     // Start targeting logic from "owner" always
@@ -4227,7 +4231,7 @@ struct sef_despawn_cb_t
       return;
     }
 
-    auto targets = monk -> create_storm_earth_and_fire_target_list();
+    auto& targets = monk -> create_storm_earth_and_fire_target_list();
     auto n_targets = targets.size();
 
     // If the active clone's target is sleeping, reset it's targeting, and jump it to a new target.
@@ -7192,10 +7196,11 @@ bool monk_t::has_stagger()
 
 // monk_t::retarget_storm_earth_and_fire ====================================
 
-std::vector<player_t*> monk_t::create_storm_earth_and_fire_target_list() const
+std::vector<player_t*>& monk_t::create_storm_earth_and_fire_target_list() const
 {
   // Make a copy of the non sleeping target list
-  auto l = sim -> target_non_sleeping_list.data();
+  auto& l = sef_target_list;
+  l = sim -> target_non_sleeping_list.data();
 
   // Sort the list by selecting non-cyclone striked targets first, followed by ascending order of
   // the debuff remaining duration
@@ -7315,7 +7320,7 @@ void monk_t::retarget_storm_earth_and_fire_pets() const
     return;
   }
 
-  auto targets = create_storm_earth_and_fire_target_list();
+  auto& targets = create_storm_earth_and_fire_target_list();
   auto n_targets = targets.size();
   retarget_storm_earth_and_fire( pet.sef[ SEF_EARTH ], targets, n_targets );
   retarget_storm_earth_and_fire( pet.sef[ SEF_FIRE  ], targets, n_targets );
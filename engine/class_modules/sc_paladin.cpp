@@ -489,7 +489,7 @@ public:
     paladin_td_t*& td = target_data[ target ];
     if ( ! td )
     {
-      td = new paladin_td_t( target, const_cast<paladin_t*>(this) );
+      td = target_data.create( target, const_cast<paladin_t*>(this) );
     }
     return td;
   }
@@ -2241,7 +2241,7 @@ struct holy_shock_t : public paladin_heal_t
       heal -> schedule_execute();
     }
 
-    cooldown -> duration = cd_duration;
+    cooldown -> set_duration( cd_duration );
 
     paladin_heal_t::execute();
   }
@@ -2593,6 +2593,7 @@ struct seraphim_t : public paladin_spell_t
 
     // duration depends on sotr charges, need to do some math
     timespan_t duration = timespan_t::zero();
+    p() -> cooldowns.shield_of_the_righteous -> update_charges();
     int available_charges = p() -> cooldowns.shield_of_the_righteous -> current_charge;
     int full_charges_used = 0;
     timespan_t remains = p() -> cooldowns.shield_of_the_righteous -> current_charge_remains();
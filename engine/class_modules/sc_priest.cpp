@@ -2235,6 +2235,7 @@ public:
     if ( priest.buffs.shadowy_insight->check() )
     {
       cd_duration            = timespan_t::zero();
+      cooldown->update_charges();
       cooldown->last_charged = sim->current_time();
 
       if ( sim->debug )
@@ -5656,7 +5657,7 @@ priest_td_t* priest_t::get_target_data( player_t* target ) const
   priest_td_t*& td = _target_data[ target ];
   if ( !td )
   {
-    td = new priest_td_t( target, const_cast<priest_t&>( *this ) );
+    td = _target_data.create( target, const_cast<priest_t&>( *this ) );
   }
   return td;
 }
@@ -672,7 +672,7 @@ struct rogue_t : public player_t
     rogue_td_t*& td = target_data[ target ];
     if ( ! td )
     {
-      td = new rogue_td_t( target, const_cast<rogue_t*>(this) );
+      td = target_data.create( target, const_cast<rogue_t*>(this) );
     }
     return td;
   }
@@ -5531,6 +5531,8 @@ void rogue_t::spend_combo_points( const action_state_t* state )
                    max_spend, util::resource_type_string( RESOURCE_COMBO_POINT ),
                    state -> action -> name(), resources.current[ RESOURCE_COMBO_POINT ] );
 
+  if ( sim -> trace )
+    sim -> trace -> consume( state -> action, RESOURCE_COMBO_POINT, max_spend, resources.current[ RESOURCE_COMBO_POINT ] );
 }
 
 bool rogue_t::trigger_t17_4pc_combat( const action_state_t* state )
@@ -7247,7 +7249,8 @@ void rogue_t::create_buffs()
   // buff_t( player, name, spellname, chance=-1, cd=-1, quiet=false, reverse=false, activated=true )
 
   buffs.blade_flurry        = buff_creator_t( this, "blade_flurry", spec.blade_flurry )
-    .cd( timespan_t::zero() );
+    .cd( timespan_t::zero() )
+    .affects_regen( true );
   buffs.adrenaline_rush     = haste_buff_creator_t( this, "adrenaline_rush", find_class_spell( "Adrenaline Rush" ) )
                               .cd( timespan_t::zero() )
                               .default_value( find_class_spell( "Adrenaline Rush" ) -> effectN( 2 ).percent() )
@@ -7380,7 +7383,8 @@ void rogue_t::create_buffs()
                        .default_value( find_spell( 193359 ) -> effectN( 1 ).base_value() );
   buffs.broadsides = buff_creator_t( this, "broadsides", find_spell( 193356 ) );
   buffs.buried_treasure = buff_creator_t( this, "buried_treasure", find_spell( 199600 ) )
-                       .default_value( find_spell( 199600 ) -> effectN( 1 ).percent() );
+                       .default_value( find_spell( 199600 ) -> effectN( 1 ).percent() )
+                       .affects_regen( true );
   // Note, since I (navv) am a slacker, this needs to be constructed after the secondary buffs.
   buffs.roll_the_bones = new buffs::roll_the_bones_t( this, rtb_creator );
 
@@ -628,6 +628,7 @@ public:
   void      arise() override;
   void      reset() override;
   void      merge( player_t& other ) override;
+  bool      merges_module_data() const override { return true; }
 
   void     datacollection_begin() override;
   void     datacollection_end() override;
@@ -640,7 +641,7 @@ public:
     shaman_td_t*& td = target_data[ target ];
     if ( ! td )
     {
-      td = new shaman_td_t( target, const_cast<shaman_t*>(this) );
+      td = target_data.create( target, const_cast<shaman_t*>(this) );
     }
     return td;
   }
@@ -1083,6 +1084,7 @@ public:
 
   virtual void update_ready( timespan_t cd ) override
   {
+    ab::cooldown -> update_charges();
     if ( cd_wasted_exec &&
          ( cd > timespan_t::zero() || ( cd <= timespan_t::zero() && ab::cooldown -> duration > timespan_t::zero() ) ) &&
          ab::cooldown -> current_charge == ab::cooldown -> charges &&
@@ -4102,6 +4104,7 @@ struct lava_burst_t : public shaman_spell_t
     if ( p() -> lava_surge_during_lvb )
     {
       d = timespan_t::zero();
+      cooldown -> update_charges();
       cooldown -> last_charged = sim -> current_time();
     }
 
@@ -5469,7 +5472,7 @@ void ascendance_buff_t::ascendance( attack_t* mh, attack_t* oh, timespan_t lvb_c
   {
     if ( lava_burst )
     {
-      lava_burst -> cooldown -> duration = lvb_cooldown;
+      lava_burst -> cooldown -> set_duration( lvb_cooldown );
       lava_burst -> cooldown -> reset( false );
     }
   }
@@ -5488,6 +5491,7 @@ inline bool ascendance_buff_t::trigger( int stacks, double value, double chance,
   // Don't record CD waste during Ascendance.
   if ( lava_burst )
   {
+    lava_burst -> cooldown -> update_charges();
     lava_burst -> cooldown -> last_charged = timespan_t::zero();
   }
 
@@ -5506,6 +5510,7 @@ inline void ascendance_buff_t::expire_override( int expiration_stacks, timespan_
   // Burst is guaranteed to be very much ready when Ascendance ends.
   if ( lava_burst )
   {
+    lava_burst -> cooldown -> update_charges();
     lava_burst -> cooldown -> last_charged = sim -> current_time();
   }
   buff_t::expire_override( expiration_stacks, remaining_duration );
@@ -107,21 +107,21 @@ public:
   {
     pet_t* active;
     pet_t* last;
-    static const int WILD_IMP_LIMIT = 40;
-    static const int T18_PET_LIMIT = 45;
+    static const size_t WILD_IMP_LIMIT = 40;
+    static const size_t T18_PET_LIMIT = 45;
     static const int DREADSTALKER_LIMIT = 4;
     static const int DIMENSIONAL_RIFT_LIMIT = 6;
     static const int INFERNAL_LIMIT = 1;
     static const int DOOMGUARD_LIMIT = 1;
     static const int LORD_OF_FLAMES_INFERNAL_LIMIT = 3;
     static const int DARKGLARE_LIMIT = 1;
-    std::array<pets::wild_imp_pet_t*, WILD_IMP_LIMIT> wild_imps;
-    std::array<pets::t18_illidari_satyr_t*, T18_PET_LIMIT> t18_illidari_satyr;
-    std::array<pets::t18_prince_malchezaar_t*, T18_PET_LIMIT> t18_prince_malchezaar;
-    std::array<pets::t18_vicious_hellhound_t*, T18_PET_LIMIT> t18_vicious_hellhound;
-    std::array<pets::shadowy_tear::shadowy_tear_t*, DIMENSIONAL_RIFT_LIMIT> shadowy_tear;
-    std::array<pets::chaos_tear_t*, DIMENSIONAL_RIFT_LIMIT> chaos_tear;
-    std::array<pets::chaos_portal::chaos_portal_t*, DIMENSIONAL_RIFT_LIMIT> chaos_portal;
+    pet_pool_t wild_imps;
+    pet_pool_t t18_illidari_satyr;
+    pet_pool_t t18_prince_malchezaar;
+    pet_pool_t t18_vicious_hellhound;
+    pet_pool_t shadowy_tear;
+    pet_pool_t chaos_tear;
+    pet_pool_t chaos_portal;
     std::array<pets::dreadstalker_t*, DREADSTALKER_LIMIT> dreadstalkers;
     std::array<pets::infernal_t*, INFERNAL_LIMIT> infernal;
     std::array<pets::doomguard_t*, DOOMGUARD_LIMIT> doomguard;
@@ -499,7 +499,7 @@ public:
     warlock_td_t*& td = target_data[target];
     if ( ! td )
     {
-      td = new warlock_td_t( target, const_cast<warlock_t&>( *this ) );
+      td = target_data.create( target, const_cast<warlock_t&>( *this ) );
     }
     return td;
   }
@@ -549,7 +549,7 @@ static void destruction_trinket( special_effect_t& effect )
 
 void parse_spell_coefficient( action_t& a )
 {
-  for ( size_t i = 1; i <= a.data()._effects -> size(); i++ )
+  for ( size_t i = 1; i <= a.data().effect_count(); i++ )
   {
     if ( a.data().effectN( i ).type() == E_SCHOOL_DAMAGE )
       a.spell_power_mod.direct = a.data().effectN( i ).sp_coeff();
@@ -1463,8 +1463,8 @@ struct t18_illidari_satyr_t: public warlock_pet_t
     warlock_pet_t::init_base_stats();
     base_energy_regen_per_second = 0;
     melee_attack = new actions::warlock_pet_melee_t( this );
-    if ( o() -> warlock_pet_list.t18_illidari_satyr[0] )
-      melee_attack -> stats = o() -> warlock_pet_list.t18_illidari_satyr[0] -> get_stats( "melee" );
+    if ( o() -> warlock_pet_list.t18_illidari_satyr.primary() )
+      melee_attack -> stats = o() -> warlock_pet_list.t18_illidari_satyr.primary() -> get_stats( "melee" );
   }
 };
 
@@ -1483,8 +1483,8 @@ struct t18_prince_malchezaar_t: public warlock_pet_t
     warlock_pet_t::init_base_stats();
     base_energy_regen_per_second = 0;
     melee_attack = new actions::warlock_pet_melee_t( this );
-    if ( o() -> warlock_pet_list.t18_prince_malchezaar[0] )
-      melee_attack -> stats = o() -> warlock_pet_list.t18_prince_malchezaar[0] -> get_stats( "melee" );
+    if ( o() -> warlock_pet_list.t18_prince_malchezaar.primary() )
+      melee_attack -> stats = o() -> warlock_pet_list.t18_prince_malchezaar.primary() -> get_stats( "melee" );
   }
 
   double composite_player_multiplier( school_e school ) const override
@@ -1513,18 +1513,15 @@ struct t18_vicious_hellhound_t: public warlock_pet_t
     main_hand_weapon.swing_time = timespan_t::from_seconds( 1.0 );
     melee_attack = new actions::warlock_pet_melee_t( this );
     melee_attack -> base_execute_time = timespan_t::from_seconds( 1.0 );
-    if ( o() -> warlock_pet_list.t18_vicious_hellhound[0] )
-      melee_attack -> stats = o() -> warlock_pet_list.t18_vicious_hellhound[0] -> get_stats( "melee" );
+    if ( o() -> warlock_pet_list.t18_vicious_hellhound.primary() )
+      melee_attack -> stats = o() -> warlock_pet_list.t18_vicious_hellhound.primary() -> get_stats( "melee" );
   }
 };
 
 struct chaos_tear_t : public warlock_pet_t
 {
-  stats_t** chaos_bolt_stats;
-  stats_t* regular_stats;
-
   chaos_tear_t( sim_t* sim, warlock_t* owner ) :
-    warlock_pet_t( sim, owner, "chaos_tear", PET_NONE, true ), chaos_bolt_stats( nullptr ), regular_stats(nullptr)
+    warlock_pet_t( sim, owner, "chaos_tear", PET_NONE, true )
   {
     action_list_str = "chaos_bolt";
     regen_type = REGEN_DISABLED;
@@ -1542,16 +1539,7 @@ struct chaos_tear_t : public warlock_pet_t
     if ( name == "chaos_bolt" )
     {
       action_t* a = new actions::rift_chaos_bolt_t( this );
-      chaos_bolt_stats = &( a -> stats );
-      if ( this == o() -> warlock_pet_list.chaos_tear[0] || sim -> report_pets_separately )
-      {
-        regular_stats = a -> stats;
-      }
-      else
-      {
-        regular_stats = o() -> warlock_pet_list.chaos_tear[0] -> get_stats( "chaos_bolt" );
-        *chaos_bolt_stats = regular_stats;
-      }
+      a -> stats = o() -> warlock_pet_list.chaos_tear.shared_stats( this, a -> stats );
       return a;
     }
 
@@ -1573,12 +1561,10 @@ namespace shadowy_tear {
 
   struct shadowy_tear_t : public warlock_pet_t
   {
-    stats_t** shadow_bolt_stats;
-    stats_t* regular_stats;
     target_specific_t<shadowy_tear_td_t> target_data;
 
     shadowy_tear_t( sim_t* sim, warlock_t* owner ) :
-      warlock_pet_t( sim, owner, "shadowy_tear", PET_NONE, true ), shadow_bolt_stats( nullptr ), regular_stats( nullptr )
+      warlock_pet_t( sim, owner, "shadowy_tear", PET_NONE, true )
     {
       action_list_str = "shadow_bolt";
       regen_type = REGEN_DISABLED;
@@ -1599,7 +1585,7 @@ namespace shadowy_tear {
     {
       shadowy_tear_td_t*& td = target_data[target];
       if ( !td )
-        td = new shadowy_tear_td_t( target, const_cast< shadowy_tear_t* >( this ) );
+        td = target_data.create( target, const_cast< shadowy_tear_t* >( this ) );
       return td;
     }
 
@@ -1608,16 +1594,7 @@ namespace shadowy_tear {
       if ( name == "shadow_bolt" )
       {
         action_t* a = new actions::rift_shadow_bolt_t( this );
-        shadow_bolt_stats = &( a -> stats );
-        if ( this == o() -> warlock_pet_list.shadowy_tear[0] || sim -> report_pets_separately )
-        {
-          regular_stats = a -> stats;
-        }
-        else
-        {
-          regular_stats = o() -> warlock_pet_list.shadowy_tear[0] -> get_stats( "shadow_bolt" );
-          *shadow_bolt_stats = regular_stats;
-        }
+        a -> stats = o() -> warlock_pet_list.shadowy_tear.shared_stats( this, a -> stats );
         return a;
       }
 
@@ -1647,11 +1624,9 @@ namespace chaos_portal {
   struct chaos_portal_t : public warlock_pet_t
   {
     target_specific_t<chaos_portal_td_t> target_data;
-    stats_t** chaos_barrage_stats;
-    stats_t* regular_stats;
 
     chaos_portal_t( sim_t* sim, warlock_t* owner ) :
-      warlock_pet_t( sim, owner, "chaos_portal", PET_NONE, true ), chaos_barrage_stats( nullptr ), regular_stats( nullptr )
+      warlock_pet_t( sim, owner, "chaos_portal", PET_NONE, true )
     {
       action_list_str = "chaos_barrage";
       regen_type = REGEN_DISABLED;
@@ -1672,7 +1647,7 @@ namespace chaos_portal {
     {
       chaos_portal_td_t*& td = target_data[target];
       if ( !td )
-        td = new chaos_portal_td_t( target, const_cast< chaos_portal_t* >( this ) );
+        td = target_data.create( target, const_cast< chaos_portal_t* >( this ) );
       return td;
     }
 
@@ -1681,16 +1656,7 @@ namespace chaos_portal {
       if ( name == "chaos_barrage" )
       {
         action_t* a = new actions::chaos_barrage_t( this );
-        chaos_barrage_stats = &( a -> stats );
-        if ( this == o() -> warlock_pet_list.chaos_portal[0] || sim -> report_pets_separately )
-        {
-          regular_stats = a -> stats;
-        }
-        else
-        {
-          regular_stats = o() -> warlock_pet_list.chaos_portal[0] -> get_stats( "chaos_barrage" );
-          *chaos_barrage_stats = regular_stats;
-        }
+        a -> stats = o() -> warlock_pet_list.chaos_portal.shared_stats( this, a -> stats );
         return a;
       }
 
@@ -1910,14 +1876,7 @@ struct wild_imp_pet_t: public warlock_pet_t
     {
       firebolt = new actions::fel_firebolt_t( this );
       fel_firebolt_stats = &( firebolt -> stats );
-      if ( this == o() -> warlock_pet_list.wild_imps[ 0 ] || sim -> report_pets_separately )
-      {
-        regular_stats = firebolt -> stats;
-      }
-      else
-      {
-        regular_stats = o() -> warlock_pet_list.wild_imps[ 0 ] -> get_stats( "fel_firebolt" );
-      }
+      regular_stats = o() -> warlock_pet_list.wild_imps.shared_stats( this, firebolt -> stats );
       return firebolt;
     }
 
@@ -2449,19 +2408,14 @@ public:
 
   static void trigger_wild_imp( warlock_t* p, bool doge = false )
   {
-    for ( size_t i = 0; i < p -> warlock_pet_list.wild_imps.size(); i++ )
+    if ( pet_t* imp = p -> warlock_pet_list.wild_imps.acquire() )
     {
-      if ( p -> warlock_pet_list.wild_imps[i] -> is_sleeping() )
+      debug_cast<pets::wild_imp_pet_t*>( imp ) -> trigger(doge);
+      p -> procs.wild_imp -> occur();
+      if(p->legendary.wilfreds_sigil_of_superior_summoning_flag && !p->talents.grimoire_of_supremacy->ok())
       {
-
-        p -> warlock_pet_list.wild_imps[i] -> trigger(doge);
-        p -> procs.wild_imp -> occur();
-        if(p->legendary.wilfreds_sigil_of_superior_summoning_flag && !p->talents.grimoire_of_supremacy->ok())
-        {
-            p->cooldowns.doomguard->adjust(p->legendary.wilfreds_sigil_of_superior_summoning);
-            p->cooldowns.infernal->adjust(p->legendary.wilfreds_sigil_of_superior_summoning);
-        }
-        return;
+          p->cooldowns.doomguard->adjust(p->legendary.wilfreds_sigil_of_superior_summoning);
+          p->cooldowns.infernal->adjust(p->legendary.wilfreds_sigil_of_superior_summoning);
       }
     }
     //p -> sim -> errorf( "Playerd %s ran out of wild imps.\n", p -> name() );
@@ -3162,7 +3116,7 @@ struct hand_of_guldan_t: public warlock_spell_t
           p -> procs.fragment_wild_imp -> occur();
         }
       }
-      for ( pets::wild_imp_pet_t* wild_imp : p -> warlock_pet_list.wild_imps )
+      for ( pet_t* wild_imp : p -> warlock_pet_list.wild_imps )
       {
         if ( wild_imp -> is_sleeping() )
         {
@@ -3501,6 +3455,7 @@ struct incinerate_t: public warlock_spell_t
   {
     warlock_spell_t::execute();
     
+    p() -> cooldowns.dimensional_rift -> update_charges();
     if ( p() -> artifact.dimension_ripper.rank() && rng().roll( dimension_ripper ) && p() -> cooldowns.dimensional_rift -> current_charge < p() -> cooldowns.dimensional_rift -> charges )
     {
       p() -> cooldowns.dimensional_rift -> adjust( -p() -> cooldowns.dimensional_rift -> duration ); //decrease remaining time by the duration of one charge, i.e., add one charge
@@ -3684,39 +3639,18 @@ struct dimensional_rift_t : public warlock_spell_t
 
     if ( rift <= ( 1.0 / 3.0 ) )
     {
-      for ( size_t i = 0; i < p() ->warlock_pet_list.shadowy_tear.size(); i++ )
-      {
-        if ( p() -> warlock_pet_list.shadowy_tear[i] -> is_sleeping() )
-        {
-          p() -> warlock_pet_list.shadowy_tear[i] -> summon( shadowy_tear_duration );
-          p() -> procs.shadowy_tear -> occur();
-          break;
-        }
-      }
+      if ( p() -> warlock_pet_list.shadowy_tear.spawn( shadowy_tear_duration ) )
+        p() -> procs.shadowy_tear -> occur();
     }
     else if ( rift >= ( 2.0 / 3.0 ) )
     {
-      for ( size_t i = 0; i < p() -> warlock_pet_list.chaos_tear.size(); i++ )
-      {
-        if ( p() -> warlock_pet_list.chaos_tear[i] -> is_sleeping() )
-        {
-          p() -> warlock_pet_list.chaos_tear[i] -> summon( chaos_tear_duration );
-          p() -> procs.chaos_tear -> occur();
-          break;
-        }
-      }
+      if ( p() -> warlock_pet_list.chaos_tear.spawn( chaos_tear_duration ) )
+        p() -> procs.chaos_tear -> occur();
     }
     else
     {
-      for ( size_t i = 0; i < p() -> warlock_pet_list.chaos_portal.size(); i++ )
-      {
-        if ( p() -> warlock_pet_list.chaos_portal[i] -> is_sleeping() )
-        {
-          p() -> warlock_pet_list.chaos_portal[i] -> summon( chaos_tear_duration );
-          p() -> procs.chaos_portal -> occur();
-          break;
-        }
-      }
+      if ( p() -> warlock_pet_list.chaos_portal.spawn( chaos_tear_duration ) )
+        p() -> procs.chaos_portal -> occur();
     }
   }
 };
@@ -5485,28 +5419,18 @@ void warlock_t::create_pets()
 
   if ( artifact.dimensional_rift.rank() )
   {
-    for ( size_t i = 0; i < warlock_pet_list.shadowy_tear.size(); i++ )
-    {
-      warlock_pet_list.shadowy_tear[i] = new pets::shadowy_tear::shadowy_tear_t( sim, this );
-    }
-    for ( size_t i = 0; i < warlock_pet_list.chaos_tear.size(); i++ )
-    {
-      warlock_pet_list.chaos_tear[i] = new pets::chaos_tear_t( sim, this );
-    }
-    for ( size_t i = 0; i < warlock_pet_list.chaos_portal.size(); i++ )
-    {
-      warlock_pet_list.chaos_portal[i] = new pets::chaos_portal::chaos_portal_t( sim, this );
-    }
+    warlock_pet_list.shadowy_tear.create( pets_t::DIMENSIONAL_RIFT_LIMIT,
+      [ this ]() { return new pets::shadowy_tear::shadowy_tear_t( sim, this ); } );
+    warlock_pet_list.chaos_tear.create( pets_t::DIMENSIONAL_RIFT_LIMIT,
+      [ this ]() { return new pets::chaos_tear_t( sim, this ); } );
+    warlock_pet_list.chaos_portal.create( pets_t::DIMENSIONAL_RIFT_LIMIT,
+      [ this ]() { return new pets::chaos_portal::chaos_portal_t( sim, this ); } );
   }
 
   if ( specialization() == WARLOCK_DEMONOLOGY )
   {
-    for ( size_t i = 0; i < warlock_pet_list.wild_imps.size(); i++ )
-    {
-      warlock_pet_list.wild_imps[ i ] = new pets::wild_imp_pet_t( sim, this );
-      if ( i > 0 )
-        warlock_pet_list.wild_imps[ i ] -> quiet = 1;
-    }
+    warlock_pet_list.wild_imps.create( pets_t::WILD_IMP_LIMIT,
+      [ this ]() { return new pets::wild_imp_pet_t( sim, this ); } );
     for ( size_t i = 0; i < warlock_pet_list.dreadstalkers.size(); i++ )
     {
       warlock_pet_list.dreadstalkers[ i ] = new pets::dreadstalker_t( sim, this );
@@ -5517,18 +5441,13 @@ void warlock_t::create_pets()
     }    
     if ( sets.has_set_bonus( WARLOCK_DEMONOLOGY, T18, B4 ) )
     {
-      for ( size_t i = 0; i < warlock_pet_list.t18_illidari_satyr.size(); i++ )
-      {
-        warlock_pet_list.t18_illidari_satyr[i] = new pets::t18_illidari_satyr_t( sim, this );
-      }
-      for ( size_t i = 0; i < warlock_pet_list.t18_prince_malchezaar.size(); i++ )
-      {
-        warlock_pet_list.t18_prince_malchezaar[i] = new pets::t18_prince_malchezaar_t( sim, this );
-      }
-      for ( size_t i = 0; i < warlock_pet_list.t18_vicious_hellhound.size(); i++ )
-      {
-        warlock_pet_list.t18_vicious_hellhound[i] = new pets::t18_vicious_hellhound_t( sim, this );
-      }
+      // T18 pets are all reported, as before the pools
+      warlock_pet_list.t18_illidari_satyr.create( pets_t::T18_PET_LIMIT,
+        [ this ]() { return new pets::t18_illidari_satyr_t( sim, this ); }, false );
+      warlock_pet_list.t18_prince_malchezaar.create( pets_t::T18_PET_LIMIT,
+        [ this ]() { return new pets::t18_prince_malchezaar_t( sim, this ); }, false );
+      warlock_pet_list.t18_vicious_hellhound.create( pets_t::T18_PET_LIMIT,
+        [ this ]() { return new pets::t18_vicious_hellhound_t( sim, this ); }, false );
     }
   }
 
@@ -5767,27 +5686,13 @@ struct t18_4pc_driver_t : public buff_t        //kept to force imps to proc
     double pet = rng().range( 0.0, 1.0 );
     if ( pet <= 0.6 ) // 60% chance to spawn hellhound
     {
-      for ( size_t i = 0; i < p -> warlock_pet_list.t18_vicious_hellhound.size(); i++ )
-      {
-        if ( p -> warlock_pet_list.t18_vicious_hellhound[i] -> is_sleeping() )
-        {
-          p -> warlock_pet_list.t18_vicious_hellhound[i] -> summon( vicious_hellhound_duration );
-          p -> procs.t18_vicious_hellhound -> occur();
-          break;
-        }
-      }
+      if ( p -> warlock_pet_list.t18_vicious_hellhound.spawn( vicious_hellhound_duration ) )
+        p -> procs.t18_vicious_hellhound -> occur();
     }
     else // 40% chance to spawn illidari
     {
-      for ( size_t i = 0; i < p -> warlock_pet_list.t18_illidari_satyr.size(); i++ )
-      {
-        if ( p -> warlock_pet_list.t18_illidari_satyr[i] -> is_sleeping() )
-        {
-          p -> warlock_pet_list.t18_illidari_satyr[i] -> summon( illidari_satyr_duration );
-          p -> procs.t18_illidari_satyr -> occur();
-          break;
-        }
-      }
+      if ( p -> warlock_pet_list.t18_illidari_satyr.spawn( illidari_satyr_duration ) )
+        p -> procs.t18_illidari_satyr -> occur();
     }
   }
 };
@@ -6323,13 +6228,7 @@ expr_t* warlock_t::create_expression( action_t* a, const std::string& name_str )
           expr_t( "wild_imp_count" ), player( p ) { }
         virtual double evaluate() override
         {
-            double t = 0;
-            for(auto& pet : player.warlock_pet_list.wild_imps)
-            {
-                if(!pet->is_sleeping())
-                    t++;
-            }
-            return t;
+            return static_cast<double>( player.warlock_pet_list.wild_imps.n_active() );
         }
 
     };
@@ -6468,8 +6367,9 @@ expr_t* warlock_t::create_expression( action_t* a, const std::string& name_str )
           virtual double evaluate() override
           {
               double t = 0;
-              for(auto& pet : player.warlock_pet_list.wild_imps)
+              for(pet_t* imp : player.warlock_pet_list.wild_imps)
               {
+                  auto pet = debug_cast<pets::wild_imp_pet_t*>( imp );
                   if(!pet->is_sleeping() & !pet->buffs.demonic_empowerment->up())
                       t++;
               }
@@ -6610,8 +6510,9 @@ expr_t* warlock_t::create_expression( action_t* a, const std::string& name_str )
           virtual double evaluate() override
           {
               double t = 150000;
-              for(auto& pet : player.warlock_pet_list.wild_imps)
+              for(pet_t* imp : player.warlock_pet_list.wild_imps)
               {
+                  auto pet = debug_cast<pets::wild_imp_pet_t*>( imp );
                   if(!pet->is_sleeping() & !pet->buffs.demonic_empowerment->up())
                   {
                     if(pet->buffs.demonic_empowerment->buff_duration.total_seconds() < t)
@@ -520,6 +520,7 @@ public:
   void       assess_damage( school_e, dmg_e, action_state_t* s ) override;
   void       copy_from( player_t* source ) override;
   void      merge( player_t& other ) override;
+  bool      merges_module_data() const override { return true; }
 
   void     datacollection_begin() override;
   void     datacollection_end() override;
@@ -532,7 +533,7 @@ public:
 
     if ( !td )
     {
-      td = new warrior_td_t( target, const_cast<warrior_t&>( *this ) );
+      td = target_data.create( target, const_cast<warrior_t&>( *this ) );
     }
     return td;
   }
@@ -702,6 +703,7 @@ public:
 
   virtual void update_ready( timespan_t cd ) override
   {
+    ab::cooldown -> update_charges();
     if ( cd_wasted_exec &&
       ( cd > timespan_t::zero() || ( cd <= timespan_t::zero() && ab::cooldown -> duration > timespan_t::zero() ) ) &&
          ab::cooldown -> current_charge == ab::cooldown -> charges &&
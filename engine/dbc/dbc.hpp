@@ -12,6 +12,7 @@
 #include <string>
 #include <functional>
 #include <unordered_map>
+#include <vector>
 #include <iostream>
 
 #include "data_definitions.hh"
@@ -27,6 +28,9 @@
 class dbc_t;
 struct player_t;
 struct item_t;
+struct spell_data_t;
+struct spelleffect_data_t;
+struct spellpower_data_t;
 
 
 const unsigned NUM_SPELL_FLAGS = 12;
@@ -64,6 +68,22 @@ enum : uint64_t
 void init();
 void init_item_data();
 void de_init();
+// Runtime linking of live or PTR client data, performed on first access to the data
+void link_data( bool ptr );
+bool data_linked( bool ptr );
+
+// Runtime links of a spell in the client data, created on first use of the spell
+struct spell_link_t
+{
+  std::vector<const spelleffect_data_t*> effects;
+  std::vector<const spellpower_data_t*>  power;
+  std::vector<spell_data_t*>             drivers; // Spells with an effect triggering the spell
+};
+
+// Links of a spell in the client data, or nullptr if the spell was created at runtime
+const spell_link_t* spell_link( const spell_data_t* spell );
+// Spell (or triggered spell) of an effect in the client data
+spell_data_t* effect_spell( const spelleffect_data_t* effect, unsigned spell_id );
 
 // Utily functions
 uint32_t get_school_mask( school_e s );
@@ -107,6 +127,32 @@ std::string bonus_ids_str( dbc_t& );
 
 // Filtered data access
 const item_data_t* find_consumable( item_subclass_consumable type, bool ptr, const std::function<bool(const item_data_t*)>& finder );
+
+// Binary, memory-mappable client data container. If loaded, the tables in the file are used
+// instead of the ones compiled into the binary. Implemented in sc_data_file.cpp.
+namespace data_file
+{
+  struct item_table_t
+  {
+    item_data_t*    items;
+    std::size_t     n_items;
+    unsigned        build_level;
+    // Pre-computed potion, flask, and food indices into items
+    const uint32_t* consumable_index[ 3 ];
+    std::size_t     n_consumables[ 3 ];
+
+    item_table_t() : items( nullptr ), n_items( 0 ), build_level( 0 ),
+      consumable_index(), n_consumables()
+    { }
+  };
+
+  bool load( const std::string& file_name, std::string& error );
+  void unload();
+  bool loaded();
+  bool relocated();
+  bool write( const std::string& file_name, std::string& error );
+  const item_table_t* items( bool ptr );
+}
 }
 
 namespace hotfix
@@ -265,7 +311,7 @@ namespace hotfix
 
     virtual ~hotfix_entry_t() { }
 
-    virtual void apply() { }
+    virtual void apply( bool /* ptr */ ) { }
     virtual std::string to_str() const;
   };
 
@@ -290,15 +336,15 @@ namespace hotfix
       orig_value_( -std::numeric_limits<double>::max() ), dbc_value_( 0 ), hotfix_value_( 0 )
     { }
 
-    virtual void apply() override
+    virtual void apply( bool ptr ) override
     {
-      if ( flags_ & HOTFIX_FLAG_LIVE )
+      if ( ! ptr && ( flags_ & HOTFIX_FLAG_LIVE ) )
       {
         apply_hotfix( false );
       }
 
 #if SC_USE_PTR
-      if ( flags_ & HOTFIX_FLAG_PTR )
+      if ( ptr && ( flags_ & HOTFIX_FLAG_PTR ) )
       {
         apply_hotfix( true );
       }
@@ -350,6 +396,7 @@ namespace hotfix
   effect_hotfix_entry_t& register_effect( const std::string&, const std::string&, const std::string&, unsigned, unsigned = hotfix::HOTFIX_FLAG_DEFAULT );
 
   void apply();
+  void apply_deferred( bool ptr );
   std::string to_str( bool ptr );
 
   void add_hotfix_spell( spell_data_t* spell, bool ptr = false );
@@ -506,7 +553,6 @@ public:
   static spellpower_data_t* nil();
   static spellpower_data_t* find( unsigned, bool ptr = false );
   static spellpower_data_t* list( bool ptr = false );
-  static void               link( bool ptr = false );
 };
 
 class spellpower_data_nil_t : public spellpower_data_t
@@ -724,7 +770,6 @@ public:
   static spelleffect_data_t* nil();
   static spelleffect_data_t* find( unsigned, bool ptr = false );
   static spelleffect_data_t* list( bool ptr = false );
-  static void                link( bool ptr = false );
 private:
   double scaled_average( double budget, unsigned level ) const;
   double scaled_delta( double budget ) const;
@@ -741,9 +786,7 @@ private:
 struct spell_data_t
 {
 private:
-  friend void dbc::init();
   friend void dbc::de_init();
-  static void link( bool ptr );
 public:
   const char* _name;               // 1 Spell name from Spell.dbc stringblock (enGB)
   unsigned    _id;                 // 2 Spell ID in dbc
@@ -810,9 +853,10 @@ public:
   // SpellIcon.dbc
   const char* _rank_str;           // 44
 
-  // Pointers for runtime linking
+  // Pointers for runtime linking. Spells in the client data are linked on first use instead (see
+  // dbc::spell_link()), these are only set for spells created at runtime.
   std::vector<const spelleffect_data_t*>* _effects;
-  std::vector<const spellpower_data_t*>*  _power;
+  const std::vector<const spellpower_data_t*>* _power;
   std::vector<spell_data_t*>* _driver; // The triggered spell's driver(s)
   const hotfix::client_hotfix_entry_t* _hotfix_entry; // First hotfix entry in the hotfix table, if available
 
@@ -916,12 +960,37 @@ public:
   unsigned power_id() const
   { return _power_id; }
 
+  // Runtime links of the spell, or nullptr if not linked
+  const std::vector<const spelleffect_data_t*>* effect_list() const
+  {
+    if ( _effects )
+      return _effects;
+    const dbc::spell_link_t* link = dbc::spell_link( this );
+    return link ? &( link -> effects ) : nullptr;
+  }
+
+  const std::vector<const spellpower_data_t*>* power_list() const
+  {
+    if ( _power )
+      return _power;
+    const dbc::spell_link_t* link = dbc::spell_link( this );
+    return link ? &( link -> power ) : nullptr;
+  }
+
+  const std::vector<spell_data_t*>* driver_list() const
+  {
+    if ( _driver )
+      return _driver;
+    const dbc::spell_link_t* link = dbc::spell_link( this );
+    return link ? &( link -> drivers ) : nullptr;
+  }
+
   // Helper functions
   size_t effect_count() const
-  { assert( _effects ); return _effects -> size(); }
+  { assert( effect_list() ); return effect_list() -> size(); }
 
   size_t power_count() const
-  { return _power ? _power -> size() : 0; }
+  { auto power = power_list(); return power ? power -> size() : 0; }
 
   bool found() const
   { return ( this != not_found() ); }
@@ -947,24 +1016,26 @@ public:
   // Composite functions
   const spelleffect_data_t& effectN( size_t idx ) const
   {
-    assert( _effects );
     assert( idx > 0 && "effect index must not be zero or less" );
 
     if ( this == spell_data_t::nil() || this == spell_data_t::not_found() )
       return *spelleffect_data_t::nil();
 
-    assert( idx <= _effects -> size() && "effect index out of bound!" );
+    auto effects = effect_list();
+    assert( effects );
+    assert( idx <= effects -> size() && "effect index out of bound!" );
 
-    return *( ( *_effects )[ idx - 1 ] );
+    return *( ( *effects )[ idx - 1 ] );
   }
 
   const spellpower_data_t& powerN( size_t idx ) const
   {
-    if ( _power )
+    auto power = power_list();
+    if ( power && ! power -> empty() )
     {
-      assert( idx > 0 && _power && idx <= _power -> size() );
+      assert( idx > 0 && idx <= power -> size() );
 
-      return *_power -> at( idx - 1 );
+      return *power -> at( idx - 1 );
     }
 
     return *spellpower_data_t::nil();
@@ -973,12 +1044,12 @@ public:
   const spellpower_data_t& powerN( power_e pt ) const
   {
     assert( pt >= POWER_HEALTH && pt < POWER_MAX );
-    if ( _power )
+    if ( auto power = power_list() )
     {
-      for ( size_t i = 0; i < _power -> size(); i++ )
+      for ( size_t i = 0; i < power -> size(); i++ )
       {
-        if ( _power -> at( i ) -> _power_e == pt )
-          return *_power -> at( i );
+        if ( power -> at( i ) -> _power_e == pt )
+          return *power -> at( i );
       }
     }
 
@@ -1037,12 +1108,12 @@ public:
 
   double cost( power_e pt ) const
   {
-    if ( _power )
+    if ( auto power = power_list() )
     {
-      for ( size_t i = 0; i < _power -> size(); i++ )
+      for ( size_t i = 0; i < power -> size(); i++ )
       {
-        if ( ( *_power )[ i ] -> _power_e == pt )
-          return ( *_power )[ i ] -> cost();
+        if ( ( *power )[ i ] -> _power_e == pt )
+          return ( *power )[ i ] -> cost();
       }
     }
 
@@ -1051,9 +1122,10 @@ public:
 
   uint32_t effect_id( uint32_t effect_num ) const
   {
-    assert( _effects );
-    assert( effect_num >= 1 && effect_num <= _effects -> size() );
-    return ( *_effects )[ effect_num - 1 ] -> id();
+    auto effects = effect_list();
+    assert( effects );
+    assert( effect_num >= 1 && effect_num <= effects -> size() );
+    return ( *effects )[ effect_num - 1 ] -> id();
   }
 
   bool flags( spell_attribute_e f ) const
@@ -1116,10 +1188,13 @@ public:
   bool affected_by( const spelleffect_data_t& ) const;
 
   spell_data_t* driver( size_t idx = 0 ) const
-  { return _driver ? _driver -> at( idx ) : spell_data_t::nil(); }
+  {
+    auto drivers = driver_list();
+    return drivers && ! drivers -> empty() ? drivers -> at( idx ) : spell_data_t::nil();
+  }
 
   size_t n_drivers() const
-  { return _driver ? _driver -> size() : 0; }
+  { auto drivers = driver_list(); return drivers ? drivers -> size() : 0; }
 
   // static functions
   static spell_data_t* nil();
@@ -1191,12 +1266,12 @@ inline spell_data_t* spell_data_t::not_found()
 
 inline spell_data_t* spelleffect_data_t::spell() const
 {
-  return _spell ? _spell : spell_data_t::not_found();
+  return _spell ? _spell : dbc::effect_spell( this, _spell_id );
 }
 
 inline spell_data_t* spelleffect_data_t::trigger() const
 {
-  return _trigger_spell ? _trigger_spell : spell_data_t::not_found();
+  return _trigger_spell ? _trigger_spell : dbc::effect_spell( this, _trigger_spell_id );
 }
 
 // ==========================================================================
@@ -1655,6 +1730,31 @@ public:
     populate( idx[ maybe_ptr( ptr ) ], list );
   }
 
+  // Position of the data in the list, or -1 if the data is not part of the list
+  std::ptrdiff_t position( bool ptr, const T* p ) const
+  {
+    const index_t& i = idx[ maybe_ptr( ptr ) ];
+    return p >= i.first && p < i.second ? p - i.first : -1;
+  }
+
+  // First entry of the list
+  T* begin( bool ptr ) const
+  { return idx[ maybe_ptr( ptr ) ].first; }
+
+  // Number of entries in the list
+  std::size_t size( bool ptr ) const
+  { return idx[ maybe_ptr( ptr ) ].second - idx[ maybe_ptr( ptr ) ].first; }
+
+  // Initialize index from a list of known size, already validated to be sorted by id (see
+  // validate() in sc_data_file.cpp)
+  void init( T* list, std::size_t n, bool ptr )
+  {
+    assert( ! initialized( maybe_ptr( ptr ) ) );
+    assert( std::is_sorted( list, list + n, []( const T& l, const T& r ) { return l.id < r.id; } ) );
+    idx[ maybe_ptr( ptr ) ].first = list;
+    idx[ maybe_ptr( ptr ) ].second = list + n;
+  }
+
   // Initialize index under the assumption that 'T::list( bool ptr )' returns a list of data
   void init()
   {
@@ -1713,6 +1813,16 @@ public:
     }
   }
 
+  // Initialize index from a pre-computed list of indices into list
+  void init( T* list, const uint32_t* indices, std::size_t n, bool ptr )
+  {
+    __filtered_index[ maybe_ptr( ptr ) ].reserve( n );
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+      __filtered_index[ maybe_ptr( ptr ) ].push_back( list + indices[ i ] );
+    }
+  }
+
   template<typename UnaryPredicate>
   const T* get( bool ptr, UnaryPredicate f ) const
   {
@@ -4,6 +4,7 @@
 // ==========================================================================
 
 #include "simulationcraft.hpp"
+#include <thread>
 
 #include "data_definitions.hh"
 #include "generated/sc_spec_list.inc"
@@ -85,6 +86,150 @@ ordered_dbc_index_t<artifact_power_rank_t> artifact_power_rank_data_index;
 std::vector< std::vector< const spell_data_t* > > class_family_index;
 std::vector< std::vector< const spell_data_t* > > ptr_class_family_index;
 
+// Runtime links of the spells of a client data version. Spells are linked on first use (see
+// dbc::spell_link()), from effects and power entries ordered by their spell id. The ordered lists
+// are created when the first spell of the version is linked.
+struct link_storage_t
+{
+  std::vector<const spelleffect_data_t*> effects_by_spell;
+  std::vector<const spelleffect_data_t*> effects_by_trigger;
+  std::vector<const spellpower_data_t*>  power_by_spell;
+  // Links of each spell, indexed by the position of the spell in the spell data table
+  std::unique_ptr<std::atomic<dbc::spell_link_t*>[]> spells;
+  size_t n_spells;
+
+  link_storage_t() : n_spells( 0 )
+  { }
+
+  void clear()
+  {
+    for ( size_t i = 0; i < n_spells; ++i )
+    {
+      delete spells[ i ].load( std::memory_order_relaxed );
+    }
+
+    spells.reset();
+    n_spells = 0;
+    std::vector<const spelleffect_data_t*>().swap( effects_by_spell );
+    std::vector<const spelleffect_data_t*>().swap( effects_by_trigger );
+    std::vector<const spellpower_data_t*>().swap( power_by_spell );
+  }
+};
+
+link_storage_t link_storage[ 2 ];
+std::atomic<bool> link_storage_state[ 2 ];
+mutex_t link_storage_mutex;
+
+// Live and PTR data are linked separately on first access, see dbc::link_data()
+std::atomic<bool> link_state[ 2 ];
+std::atomic<std::thread::id> linking_thread;
+mutex_t link_mutex;
+
+// Orders client data by a spell id of the data, and then by the id of the data
+template <typename T, unsigned ( T::*KEY )() const>
+struct spell_key_compare_t
+{
+  bool operator()( const T* l, unsigned r ) const
+  { return ( l ->* KEY )() < r; }
+
+  bool operator()( unsigned l, const T* r ) const
+  { return l < ( r ->* KEY )(); }
+
+  bool operator()( const T* l, const T* r ) const
+  {
+    return ( l ->* KEY )() < ( r ->* KEY )() ||
+           ( ( l ->* KEY )() == ( r ->* KEY )() && l -> id() < r -> id() );
+  }
+};
+
+typedef spell_key_compare_t<spelleffect_data_t, &spelleffect_data_t::spell_id> effect_spell_compare_t;
+typedef spell_key_compare_t<spelleffect_data_t, &spelleffect_data_t::trigger_spell_id> effect_trigger_compare_t;
+typedef spell_key_compare_t<spellpower_data_t, &spellpower_data_t::spell_id> power_spell_compare_t;
+
+// Order the effects and power entries of a client data version by spell id, once
+const link_storage_t& init_link_storage( bool ptr )
+{
+  link_storage_t& storage = link_storage[ ptr ];
+  if ( link_storage_state[ ptr ].load( std::memory_order_acquire ) )
+  {
+    return storage;
+  }
+
+  auto_lock_t lock( link_storage_mutex );
+  if ( link_storage_state[ ptr ].load( std::memory_order_relaxed ) )
+  {
+    return storage;
+  }
+
+  // The data access functions are not used here, as they trigger dbc::link_data()
+  size_t n_effects = spelleffect_data_index.size( ptr );
+  const spelleffect_data_t* effects = spelleffect_data_index.begin( ptr );
+  storage.effects_by_spell.reserve( n_effects );
+  for ( size_t i = 0; i < n_effects; ++i )
+  {
+    storage.effects_by_spell.push_back( &effects[ i ] );
+    if ( effects[ i ].trigger_spell_id() > 0 )
+    {
+      storage.effects_by_trigger.push_back( &effects[ i ] );
+    }
+  }
+  std::sort( storage.effects_by_spell.begin(), storage.effects_by_spell.end(),
+             effect_spell_compare_t() );
+  std::sort( storage.effects_by_trigger.begin(), storage.effects_by_trigger.end(),
+             effect_trigger_compare_t() );
+
+  size_t n_power = power_data_index.size( ptr );
+  const spellpower_data_t* power = power_data_index.begin( ptr );
+  storage.power_by_spell.reserve( n_power );
+  for ( size_t i = 0; i < n_power; ++i )
+  {
+    storage.power_by_spell.push_back( &power[ i ] );
+  }
+  std::sort( storage.power_by_spell.begin(), storage.power_by_spell.end(),
+             power_spell_compare_t() );
+
+  storage.n_spells = spell_data_index.size( ptr );
+  storage.spells.reset( new std::atomic<dbc::spell_link_t*>[ storage.n_spells ]() );
+
+  link_storage_state[ ptr ].store( true, std::memory_order_release );
+  return storage;
+}
+
+// Create the runtime links of a spell in the client data
+dbc::spell_link_t* create_spell_link( const link_storage_t& storage, const spell_data_t* spell, bool ptr )
+{
+  auto link = new dbc::spell_link_t();
+
+  auto effects = std::equal_range( storage.effects_by_spell.begin(), storage.effects_by_spell.end(),
+                                   spell -> id(), effect_spell_compare_t() );
+  for ( auto it = effects.first; it != effects.second; ++it )
+  {
+    const spelleffect_data_t* ed = *it;
+    if ( link -> effects.size() < ed -> index() + 1 )
+      link -> effects.resize( ed -> index() + 1, spelleffect_data_t::nil() );
+
+    link -> effects[ ed -> index() ] = ed;
+  }
+
+  auto power = std::equal_range( storage.power_by_spell.begin(), storage.power_by_spell.end(),
+                                 spell -> id(), power_spell_compare_t() );
+  link -> power.assign( power.first, power.second );
+
+  auto triggers = std::equal_range( storage.effects_by_trigger.begin(), storage.effects_by_trigger.end(),
+                                    spell -> id(), effect_trigger_compare_t() );
+  for ( auto it = triggers.first; it != triggers.second; ++it )
+  {
+    spell_data_t* driver = spell_data_index.get( ptr, ( *it ) -> spell_id() );
+    if ( ! driver )
+      driver = spell_data_t::nil();
+
+    if ( range::find( link -> drivers, driver ) == link -> drivers.end() )
+      link -> drivers.push_back( driver );
+  }
+
+  return link;
+}
+
 } // ANONYMOUS namespace ====================================================
 
 int dbc::build_level( bool ptr )
@@ -156,38 +301,122 @@ static void generate_class_flags_index( bool ptr = false )
  */
 void dbc::init()
 {
-  // Create id-indexes
-  spell_data_index.init();
-  spelleffect_data_index.init();
-  talent_data_index.init();
-  power_data_index.init();
-  artifact_power_rank_data_index.init();
+  // Create id-indexes. Indexes are created directly from the static data, as the data access
+  // functions would trigger the runtime linking.
+  spell_data_index.init( __spell_data, false );
+  spelleffect_data_index.init( __spelleffect_data, false );
+  talent_data_index.init( __talent_data, false );
+  power_data_index.init( __spellpower_data, false );
+  artifact_power_rank_data_index.init( __artifact_power_rank_data, false );
+#if SC_USE_PTR
+  spell_data_index.init( __ptr_spell_data, true );
+  spelleffect_data_index.init( __ptr_spelleffect_data, true );
+  talent_data_index.init( __ptr_talent_data, true );
+  power_data_index.init( __ptr_spellpower_data, true );
+  artifact_power_rank_data_index.init( __ptr_artifact_power_rank_data, true );
+#endif
   init_item_data();
 
-  // runtime linking, eg. from spell_data to all its effects
-  spell_data_t::link( false );
-  spelleffect_data_t::link( false );
-  spellpower_data_t::link( false );
-  talent_data_t::link( false );
+  // Runtime linking of the live or PTR data is deferred to the first access of the data (see
+  // dbc::link_data()), and of spells to their effects, power entries, and drivers to the first use
+  // of each spell (see dbc::spell_link()).
+}
 
-  if ( SC_USE_PTR )
+/* Runtime link live or PTR client data. Called by the data access functions, the fast path is a
+ * single atomic load. The thread performing the linking may access the data while the linking is
+ * in progress (the linking, and applying hotfixes uses the normal data access functions). Spells
+ * are not linked here, see dbc::spell_link().
+ */
+void dbc::link_data( bool ptr )
+{
+  ptr = maybe_ptr( ptr );
+
+  if ( link_state[ ptr ].load( std::memory_order_acquire ) ||
+       linking_thread.load( std::memory_order_relaxed ) == std::this_thread::get_id() )
   {
-    spell_data_t::link( true );
-    spelleffect_data_t::link( true );
-    spellpower_data_t::link( true );
-    talent_data_t::link( true );
+    return;
   }
 
+  auto_lock_t lock( link_mutex );
+
+  if ( link_state[ ptr ].load( std::memory_order_relaxed ) )
+  {
+    return;
+  }
+
+  linking_thread.store( std::this_thread::get_id(), std::memory_order_relaxed );
+
+  // runtime linking of talents to their spells
+  talent_data_t::link( ptr );
+
   // Link client side hotfix data to spells, effects, and power entries after everything else is
   // done
-  hotfix::link_hotfix_data( false );
-#if SC_USE_PTR
-  hotfix::link_hotfix_data( true );
-#endif
+  hotfix::link_hotfix_data( ptr );
 
-  generate_class_flags_index();
-  if ( SC_USE_PTR )
-    generate_class_flags_index( true );
+  generate_class_flags_index( ptr );
+
+  // Simulator hotfixes registered for this data, if they were already applied to the other
+  // data set
+  hotfix::apply_deferred( ptr );
+
+  linking_thread.store( std::thread::id(), std::memory_order_relaxed );
+  link_state[ ptr ].store( true, std::memory_order_release );
+}
+
+bool dbc::data_linked( bool ptr )
+{ return link_state[ maybe_ptr( ptr ) ].load( std::memory_order_acquire ); }
+
+/* Runtime links of a spell in the live or PTR client data, created on the first use of the spell.
+ * Threads linking the same spell concurrently create the links independently, and all but the
+ * first thread to publish its links discard theirs.
+ */
+const dbc::spell_link_t* dbc::spell_link( const spell_data_t* spell )
+{
+  bool ptr = false;
+  std::ptrdiff_t idx = spell_data_index.position( false, spell );
+  if ( SC_USE_PTR && idx == -1 )
+  {
+    ptr = true;
+    idx = spell_data_index.position( true, spell );
+  }
+
+  if ( idx == -1 )
+  {
+    return nullptr;
+  }
+
+  const link_storage_t& storage = init_link_storage( ptr );
+  std::atomic<spell_link_t*>& slot = storage.spells[ idx ];
+  if ( spell_link_t* link = slot.load( std::memory_order_acquire ) )
+  {
+    return link;
+  }
+
+  spell_link_t* link = create_spell_link( storage, spell, ptr );
+  spell_link_t* linked = nullptr;
+  if ( ! slot.compare_exchange_strong( linked, link, std::memory_order_acq_rel ) )
+  {
+    delete link;
+    return linked;
+  }
+
+  return link;
+}
+
+spell_data_t* dbc::effect_spell( const spelleffect_data_t* effect, unsigned spell_id )
+{
+  bool ptr = false;
+  if ( spelleffect_data_index.position( false, effect ) == -1 )
+  {
+    if ( ! SC_USE_PTR || spelleffect_data_index.position( true, effect ) == -1 )
+    {
+      return spell_data_t::not_found();
+    }
+    ptr = true;
+  }
+
+  spell_data_t* spell = spell_data_index.get( ptr, spell_id );
+  return spell ? spell : spell_data_t::nil();
 }
 
 /* De-Initialize database
@@ -239,6 +468,8 @@ std::vector< const spell_data_t* > dbc_t::effect_affects_spells( unsigned family
 {
   std::vector< const spell_data_t* > affected_spells;
 
+  dbc::link_data( ptr );
+
   if ( family == 0 )
     return affected_spells;
 
@@ -271,6 +502,8 @@ std::vector< const spelleffect_data_t* > dbc_t::effects_affecting_spell( const s
 {
   std::vector< const spelleffect_data_t* > affecting_effects;
 
+  dbc::link_data( ptr );
+
   if ( spell -> class_family() == 0 )
     return affecting_effects;
 
@@ -1365,7 +1598,7 @@ double dbc_t::real_ppm_modifier( unsigned spell_id, player_t* player, unsigned i
 
 spell_data_t* spell_data_t::list( bool ptr )
 {
-  ( void )ptr;
+  dbc::link_data( ptr );
 
 #if SC_USE_PTR
   return ptr ? __ptr_spell_data : __spell_data;
@@ -1376,7 +1609,7 @@ spell_data_t* spell_data_t::list( bool ptr )
 
 spelleffect_data_t* spelleffect_data_t::list( bool ptr )
 {
-  ( void )ptr;
+  dbc::link_data( ptr );
 
 #if SC_USE_PTR
   return ptr ? __ptr_spelleffect_data : __spelleffect_data;
@@ -1387,7 +1620,7 @@ spelleffect_data_t* spelleffect_data_t::list( bool ptr )
 
 spellpower_data_t* spellpower_data_t::list( bool ptr )
 {
-  ( void )ptr;
+  dbc::link_data( ptr );
 
 #if SC_USE_PTR
   return ptr ? __ptr_spellpower_data : __spellpower_data;
@@ -1398,7 +1631,7 @@ spellpower_data_t* spellpower_data_t::list( bool ptr )
 
 artifact_power_rank_t* artifact_power_rank_t::list( bool ptr )
 {
-  ( void )ptr;
+  dbc::link_data( ptr );
 
 #if SC_USE_PTR
   return ptr ? __ptr_artifact_power_rank_data
@@ -1410,14 +1643,14 @@ artifact_power_rank_t* artifact_power_rank_t::list( bool ptr )
 
 double spelleffect_data_t::scaled_average( double budget, unsigned level ) const
 {
-  if ( _m_avg != 0 && _spell -> scaling_class() != 0 )
+  if ( _m_avg != 0 && spell() -> scaling_class() != 0 )
     return _m_avg * budget;
   else if ( _real_ppl != 0 )
   {
-    if ( _spell -> max_level() > 0 )
-      return _base_value + ( std::min( level, _spell -> max_level() ) - _spell -> level() ) * _real_ppl;
+    if ( spell() -> max_level() > 0 )
+      return _base_value + ( std::min( level, spell() -> max_level() ) - spell() -> level() ) * _real_ppl;
     else
-      return _base_value + ( level - _spell -> level() ) * _real_ppl;
+      return _base_value + ( level - spell() -> level() ) * _real_ppl;
   }
   else
     return _base_value;
@@ -1429,12 +1662,12 @@ double spelleffect_data_t::average( const player_t* p, unsigned level ) const
 
   double m_scale = 0;
 
-  if ( _m_avg != 0 && _spell -> scaling_class() != 0 )
+  if ( _m_avg != 0 && spell() -> scaling_class() != 0 )
   {
     unsigned scaling_level = level ? level : p -> level();
-    if ( _spell -> max_scaling_level() > 0 )
-      scaling_level = std::min( scaling_level, _spell -> max_scaling_level() );
-    m_scale = p -> dbc.spell_scaling( _spell -> scaling_class(), scaling_level );
+    if ( spell() -> max_scaling_level() > 0 )
+      scaling_level = std::min( scaling_level, spell() -> max_scaling_level() );
+    m_scale = p -> dbc.spell_scaling( spell() -> scaling_class(), scaling_level );
   }
 
   return scaled_average( m_scale, level );
@@ -1447,8 +1680,8 @@ double spelleffect_data_t::average( const item_t* item ) const
   if ( ! item )
     return 0;
 
-  if ( _m_avg != 0 && _spell -> scaling_class() != 0 )
-    m_scale = item_database::item_budget( item, _spell -> max_scaling_level() );
+  if ( _m_avg != 0 && spell() -> scaling_class() != 0 )
+    m_scale = item_database::item_budget( item, spell() -> max_scaling_level() );
 
   return scaled_average( m_scale, item -> item_level() );
 }
@@ -1489,12 +1722,12 @@ double spelleffect_data_t::delta( const player_t* p, unsigned level ) const
   assert( level <= MAX_SCALING_LEVEL );
 
   double m_scale = 0;
-  if ( _m_delta != 0 && _spell -> scaling_class() != 0 )
+  if ( _m_delta != 0 && spell() -> scaling_class() != 0 )
   {
     unsigned scaling_level = level ? level : p -> level();
-    if ( _spell -> max_scaling_level() > 0 )
-      scaling_level = std::min( scaling_level, _spell -> max_scaling_level() );
-    m_scale = p -> dbc.spell_scaling( _spell -> scaling_class(), scaling_level );
+    if ( spell() -> max_scaling_level() > 0 )
+      scaling_level = std::min( scaling_level, spell() -> max_scaling_level() );
+    m_scale = p -> dbc.spell_scaling( spell() -> scaling_class(), scaling_level );
   }
 
   return scaled_delta( m_scale );
@@ -1507,8 +1740,8 @@ double spelleffect_data_t::delta( const item_t* item ) const
   if ( ! item )
     return 0;
 
-  if ( _m_delta != 0 && _spell -> scaling_class() != 0 )
-    m_scale = item_database::item_budget( item, _spell -> max_scaling_level() );
+  if ( _m_delta != 0 && spell() -> scaling_class() != 0 )
+    m_scale = item_database::item_budget( item, spell() -> max_scaling_level() );
 
   return scaled_delta( m_scale );
 }
@@ -1584,7 +1817,7 @@ double spelleffect_data_t::min( const player_t* p, unsigned level ) const
 
 double spelleffect_data_t::min( const item_t* item ) const
 {
-  assert( _spell -> scaling_class() == 0 || _spell -> scaling_class() == -1 );
+  assert( spell() -> scaling_class() == 0 || spell() -> scaling_class() == -1 );
 
   return scaled_min( average( item ), delta( item ) );
 }
@@ -1598,14 +1831,14 @@ double spelleffect_data_t::max( const player_t* p, unsigned level ) const
 
 double spelleffect_data_t::max( const item_t* item ) const
 {
-  assert( _spell -> scaling_class() == 0 || _spell -> scaling_class() == -1 );
+  assert( spell() -> scaling_class() == 0 || spell() -> scaling_class() == -1 );
 
   return scaled_max( average( item ), delta( item ) );
 }
 
 talent_data_t* talent_data_t::list( bool ptr )
 {
-  ( void )ptr;
+  dbc::link_data( ptr );
 
 #if SC_USE_PTR
   return ptr ? __ptr_talent_data : __talent_data;
@@ -1616,6 +1849,8 @@ talent_data_t* talent_data_t::list( bool ptr )
 
 spell_data_t* spell_data_t::find( unsigned spell_id, bool ptr )
 {
+  dbc::link_data( ptr );
+
   spell_data_t* s = spell_data_index.get( ptr, spell_id );
   if ( !s )
     s = spell_data_t::nil();
@@ -1646,6 +1881,8 @@ spell_data_t* spell_data_t::find( const char* name, bool ptr )
 // Always returns non-NULL
 spelleffect_data_t* spelleffect_data_t::find( unsigned id, bool ptr )
 {
+  dbc::link_data( ptr );
+
   spelleffect_data_t* effect = spelleffect_data_index.get( ptr, id );
   if ( ! effect )
     effect = spelleffect_data_t::nil();
@@ -1655,12 +1892,16 @@ spelleffect_data_t* spelleffect_data_t::find( unsigned id, bool ptr )
 // Always returns non-NULL
 spellpower_data_t* spellpower_data_t::find( unsigned id, bool ptr )
 {
+  dbc::link_data( ptr );
+
   spellpower_data_t* power = power_data_index.get( ptr, id );
   return power ? power : spellpower_data_t::nil();
 }
 
 artifact_power_rank_t* artifact_power_rank_t::find( unsigned id, bool ptr )
 {
+  dbc::link_data( ptr );
+
   artifact_power_rank_t* rank = artifact_power_rank_data_index.get( ptr, id );
   return rank ? rank : artifact_power_rank_t::nil();
 }
@@ -1700,6 +1941,8 @@ talent_data_t* talent_data_t::find( player_e c, unsigned int row, unsigned int c
 
 talent_data_t* talent_data_t::find( unsigned id, bool ptr )
 {
+  dbc::link_data( ptr );
+
   talent_data_t* t = talent_data_index.get( ptr, id );
   if ( ! t )
     t = talent_data_t::nil();
@@ -1741,82 +1984,12 @@ talent_data_t* talent_data_t::find_tokenized( const char* name, specialization_e
   return nullptr;
 }
 
-void spell_data_t::link( bool ptr )
-{
-  spell_data_t* spell_data = spell_data_t::list( ptr );
-
-  for ( int i = 0; spell_data[ i ].id(); i++ )
-  {
-    spell_data_t& sd = spell_data[ i ];
-    sd._effects = new std::vector<const spelleffect_data_t*>;
-  }
-}
-
-void spelleffect_data_t::link( bool ptr )
-{
-  spelleffect_data_t* spelleffect_data = spelleffect_data_t::list( ptr );
-
-  for ( int i = 0; spelleffect_data[ i ].id(); i++ )
-  {
-    spelleffect_data_t& ed = spelleffect_data[ i ];
-
-    ed._spell         = spell_data_t::find( ed.spell_id(), ptr );
-    ed._trigger_spell = spell_data_t::find( ed.trigger_spell_id(), ptr );
-    if ( ed._trigger_spell -> id() > 0 )
-    {
-      if ( ! ed._trigger_spell -> _driver )
-      {
-        ed._trigger_spell -> _driver = new std::vector<spell_data_t*>;
-      }
-      if ( range::find( *ed._trigger_spell -> _driver, ed._spell ) == ed._trigger_spell -> _driver -> end() )
-      {
-        ed._trigger_spell -> _driver -> push_back( ed._spell );
-      }
-    }
-
-    if ( ed._spell -> _effects -> size() < ( ed.index() + 1 ) )
-      ed._spell -> _effects -> resize( ed.index() + 1, spelleffect_data_t::nil() );
-
-    ed._spell -> _effects -> at( ed.index() ) = &ed;
-  }
-}
-
 void spell_data_t::de_link( bool ptr )
 {
-  spell_data_t* spell_data = spell_data_t::list( ptr );
+  auto_lock_t lock( link_storage_mutex );
 
-  for ( int i = 0; spell_data[ i ].id(); i++ )
-  {
-    spell_data_t& sd = spell_data[ i ];
-
-    if ( sd._effects )
-    {
-      // delete dynamically allocated vector with spelleffect_data_t pointers
-      delete sd._effects;
-    }
-    if ( sd._power )
-    {
-      // delete dynamically allocated vector with spellpower_data_t pointers
-      delete sd._power;
-    }
-    delete sd._driver;
-  }
-}
-
-void spellpower_data_t::link( bool ptr )
-{
-  spellpower_data_t* spellpower_data = spellpower_data_t::list( ptr );
-
-  for ( int i = 0; spellpower_data[ i ]._id; i++ )
-  {
-    spellpower_data_t& pd = spellpower_data[ i ];
-    spell_data_t*      sd = spell_data_t::find( pd._spell_id, ptr );
-
-    if ( sd -> _power == nullptr )
-      sd -> _power = new std::vector<const spellpower_data_t*>;
-
-    sd -> _power -> push_back( &pd );
-  }
+  link_storage[ maybe_ptr( ptr ) ].clear();
+  link_storage_state[ maybe_ptr( ptr ) ].store( false, std::memory_order_release );
 }
 
 void talent_data_t::link( bool ptr )
@@ -1929,7 +2102,7 @@ double dbc_t::effect_min( const spelleffect_data_t* e, unsigned level ) const
   assert( e && ( level > 0 ) );
   assert( ( level <= MAX_SCALING_LEVEL ) );
 
-  unsigned c_id = util::class_id( e -> _spell -> scaling_class() );
+  unsigned c_id = util::class_id( e -> spell() -> scaling_class() );
   avg = effect_average( e, level );
 
   if ( c_id != 0 && ( e -> m_average() != 0 || e -> m_delta() != 0 ) )
@@ -1971,7 +2144,7 @@ double dbc_t::effect_max( const spelleffect_data_t* e, unsigned level ) const
 
   assert( e && ( level > 0 ) && ( level <= MAX_SCALING_LEVEL ) );
 
-  unsigned c_id = util::class_id( e -> _spell -> scaling_class() );
+  unsigned c_id = util::class_id( e -> spell() -> scaling_class() );
   avg = effect_average( e, level );
 
   if ( c_id != 0 && ( e -> m_average() != 0 || e -> m_delta() != 0 ) )
@@ -194,6 +194,23 @@ namespace hotfix
 {
 static auto_dispose< std::vector< hotfix_entry_t* > > hotfixes_;
 static custom_dbc_data_t hotfix_db_;
+// hotfix::apply() has been called, and which client data the hotfixes have been applied to
+static bool apply_requested_ = false;
+static bool applied_[ 2 ] = { false, false };
+
+static void apply_hotfixes( bool ptr )
+{
+  if ( applied_[ ptr ] )
+  {
+    return;
+  }
+
+  applied_[ ptr ] = true;
+  for ( size_t i = 0; i < hotfixes_.size(); ++i )
+  {
+    hotfixes_[ i ] -> apply( ptr );
+  }
+}
 }
 
 // Very simple comparator, just checks for some equality in the data. There's no need for fanciful
@@ -241,11 +258,26 @@ bool hotfix::register_hotfix( const std::string& group,
   return true;
 }
 
+// Apply hotfixes to client data that is already linked. Client data that is linked later on gets
+// hotfixed through hotfix::apply_deferred().
 void hotfix::apply()
 {
-  for ( size_t i = 0; i < hotfixes_.size(); ++i )
+  apply_requested_ = true;
+
+  apply_hotfixes( false );
+#if SC_USE_PTR
+  if ( dbc::data_linked( true ) )
+  {
+    apply_hotfixes( true );
+  }
+#endif
+}
+
+void hotfix::apply_deferred( bool ptr )
+{
+  if ( apply_requested_ )
   {
-    hotfixes_[ i ] -> apply();
+    apply_hotfixes( ptr );
   }
 }
 
@@ -312,6 +344,9 @@ effect_hotfix_entry_t& hotfix::register_effect( const std::string& group,
 
 std::string hotfix::to_str( bool ptr )
 {
+  // Make sure the (possibly deferred) hotfixes have been applied to the data
+  dbc::link_data( ptr );
+
   std::stringstream s;
   std::string current_group;
   bool first_group = true;
@@ -567,7 +602,7 @@ bool custom_dbc_data_t::add_effect( spelleffect_data_t* effect, bool ptr )
 
 static void collect_base_spells( const spell_data_t* spell, std::vector<const spell_data_t*>& roots )
 {
-  if ( ! spell -> _driver )
+  if ( spell -> n_drivers() == 0 )
   {
     if ( range::find( roots, spell ) == roots.end() )
     {
@@ -576,7 +611,7 @@ static void collect_base_spells( const spell_data_t* spell, std::vector<const sp
   }
   else
   {
-    for ( auto driver_spell : *spell -> _driver )
+    for ( auto driver_spell : *spell -> driver_list() )
     {
       // Safeguard infinite recursions
       if ( range::find( roots, driver_spell ) != roots.end() )
@@ -597,26 +632,29 @@ spell_data_t* custom_dbc_data_t::create_clone( const spell_data_t* source, bool
     clone = new spell_data_t( *source );
     // TODO: Power, not overridable atm so we can use the static data, and the static data vector
     // too.
-    clone -> _effects = new std::vector<const spelleffect_data_t*>( clone -> effect_count(), spelleffect_data_t::nil() );
+    clone -> _effects = new std::vector<const spelleffect_data_t*>( source -> effect_count(), spelleffect_data_t::nil() );
+    clone -> _power = source -> power_list();
     // Drivers are set up in the parent's cloning of the trigger spell
     clone -> _driver = 0;
     add_spell( clone, ptr );
   }
 
   // Clone effects
-  for ( size_t i = 0; i < source -> _effects -> size(); ++i )
+  for ( size_t i = 0; i < source -> effect_count(); ++i )
   {
-    if ( source -> _effects -> at( i ) -> id() == 0 )
+    const spelleffect_data_t* e_source = &( source -> effectN( i + 1 ) );
+    if ( e_source -> id() == 0 )
     {
       continue;
     }
 
-    const spelleffect_data_t* e_source = source -> _effects -> at( i );
     spelleffect_data_t* e_clone = get_mutable_effect( e_source -> id(), ptr );
 
     if ( ! e_clone )
     {
-      e_clone = new spelleffect_data_t( *spelleffect_data_t::find( e_source -> id(), ptr ) );
+      const spelleffect_data_t* e_data = spelleffect_data_t::find( e_source -> id(), ptr );
+      e_clone = new spelleffect_data_t( *e_data );
+      e_clone -> _trigger_spell = e_data -> trigger();
       add_effect( e_clone, ptr );
     }
 
@@ -633,7 +671,7 @@ spell_data_t* custom_dbc_data_t::create_clone( const spell_data_t* source, bool
     // Clone the trigger, and re-link drivers in the trigger spell so they also point to cloned
     // data. This is necessary because Blizzard re-uses trigger spells in multiple drivers.
     e_clone -> _trigger_spell = create_clone( e_source -> trigger(), ptr );
-    assert( e_source -> trigger() -> _driver );
+    assert( e_source -> trigger() -> n_drivers() > 0 );
     if ( ! e_clone -> _trigger_spell -> _driver )
     {
       e_clone -> _trigger_spell -> _driver = new std::vector<spell_data_t*>( e_source -> trigger() -> n_drivers(), spell_data_t::nil() );
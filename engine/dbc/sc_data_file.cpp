@@ -0,0 +1,610 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+/**
+ * Binary client data container.
+ *
+ * Allows the (large) item data tables to be loaded from a memory-mapped file at startup instead of
+ * using the tables compiled into the binary. The file is mapped read-only and shared, so
+ * concurrently running simc processes share the same physical pages. The compiled-in tables are
+ * used if no file is given. A file that does not match the build (layout or client data build
+ * level), or fails validation, is an error.
+ *
+ * File layout (all integers in native byte order, the file is not portable between
+ * architectures):
+ *
+ * data_file_header_t
+ * data_file_section_t[ header.n_sections ]
+ * section payloads, each aligned to SECTION_ALIGNMENT bytes
+ *
+ * String pointers inside the item records are stored pre-relocated against header.base_address.
+ * If the file can be mapped at that address, the records are used as is (zero-copy). Otherwise the
+ * file is mapped copy-on-write and the string pointers are relocated in place.
+ */
+
+#include "simulationcraft.hpp"
+
+#if defined( SC_WINDOWS )
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace { // ANONYMOUS namespace ==========================================
+
+const char     DATA_FILE_MAGIC[ 4 ] = { 'S', 'C', 'D', 'B' };
+const uint32_t DATA_FILE_VERSION    = 1;
+const uint64_t SECTION_ALIGNMENT    = 64;
+
+// Preferred mapping address of the data file, chosen to be well clear of where the heap, shared
+// libraries and thread stacks normally end up.
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __aarch64__ )
+const uint64_t PREFERRED_BASE_ADDRESS = 0x3e0000000000ULL;
+#else
+const uint64_t PREFERRED_BASE_ADDRESS = 0x58000000ULL;
+#endif
+
+enum data_file_section_e : uint32_t
+{
+  SECTION_ITEM_DATA = 1,     // item_data_t[ n_records ], terminated by an all-zero record
+  SECTION_STRINGS,           // NUL-terminated strings referenced by the records
+  SECTION_POTION_INDEX,      // uint32_t[ n_records ], indices into SECTION_ITEM_DATA
+  SECTION_FLASK_INDEX,
+  SECTION_FOOD_INDEX,
+};
+
+struct data_file_header_t
+{
+  char     magic[ 4 ];
+  uint32_t version;
+  uint32_t item_record_size; // sizeof( item_data_t ) of the build that wrote the file
+  uint32_t n_sections;
+  uint64_t base_address;
+  uint64_t file_size;
+};
+
+struct data_file_section_t
+{
+  uint32_t type;
+  uint32_t ptr;
+  uint32_t build_level;
+  uint32_t n_records;
+  uint64_t offset;
+  uint64_t size;
+};
+
+// A (possibly relocated) view of a mapped data file
+struct data_file_mapping_t
+{
+  char*       address;
+  std::size_t size;
+  bool        relocated;
+#if defined( SC_WINDOWS )
+  HANDLE      file, mapping;
+#endif
+
+  data_file_mapping_t() : address( nullptr ), size( 0 ), relocated( false )
+#if defined( SC_WINDOWS )
+    , file( INVALID_HANDLE_VALUE ), mapping( nullptr )
+#endif
+  { }
+};
+
+data_file_mapping_t mapping;
+dbc::data_file::item_table_t item_tables[ 2 ];
+
+std::size_t align( std::size_t v )
+{ return ( v + SECTION_ALIGNMENT - 1 ) & ~( SECTION_ALIGNMENT - 1 ); }
+
+bool is_consumable( const item_data_t& item, item_subclass_consumable subclass )
+{ return item.item_class == ITEM_CLASS_CONSUMABLE && item.item_subclass == subclass; }
+
+// Map the file at the preferred address (read-only, shared), or anywhere (copy-on-write) if
+// relocation is allowed. Returns false if the file could not be mapped with the requested mode.
+#if defined( SC_WINDOWS )
+bool map_file( const std::string& file_name, data_file_mapping_t& m, void* base, bool relocatable )
+{
+  if ( m.file == INVALID_HANDLE_VALUE )
+  {
+    m.file = CreateFileW( io::widen( file_name ).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( m.file == INVALID_HANDLE_VALUE )
+      return false;
+
+    LARGE_INTEGER size;
+    if ( ! GetFileSizeEx( m.file, &size ) )
+      return false;
+    m.size = static_cast<std::size_t>( size.QuadPart );
+
+    m.mapping = CreateFileMappingW( m.file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr );
+    if ( ! m.mapping )
+      return false;
+  }
+
+  m.address = static_cast<char*>( MapViewOfFileEx( m.mapping, relocatable ? FILE_MAP_COPY : FILE_MAP_READ,
+                                                   0, 0, 0, relocatable ? nullptr : base ) );
+  m.relocated = relocatable;
+  return m.address != nullptr;
+}
+
+void unmap_file( data_file_mapping_t& m )
+{
+  if ( m.address )
+    UnmapViewOfFile( m.address );
+  if ( m.mapping )
+    CloseHandle( m.mapping );
+  if ( m.file != INVALID_HANDLE_VALUE )
+    CloseHandle( m.file );
+
+  m = data_file_mapping_t();
+}
+
+void protect_file( data_file_mapping_t& m )
+{
+  DWORD old;
+  VirtualProtect( m.address, m.size, PAGE_READONLY, &old );
+}
+#else
+bool map_file( const std::string& file_name, data_file_mapping_t& m, void* base, bool relocatable )
+{
+  int fd = open( file_name.c_str(), O_RDONLY );
+  if ( fd == -1 )
+    return false;
+
+  struct stat st;
+  if ( fstat( fd, &st ) == -1 )
+  {
+    close( fd );
+    return false;
+  }
+
+  m.size = static_cast<std::size_t>( st.st_size );
+  void* addr = mmap( relocatable ? nullptr : base, m.size,
+                     relocatable ? PROT_READ | PROT_WRITE : PROT_READ,
+                     relocatable ? MAP_PRIVATE : MAP_SHARED, fd, 0 );
+  close( fd );
+
+  if ( addr == MAP_FAILED )
+    return false;
+
+  // The address is only a hint to the kernel, fail if we did not get what we asked for
+  if ( ! relocatable && addr != base )
+  {
+    munmap( addr, m.size );
+    return false;
+  }
+
+  m.address = static_cast<char*>( addr );
+  m.relocated = relocatable;
+  return true;
+}
+
+void unmap_file( data_file_mapping_t& m )
+{
+  if ( m.address )
+    munmap( m.address, m.size );
+
+  m = data_file_mapping_t();
+}
+
+void protect_file( data_file_mapping_t& m )
+{ mprotect( m.address, m.size, PROT_READ ); }
+#endif
+
+// Validate the file header and section table against this build. Everything assign_tables() and
+// relocate() rely on is checked here, so that a damaged or mismatched file is rejected up front
+// instead of handing out out-of-bounds item data.
+bool validate( const data_file_mapping_t& m, std::string& error )
+{
+  if ( m.size < sizeof( data_file_header_t ) )
+  {
+    error = "file too small";
+    return false;
+  }
+
+  const data_file_header_t* header = reinterpret_cast<const data_file_header_t*>( m.address );
+  if ( std::memcmp( header -> magic, DATA_FILE_MAGIC, sizeof( DATA_FILE_MAGIC ) ) != 0 )
+  {
+    error = "not a simc data file";
+    return false;
+  }
+
+  if ( header -> version != DATA_FILE_VERSION )
+  {
+    error = "unsupported data file version " + util::to_string( header -> version );
+    return false;
+  }
+
+  if ( header -> item_record_size != sizeof( item_data_t ) )
+  {
+    error = "item record layout mismatch (file " + util::to_string( header -> item_record_size ) +
+            ", build " + util::to_string( sizeof( item_data_t ) ) + ")";
+    return false;
+  }
+
+  if ( header -> file_size != m.size ||
+       sizeof( data_file_header_t ) + static_cast<uint64_t>( header -> n_sections ) * sizeof( data_file_section_t ) > m.size )
+  {
+    error = "truncated data file";
+    return false;
+  }
+
+  const data_file_section_t* sections = reinterpret_cast<const data_file_section_t*>( header + 1 );
+  for ( uint32_t i = 0; i < header -> n_sections; ++i )
+  {
+    const data_file_section_t& s = sections[ i ];
+    if ( s.offset > m.size || s.size > m.size - s.offset || s.offset % SECTION_ALIGNMENT != 0 )
+    {
+      error = "invalid section " + util::to_string( i );
+      return false;
+    }
+  }
+
+  // Item and string sections, per client data version
+  const data_file_section_t* item_sections[ 2 ] = { nullptr, nullptr };
+  const data_file_section_t* string_sections[ 2 ] = { nullptr, nullptr };
+  for ( uint32_t i = 0; i < header -> n_sections; ++i )
+  {
+    const data_file_section_t& s = sections[ i ];
+    if ( s.ptr && ! SC_USE_PTR )
+      continue;
+
+    if ( s.build_level != as<uint32_t>( dbc::build_level( s.ptr != 0 ) ) )
+    {
+      error = "client data build mismatch (file " + util::to_string( s.build_level ) +
+              ", build " + util::to_string( dbc::build_level( s.ptr != 0 ) ) + ")";
+      return false;
+    }
+
+    if ( s.type == SECTION_ITEM_DATA || s.type == SECTION_STRINGS )
+    {
+      const data_file_section_t*& slot = ( s.type == SECTION_ITEM_DATA ? item_sections : string_sections )[ s.ptr != 0 ];
+      if ( slot )
+      {
+        error = "duplicate section " + util::to_string( i );
+        return false;
+      }
+      slot = &s;
+    }
+  }
+
+  for ( unsigned ptr = 0; ptr < 2; ++ptr )
+  {
+    const data_file_section_t* items = item_sections[ ptr ];
+    const data_file_section_t* strings = string_sections[ ptr ];
+    if ( ! items && ! strings )
+      continue;
+
+    // Records include the terminating zero record
+    if ( ! items || ! strings || items -> n_records == 0 ||
+         static_cast<uint64_t>( items -> n_records ) * sizeof( item_data_t ) > items -> size )
+    {
+      error = "invalid item data section";
+      return false;
+    }
+
+    const item_data_t* records = reinterpret_cast<const item_data_t*>( m.address + items -> offset );
+    if ( records[ items -> n_records - 1 ].id != 0 )
+    {
+      error = "item data is not terminated";
+      return false;
+    }
+
+    if ( strings -> size > 0 && m.address[ strings -> offset + strings -> size - 1 ] != '\0' )
+    {
+      error = "string section is not terminated";
+      return false;
+    }
+
+    // Names must point into the string section of the same client data version, and item ids must
+    // be strictly increasing, since item lookups binary search the records
+    uint64_t strings_begin = header -> base_address + strings -> offset;
+    for ( uint32_t j = 0; j + 1 < items -> n_records; ++j )
+    {
+      uint64_t name = reinterpret_cast<uintptr_t>( records[ j ].name );
+      if ( name && ( name < strings_begin || name - strings_begin >= strings -> size ) )
+      {
+        error = "item " + util::to_string( records[ j ].id ) + " name out of bounds";
+        return false;
+      }
+
+      if ( j > 0 && records[ j ].id <= records[ j - 1 ].id )
+      {
+        error = "item " + util::to_string( records[ j ].id ) + " is not sorted by id";
+        return false;
+      }
+    }
+  }
+
+  for ( uint32_t i = 0; i < header -> n_sections; ++i )
+  {
+    const data_file_section_t& s = sections[ i ];
+    if ( ( s.ptr && ! SC_USE_PTR ) || s.type < SECTION_POTION_INDEX || s.type > SECTION_FOOD_INDEX )
+      continue;
+
+    const data_file_section_t* items = item_sections[ s.ptr != 0 ];
+    if ( ! items || static_cast<uint64_t>( s.n_records ) * sizeof( uint32_t ) > s.size )
+    {
+      error = "invalid consumable index section " + util::to_string( i );
+      return false;
+    }
+
+    const uint32_t* indices = reinterpret_cast<const uint32_t*>( m.address + s.offset );
+    for ( uint32_t j = 0; j < s.n_records; ++j )
+    {
+      if ( indices[ j ] >= items -> n_records - 1 )
+      {
+        error = "consumable index out of bounds in section " + util::to_string( i );
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+// Relocate string pointers of a copy-on-write mapped file to the actual mapping address
+void relocate( data_file_mapping_t& m )
+{
+  const data_file_header_t* header = reinterpret_cast<const data_file_header_t*>( m.address );
+  const data_file_section_t* sections = reinterpret_cast<const data_file_section_t*>( header + 1 );
+  uint64_t base = header -> base_address;
+
+  for ( uint32_t i = 0; i < header -> n_sections; ++i )
+  {
+    if ( sections[ i ].type != SECTION_ITEM_DATA )
+      continue;
+
+    item_data_t* items = reinterpret_cast<item_data_t*>( m.address + sections[ i ].offset );
+    for ( uint32_t j = 0; j < sections[ i ].n_records; ++j )
+    {
+      if ( items[ j ].name )
+      {
+        uint64_t offset = reinterpret_cast<uintptr_t>( items[ j ].name ) - base;
+        items[ j ].name = m.address + offset;
+      }
+    }
+  }
+}
+
+// Collect the tables of the mapped file into item_tables
+void assign_tables( const data_file_mapping_t& m )
+{
+  const data_file_header_t* header = reinterpret_cast<const data_file_header_t*>( m.address );
+  const data_file_section_t* sections = reinterpret_cast<const data_file_section_t*>( header + 1 );
+
+  for ( uint32_t i = 0; i < header -> n_sections; ++i )
+  {
+    const data_file_section_t& s = sections[ i ];
+    if ( s.ptr && ! SC_USE_PTR )
+      continue;
+
+    dbc::data_file::item_table_t& table = item_tables[ s.ptr != 0 ];
+    table.build_level = s.build_level;
+
+    switch ( s.type )
+    {
+      case SECTION_ITEM_DATA:
+        table.items = reinterpret_cast<item_data_t*>( m.address + s.offset );
+        // Record count includes the terminating zero record
+        table.n_items = s.n_records - 1;
+        break;
+      case SECTION_POTION_INDEX:
+      case SECTION_FLASK_INDEX:
+      case SECTION_FOOD_INDEX:
+      {
+        unsigned idx = s.type - SECTION_POTION_INDEX;
+        table.consumable_index[ idx ] = reinterpret_cast<const uint32_t*>( m.address + s.offset );
+        table.n_consumables[ idx ] = s.n_records;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+// Serialize the compiled-in item data of one client data version into sections
+void add_item_sections( std::vector<data_file_section_t>& sections,
+                        std::vector<std::string>& payloads,
+                        const item_data_t* items, std::size_t n_items, bool ptr )
+{
+  data_file_section_t section;
+  std::memset( &section, 0, sizeof( section ) );
+  section.ptr = ptr;
+  section.build_level = as<uint32_t>( dbc::build_level( ptr ) );
+
+  // Strings are written first, so the string section offsets are known when the records are
+  // serialized. Offsets are relative to the string section, and fixed up in write().
+  std::string strings;
+  std::vector<uint64_t> name_offsets( n_items );
+  for ( std::size_t i = 0; i < n_items; ++i )
+  {
+    if ( ! items[ i ].name )
+    {
+      name_offsets[ i ] = std::numeric_limits<uint64_t>::max();
+      continue;
+    }
+
+    name_offsets[ i ] = strings.size();
+    strings.append( items[ i ].name, std::strlen( items[ i ].name ) + 1 );
+  }
+
+  // Item records, plus the terminating zero record
+  std::string records( ( n_items + 1 ) * sizeof( item_data_t ), '\0' );
+  for ( std::size_t i = 0; i < n_items; ++i )
+  {
+    item_data_t item = items[ i ];
+    // Temporarily store the offset into the string section, relocated in write()
+    item.name = name_offsets[ i ] == std::numeric_limits<uint64_t>::max()
+                ? nullptr : reinterpret_cast<const char*>( static_cast<uintptr_t>( name_offsets[ i ] + 1 ) );
+    std::memcpy( &records[ i * sizeof( item_data_t ) ], &item, sizeof( item_data_t ) );
+  }
+
+  section.type = SECTION_ITEM_DATA;
+  section.n_records = as<uint32_t>( n_items + 1 );
+  sections.push_back( section );
+  payloads.push_back( records );
+
+  section.type = SECTION_STRINGS;
+  section.n_records = 0;
+  sections.push_back( section );
+  payloads.push_back( strings );
+
+  // Consumable indices, mirroring the filtered_dbc_index_t instances in sc_item_data.cpp
+  const item_subclass_consumable subclasses[] = { ITEM_SUBCLASS_POTION, ITEM_SUBCLASS_FLASK, ITEM_SUBCLASS_FOOD };
+  for ( std::size_t s = 0; s < sizeof_array( subclasses ); ++s )
+  {
+    std::vector<uint32_t> idx;
+    for ( std::size_t i = 0; i < n_items; ++i )
+    {
+      if ( is_consumable( items[ i ], subclasses[ s ] ) )
+        idx.push_back( as<uint32_t>( i ) );
+    }
+
+    section.type = as<uint32_t>( SECTION_POTION_INDEX + s );
+    section.n_records = as<uint32_t>( idx.size() );
+    sections.push_back( section );
+    payloads.push_back( std::string( reinterpret_cast<const char*>( idx.data() ), idx.size() * sizeof( uint32_t ) ) );
+  }
+}
+
+} // ANONYMOUS namespace ====================================================
+
+/* Map a binary data file, and make its tables available through dbc::data_file::items(). Must be
+ * called before dbc::init().
+ */
+bool dbc::data_file::load( const std::string& file_name, std::string& error )
+{
+  assert( ! loaded() );
+
+  void* base = reinterpret_cast<void*>( static_cast<uintptr_t>( PREFERRED_BASE_ADDRESS ) );
+
+  // First, try a zero-copy mapping at the preferred address. If that fails, map the file
+  // copy-on-write anywhere, and relocate the string pointers.
+  if ( ! map_file( file_name, mapping, base, false ) )
+  {
+    unmap_file( mapping );
+    if ( ! map_file( file_name, mapping, base, true ) )
+    {
+      unmap_file( mapping );
+      error = "unable to map '" + file_name + "'";
+      return false;
+    }
+  }
+
+  if ( ! validate( mapping, error ) )
+  {
+    unmap_file( mapping );
+    return false;
+  }
+
+  if ( mapping.relocated )
+  {
+    relocate( mapping );
+    protect_file( mapping );
+  }
+
+  assign_tables( mapping );
+
+  return true;
+}
+
+void dbc::data_file::unload()
+{
+  unmap_file( mapping );
+  item_tables[ 0 ] = item_tables[ 1 ] = item_table_t();
+}
+
+bool dbc::data_file::loaded()
+{ return mapping.address != nullptr; }
+
+bool dbc::data_file::relocated()
+{ return mapping.relocated; }
+
+const dbc::data_file::item_table_t* dbc::data_file::items( bool ptr )
+{
+  const item_table_t* table = &( item_tables[ maybe_ptr( ptr ) ] );
+  return table -> items ? table : nullptr;
+}
+
+/* Write the compiled-in data tables into a binary data file
+ */
+bool dbc::data_file::write( const std::string& file_name, std::string& error )
+{
+  std::vector<data_file_section_t> sections;
+  std::vector<std::string> payloads;
+
+  add_item_sections( sections, payloads, __items_noptr(), n_items_noptr(), false );
+#if SC_USE_PTR
+  add_item_sections( sections, payloads, __items_ptr(), n_items_ptr(), true );
+#endif
+
+  data_file_header_t header;
+  std::memset( &header, 0, sizeof( header ) );
+  std::memcpy( header.magic, DATA_FILE_MAGIC, sizeof( DATA_FILE_MAGIC ) );
+  header.version = DATA_FILE_VERSION;
+  header.item_record_size = sizeof( item_data_t );
+  header.n_sections = as<uint32_t>( sections.size() );
+  header.base_address = PREFERRED_BASE_ADDRESS;
+
+  std::size_t offset = align( sizeof( header ) + sections.size() * sizeof( data_file_section_t ) );
+  for ( std::size_t i = 0; i < sections.size(); ++i )
+  {
+    sections[ i ].offset = offset;
+    sections[ i ].size = payloads[ i ].size();
+    offset = align( offset + payloads[ i ].size() );
+  }
+  header.file_size = offset;
+
+  // Relocate string references against the preferred base address. The string section always
+  // directly follows its item section.
+  for ( std::size_t i = 0; i < sections.size(); ++i )
+  {
+    if ( sections[ i ].type != SECTION_ITEM_DATA )
+      continue;
+
+    assert( i + 1 < sections.size() && sections[ i + 1 ].type == SECTION_STRINGS );
+    uint64_t string_base = header.base_address + sections[ i + 1 ].offset;
+    for ( uint32_t j = 0; j < sections[ i ].n_records; ++j )
+    {
+      item_data_t item;
+      std::memcpy( &item, &payloads[ i ][ j * sizeof( item_data_t ) ], sizeof( item_data_t ) );
+      if ( item.name )
+      {
+        uint64_t string_offset = reinterpret_cast<uintptr_t>( item.name ) - 1;
+        item.name = reinterpret_cast<const char*>( static_cast<uintptr_t>( string_base + string_offset ) );
+      }
+      std::memcpy( &payloads[ i ][ j * sizeof( item_data_t ) ], &item, sizeof( item_data_t ) );
+    }
+  }
+
+  io::cfile file( file_name, "wb" );
+  if ( ! file )
+  {
+    error = "unable to open '" + file_name + "' for writing";
+    return false;
+  }
+
+  std::string out( header.file_size, '\0' );
+  std::memcpy( &out[ 0 ], &header, sizeof( header ) );
+  std::memcpy( &out[ sizeof( header ) ], sections.data(), sections.size() * sizeof( data_file_section_t ) );
+  for ( std::size_t i = 0; i < sections.size(); ++i )
+  {
+    if ( ! payloads[ i ].empty() )
+      std::memcpy( &out[ sections[ i ].offset ], payloads[ i ].data(), payloads[ i ].size() );
+  }
+
+  if ( std::fwrite( out.data(), 1, out.size(), file ) != out.size() )
+  {
+    error = "unable to write '" + file_name + "'";
+    return false;
+  }
+
+  return true;
+}
@@ -342,7 +342,8 @@ const gem_property_data_t& dbc_t::gem_property( unsigned gem_id ) const
 
 const item_data_t* dbc::items( bool ptr )
 {
-  ( void )ptr;
+  if ( const data_file::item_table_t* table = data_file::items( ptr ) )
+    return table -> items;
 
   const item_data_t* p = __items_noptr();
 #if SC_USE_PTR
@@ -354,7 +355,8 @@ const item_data_t* dbc::items( bool ptr )
 
 size_t dbc::n_items( bool ptr )
 {
-  ( void )ptr;
+  if ( const data_file::item_table_t* table = data_file::items( ptr ) )
+    return table -> n_items;
 
   size_t n = n_items_noptr();
 #if SC_USE_PTR
@@ -436,20 +438,32 @@ const item_armor_type_data_t& dbc_t::item_armor_inv_type( unsigned inv_type ) co
 
 /* Initialize item database
  */
+static void init_item_data_indices( item_data_t* items, bool ptr )
+{
+  // Indices are stored in the data file, no need to scan the (large) item table
+  if ( const dbc::data_file::item_table_t* table = dbc::data_file::items( ptr ) )
+  {
+    item_data_index.init( table -> items, table -> n_items, ptr );
+    potion_data_index.init( table -> items, table -> consumable_index[ 0 ], table -> n_consumables[ 0 ], ptr );
+    flask_data_index.init( table -> items, table -> consumable_index[ 1 ], table -> n_consumables[ 1 ], ptr );
+    food_data_index.init( table -> items, table -> consumable_index[ 2 ], table -> n_consumables[ 2 ], ptr );
+    return;
+  }
+
+  item_data_index.init( items, ptr );
+  potion_data_index.init( items, ptr );
+  flask_data_index.init( items, ptr );
+  food_data_index.init( items, ptr );
+}
+
 void dbc::init_item_data()
 {
   // Create id-indexes
-  item_data_index.init( __items_noptr(), false );
+  init_item_data_indices( __items_noptr(), false );
   item_enchantment_data_index.init( __spell_item_ench_data, false );
-  potion_data_index.init( __items_noptr(), false );
-  flask_data_index.init( __items_noptr(), false );
-  food_data_index.init( __items_noptr(), false );
 #if SC_USE_PTR
-  item_data_index.init( __items_ptr(), true );
+  init_item_data_indices( __items_ptr(), true );
   item_enchantment_data_index.init( __ptr_spell_item_ench_data, true );
-  potion_data_index.init( __items_ptr(), true );
-  flask_data_index.init( __items_ptr(), true );
-  food_data_index.init( __items_ptr(), true );
 #endif
 }
 
@@ -1194,7 +1208,7 @@ bool item_database::parse_item_spell_enchant( item_t& item,
       // Handle All stats enchants
       if ( es )
       {
-        for ( size_t j = 0; j < es -> _effects -> size(); j++ )
+        for ( size_t j = 0; j < es -> effect_count(); j++ )
         {
           // All stats is indicated by a misc value of -1
           if ( es -> effectN( j + 1 ).type() == E_APPLY_AURA &&
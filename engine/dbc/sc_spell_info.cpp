@@ -907,9 +907,9 @@ std::string spell_info::to_str( const dbc_t& dbc, const spell_data_t* spell, int
   school_string[ 0 ] = std::toupper( school_string[ 0 ] );
   s << "School           : " << school_string << std::endl;
 
-  for ( size_t i = 0; spell -> _power && i < spell -> _power -> size(); i++ )
+  for ( size_t i = 0; i < spell -> power_count(); i++ )
   {
-    const spellpower_data_t* pd = spell -> _power -> at( i );
+    const spellpower_data_t* pd = &( spell -> powerN( i + 1 ) );
 
     s << "Resource         : ";
     if ( pd -> type() == POWER_MANA )
@@ -1281,14 +1281,14 @@ std::string spell_info::to_str( const dbc_t& dbc, const spell_data_t* spell, int
     }
   }
 
-  if ( spell -> _driver )
+  if ( spell -> n_drivers() > 0 )
   {
     s << "Triggered by     : ";
-    for ( size_t driver_idx = 0; driver_idx < spell -> _driver -> size(); ++driver_idx )
+    for ( size_t driver_idx = 0; driver_idx < spell -> n_drivers(); ++driver_idx )
     {
-      const spell_data_t* driver = spell -> _driver -> at( driver_idx );
+      const spell_data_t* driver = spell -> driver( driver_idx );
       s << driver -> name_cstr() << " (" << driver -> id() << ")";
-      if ( driver_idx < spell -> _driver -> size() - 1 )
+      if ( driver_idx < spell -> n_drivers() - 1 )
       {
         s << ", ";
       }
@@ -1665,9 +1665,9 @@ void spell_info::to_xml( const dbc_t& dbc, const spell_data_t* spell, xml_node_t
     }
   }
 
-  for ( size_t i = 0; spell -> _power && i < spell -> _power -> size(); i++ )
+  for ( size_t i = 0; i < spell -> power_count(); i++ )
   {
-    const spellpower_data_t* pd = spell -> _power -> at( i );
+    const spellpower_data_t* pd = &( spell -> powerN( i + 1 ) );
 
     if ( pd -> cost() == 0 )
       continue;
@@ -1774,13 +1774,13 @@ void spell_info::to_xml( const dbc_t& dbc, const spell_data_t* spell, xml_node_t
   node -> add_child( "attributes" ) -> add_parm ( ".", attribs );
 
   xml_node_t* effect_node = node -> add_child( "effects" );
-  effect_node -> add_parm( "count", spell -> _effects -> size() );
+  effect_node -> add_parm( "count", spell -> effect_count() );
 
-  for ( size_t i = 0; i < spell -> _effects -> size(); i++ )
+  for ( size_t i = 0; i < spell -> effect_count(); i++ )
   {
     uint32_t effect_id;
     const spelleffect_data_t* e;
-    if ( ! ( effect_id = spell -> _effects -> at( i ) -> id() ) )
+    if ( ! ( effect_id = spell -> effectN( i + 1 ).id() ) )
       continue;
     else
       e = dbc.effect( effect_id );
@@ -1195,6 +1195,133 @@ bool download_roster( rapidjson::Document& d,
   return true;
 }
 
+// character_spec ===========================================================
+
+player_spec_t character_spec( sim_t*             sim,
+                              const std::string& region,
+                              const std::string& server,
+                              const std::string& name,
+                              const std::string& talents )
+{
+  player_spec_t player;
+
+  if ( sim -> apikey.size() == 32 && region != "cn" ) // China does not have new api endpoints yet.
+  {
+    std::string battlenet = "https://" + region + ".api.battle.net/";
+
+    player.cleanurl = battlenet + "wow/character/" +
+      server + '/' + name + "?fields=talents,items,professions&locale=en_US&apikey=";
+    player.url = player.cleanurl + sim -> apikey;
+    player.origin = battlenet + "wow/character/" + server + '/' + name + "/advanced";
+  }
+  else
+  {
+    std::string battlenet = "http://" + region + ".battle.net/";
+
+    player.url = battlenet + "api/wow/character/" +
+      server + '/' + name + "?fields=talents,items,professions&locale=en_US";
+    player.cleanurl = player.url;
+    player.origin = battlenet + "wow/en/character/" + server + '/' + name + "/advanced";
+  }
+
+  player.region = region;
+  player.server = server;
+  player.name = name;
+
+  player.talent_spec = talents;
+
+  return player;
+}
+
+// throttle =================================================================
+
+// Spaces out character requests of all import threads to at most armory_rate per second.
+void throttle( const sim_t* sim )
+{
+  static mutex_t mutex;
+  static double next_request = 0;
+
+  double rate = sim -> armory_rate;
+#ifdef SC_DEFAULT_APIKEY
+  // Requests count against the per second limit of the shared default apikey even if the
+  // character is cached, so keep well below it.
+  if ( sim -> apikey == std::string( SC_DEFAULT_APIKEY ) && ( rate <= 0 || rate > 4 ) )
+    rate = 4;
+#endif
+  if ( rate <= 0 )
+    return;
+
+  double delay;
+  {
+    auto_lock_t lock( mutex );
+    double now = util::wall_time();
+    double slot = std::max( now, next_request );
+    next_request = slot + 1.0 / rate;
+    delay = slot - now;
+  }
+
+  if ( delay > 0 )
+    sc_thread_t::sleep_seconds( delay );
+}
+
+// character_download_thread_t ==============================================
+
+// Downloads characters into the http cache, at most sim -> armory_threads at a time
+struct character_download_thread_t : public sc_thread_t
+{
+  const sim_t* sim;
+  const std::vector<player_spec_t>& players;
+  std::atomic<size_t>& next_player;
+  cache::behavior_e caching;
+
+  character_download_thread_t( const sim_t* sim, const std::vector<player_spec_t>& players,
+                               std::atomic<size_t>& next_player, cache::behavior_e caching )
+    : sim( sim ), players( players ), next_player( next_player ), caching( caching )
+  { }
+
+private:
+  void run() override
+  {
+    for ( size_t i = next_player++; i < players.size(); i = next_player++ )
+    {
+      throttle( sim );
+      std::string result;
+      http::get( result, players[ i ].url, players[ i ].cleanurl, caching );
+    }
+  }
+};
+
+void download_characters( const sim_t* sim, const std::vector<player_spec_t>& players,
+                          cache::behavior_e caching )
+{
+  std::atomic<size_t> next_player( 0 );
+  size_t n_threads = std::min( players.size(), static_cast<size_t>( std::max( 1, sim -> armory_threads ) ) );
+
+  std::vector<std::unique_ptr<character_download_thread_t> > threads;
+  for ( size_t i = 0; i < n_threads; ++i )
+  {
+    threads.push_back( std::unique_ptr<character_download_thread_t>(
+      new character_download_thread_t( sim, players, next_player, caching ) ) );
+    threads.back() -> launch();
+  }
+
+  for ( auto& thread : threads )
+    thread -> join();
+}
+
+// import_player ============================================================
+
+player_t* import_player( sim_t*            sim,
+                         player_spec_t&    player,
+                         cache::behavior_e caching )
+{
+  player_t* p = parse_player( sim, player, caching );
+  if ( !p )
+    return bcp_api::download_player_html( sim, player.region, player.server, player.name, player.talent_spec, caching );
+  else
+    return p;
+}
+
 } // close anonymous namespace ==============================================
 
 // bcp_api::download_player_html =============================================
@@ -1236,50 +1363,13 @@ player_t* bcp_api::download_player( sim_t*             sim,
 {
   sim -> current_name = name;
 
-  player_spec_t player;
-
-  if ( sim -> apikey.size() == 32 && region != "cn" ) // China does not have new api endpoints yet.
-  {
-    std::string battlenet = "https://" + region + ".api.battle.net/";
-
-    player.cleanurl = battlenet + "wow/character/" +
-      server + '/' + name + "?fields=talents,items,professions&locale=en_US&apikey=";
-    player.url = player.cleanurl + sim -> apikey;
-    player.origin = battlenet + "wow/character/" + server + '/' + name + "/advanced";
-#ifdef SC_DEFAULT_APIKEY
-  if ( sim -> apikey == std::string( SC_DEFAULT_APIKEY ) )
-  //This is needed to prevent hitting the 'per second' api call limit.
-  // If the character is cached, it still counts as a api use, even though we don't download anything.
-  // With cached characters, it's common for 30-40 calls to be made per second when downloading a guild.
-  // This is only enabled when the person is using the default apikey.
-#if defined ( SC_WINDOWS )
-    _sleep( 250 );
-#else
-    usleep( 250000 );
-#endif
-#endif
-  }
-  else
-  {
-    std::string battlenet = "http://" + region + ".battle.net/";
-
-    player.url = battlenet + "api/wow/character/" +
-      server + '/' + name + "?fields=talents,items,professions&locale=en_US";
-    player.cleanurl = player.url;
-    player.origin = battlenet + "wow/en/character/" + server + '/' + name + "/advanced";
-  }
-
-  player.region = region;
-  player.server = server;
-  player.name = name;
+  player_spec_t player = character_spec( sim, region, server, name, talents );
 
-  player.talent_spec = talents;
+  // Child sims recreate the player from the cache of the parent
+  if ( ! sim -> parent )
+    throttle( sim );
 
-  player_t* p = parse_player( sim, player, caching );
-  if ( !p )
-    return download_player_html( sim, region, server, name, talents, caching );
-  else
-    return p;
+  return import_player( sim, player, caching );
 }
 
 // bcp_api::from_local_json =================================================
@@ -1373,11 +1463,20 @@ bool bcp_api::download_guild( sim_t* sim,
 
   range::sort( names );
 
-  for (auto & cname : names)
+  std::vector<player_spec_t> players;
+  for ( auto& cname : names )
+    players.push_back( character_spec( sim, region, server, cname, "active" ) );
+
+  // Download all characters concurrently first, then create the players in order from the
+  // cached responses. Child sims recreate the players from the cache of the parent.
+  if ( ! sim -> parent && caching != cache::ONLY )
+    download_characters( sim, players, caching );
+
+  for ( auto& player : players )
   {
-    
-    std::cout << "Downloading character: " << cname << std::endl;
-    download_player( sim, region, server, cname, "active", caching );
+    std::cout << "Downloading character: " << player.name << std::endl;
+    sim -> current_name = player.name;
+    import_player( sim, player, caching );
   }
 
   return true;
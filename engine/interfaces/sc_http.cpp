@@ -5,6 +5,15 @@
 
 #include "simulationcraft.hpp"
 
+#if defined( SC_WINDOWS )
+#include <windows.h>
+#else
+#include <cerrno>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+#endif
+
 // Cross-Platform Support for HTTP-Download =================================
 
 // ==========================================================================
@@ -22,6 +31,9 @@ namespace { // UNNAMED NAMESPACE ==========================================
 const bool HTTP_CACHE_DEBUG = false;
 
 mutex_t cache_mutex;
+// Downloads run concurrently without cache_mutex. This guards one-time initialization of the
+// network libraries, and the non-reentrant host name resolver.
+mutex_t network_mutex;
 
 const unsigned int NETBUFSIZE = 1 << 15;
 
@@ -40,6 +52,281 @@ struct url_cache_entry_t
 typedef std::unordered_map<std::string, url_cache_entry_t> url_db_t;
 url_db_t url_db;
 
+// Persistent cache =========================================================
+
+// Every url is stored in its own file in the cache directory, named after a hash of the url, and
+// holding the version, url, last modified header and content of the entry. Entries are read from
+// disk on the first lookup of their url, and written to a temporary file that is renamed in place
+// as soon as they are downloaded, so that concurrent simc processes can share the cache and never
+// see a partially written entry. All of the functions below require cache_mutex to be held.
+
+// Processes that added entries to the cache evict entries older than CACHE_MAX_AGE (in seconds)
+// on exit, and the oldest entries beyond CACHE_MAX_SIZE (in bytes). The age of an entry is the time
+// of its last use: reading an entry touches its file, as access times are often not maintained.
+const double CACHE_MAX_AGE = 30 * 24 * 60 * 60;
+const uint64_t CACHE_MAX_SIZE = 256 * 1024 * 1024;
+// Temporary files younger than this (in seconds) may still be written by another process, which
+// renames them into place when done. Eviction, including cache clearing, leaves them alone.
+const double CACHE_TEMPORARY_GRACE = 10 * 60;
+
+std::string cache_directory;
+bool cache_modified = false;
+
+struct cache_file_t
+{
+  std::string name;
+  uint64_t size;
+  time_t modified;
+};
+
+#if defined( SC_WINDOWS )
+
+bool make_directory( const std::string& path )
+{
+  return CreateDirectoryW( io::widen( path ).c_str(), nullptr ) ||
+         GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+bool replace_file( const std::string& from, const std::string& to )
+{
+  return MoveFileExW( io::widen( from ).c_str(), io::widen( to ).c_str(),
+                      MOVEFILE_REPLACE_EXISTING ) != 0;
+}
+
+void remove_file( const std::string& path )
+{ DeleteFileW( io::widen( path ).c_str() ); }
+
+// Set the modification time of path to now
+void touch_file( const std::string& path )
+{
+  HANDLE file = CreateFileW( io::widen( path ).c_str(), FILE_WRITE_ATTRIBUTES,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+  if ( file == INVALID_HANDLE_VALUE )
+    return;
+
+  FILETIME now;
+  GetSystemTimeAsFileTime( &now );
+  SetFileTime( file, nullptr, nullptr, &now );
+  CloseHandle( file );
+}
+
+std::vector<cache_file_t> list_directory( const std::string& path )
+{
+  std::vector<cache_file_t> files;
+
+  WIN32_FIND_DATAW data;
+  HANDLE find = FindFirstFileW( io::widen( path + "/*" ).c_str(), &data );
+  if ( find == INVALID_HANDLE_VALUE )
+    return files;
+
+  do
+  {
+    if ( data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY )
+      continue;
+
+    // FILETIME counts 100ns intervals since 1601-01-01
+    uint64_t filetime = ( static_cast<uint64_t>( data.ftLastWriteTime.dwHighDateTime ) << 32 ) |
+                        data.ftLastWriteTime.dwLowDateTime;
+
+    cache_file_t file;
+    file.name = path + '/' + io::narrow( data.cFileName );
+    file.size = ( static_cast<uint64_t>( data.nFileSizeHigh ) << 32 ) | data.nFileSizeLow;
+    file.modified = static_cast<time_t>( filetime / 10000000 - 11644473600ULL );
+    files.push_back( file );
+  } while ( FindNextFileW( find, &data ) );
+
+  FindClose( find );
+  return files;
+}
+
+#else
+
+bool make_directory( const std::string& path )
+{ return mkdir( path.c_str(), 0755 ) == 0 || errno == EEXIST; }
+
+bool replace_file( const std::string& from, const std::string& to )
+{ return std::rename( from.c_str(), to.c_str() ) == 0; }
+
+void remove_file( const std::string& path )
+{ std::remove( path.c_str() ); }
+
+// Set the modification time of path to now
+void touch_file( const std::string& path )
+{ utime( path.c_str(), nullptr ); }
+
+std::vector<cache_file_t> list_directory( const std::string& path )
+{
+  std::vector<cache_file_t> files;
+
+  DIR* dir = opendir( path.c_str() );
+  if ( ! dir )
+    return files;
+
+  while ( const dirent* entry = readdir( dir ) )
+  {
+    struct stat info;
+    cache_file_t file;
+    file.name = path + '/' + entry -> d_name;
+    if ( stat( file.name.c_str(), &info ) != 0 || ! S_ISREG( info.st_mode ) )
+      continue;
+
+    file.size = info.st_size;
+    file.modified = info.st_mtime;
+    files.push_back( file );
+  }
+
+  closedir( dir );
+  return files;
+}
+
+#endif
+
+std::string read_string( std::istream& is )
+{
+  std::string result;
+  while ( is )
+  {
+    unsigned char c = is.get();
+    if ( ! c )
+      break;
+    result += c;
+  }
+  return result;
+}
+
+void write_string( std::ostream& os, const std::string& s )
+{ os.write( s.c_str(), s.size() + 1 ); }
+
+std::string cache_file_name( const std::string& url )
+{
+  // 64-bit FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  for ( unsigned char c : url )
+  {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+
+  char buf[ 17 ];
+  snprintf( buf, sizeof( buf ), "%016llx", static_cast<unsigned long long>( hash ) );
+  return cache_directory + '/' + buf;
+}
+
+// Read a cache file written by the current version of simc, returning its url and entry
+bool cache_read_file( const std::string& file_name, std::string& url, url_cache_entry_t& entry )
+{
+  try
+  {
+    io::ifstream file;
+    file.open( file_name, std::ios::binary );
+    if ( ! file ) return false;
+    file.exceptions( std::ios::eofbit | std::ios::failbit | std::ios::badbit );
+    file.unsetf( std::ios::skipws );
+
+    if ( read_string( file ) != SC_VERSION )
+      return false;
+
+    url = read_string( file );
+    entry.last_modified_header = read_string( file );
+
+    uint32_t size;
+    file.read( reinterpret_cast<char*>( &size ), sizeof( size ) );
+    entry.result.resize( size );
+    if ( size )
+      file.read( &entry.result[ 0 ], size );
+
+    entry.modified = entry.validated = cache::IN_THE_BEGINNING;
+    return true;
+  }
+  catch ( ... )
+  {
+    return false;
+  }
+}
+
+// Look up the entry of url on disk, leaving entry invalid if there is none
+void cache_read( const std::string& url, url_cache_entry_t& entry )
+{
+  if ( cache_directory.empty() )
+    return;
+
+  std::string file_name = cache_file_name( url );
+  std::string file_url;
+  url_cache_entry_t file_entry;
+  if ( cache_read_file( file_name, file_url, file_entry ) && file_url == url )
+  {
+    entry = file_entry;
+    // Entries in use are kept by cache_evict()
+    touch_file( file_name );
+  }
+}
+
+void cache_write( const std::string& url, const url_cache_entry_t& entry )
+{
+  if ( cache_directory.empty() )
+    return;
+
+  static std::random_device seed;
+  static std::mt19937_64 rng( seed() ^ static_cast<uint64_t>( time( nullptr ) ) );
+  char suffix[ 32 ];
+  snprintf( suffix, sizeof( suffix ), ".tmp%016llx", static_cast<unsigned long long>( rng() ) );
+
+  std::string file_name = cache_file_name( url );
+  std::string temporary_name = file_name + suffix;
+
+  try
+  {
+    io::ofstream file;
+    file.open( temporary_name, std::ios::binary );
+    if ( ! file ) return;
+    file.exceptions( std::ios::eofbit | std::ios::failbit | std::ios::badbit );
+
+    write_string( file, SC_VERSION );
+    write_string( file, url );
+    write_string( file, entry.last_modified_header );
+
+    uint32_t size = as<uint32_t>( entry.result.size() );
+    file.write( reinterpret_cast<const char*>( &size ), sizeof( size ) );
+    file.write( entry.result.data(), size );
+    file.close();
+  }
+  catch ( ... )
+  {
+    remove_file( temporary_name );
+    return;
+  }
+
+  if ( replace_file( temporary_name, file_name ) )
+    cache_modified = true;
+  else
+    remove_file( temporary_name );
+}
+
+// Remove the files of the cache directory not written or read in max_age seconds, and the least
+// recently used files beyond max_size bytes. Recent temporary files of entries being written are
+// kept, stale ones (left behind by a process that exited while writing) are removed.
+void cache_evict( double max_age, uint64_t max_size )
+{
+  std::vector<cache_file_t> files = list_directory( cache_directory );
+  std::sort( files.begin(), files.end(), []( const cache_file_t& l, const cache_file_t& r ) {
+    return l.modified > r.modified;
+  } );
+
+  time_t now = time( nullptr );
+  uint64_t size = 0;
+  for ( const cache_file_t& file : files )
+  {
+    if ( file.name.find( ".tmp", cache_directory.size() ) != std::string::npos &&
+         difftime( now, file.modified ) <= CACHE_TEMPORARY_GRACE )
+      continue;
+
+    size += file.size;
+    if ( size > max_size || difftime( now, file.modified ) > max_age )
+      remove_file( file.name );
+  }
+}
+
 // cache_clear ==============================================================
 
 void cache_clear()
@@ -47,6 +334,8 @@ void cache_clear()
   // writer lock
   auto_lock_t lock( cache_mutex );
   url_db.clear();
+  if ( ! cache_directory.empty() )
+    cache_evict( -1, 0 );
 }
 
 const char* const cookies =
@@ -88,8 +377,6 @@ bool download( url_cache_entry_t&,
 bool download( url_cache_entry_t& entry,
                       const std::string& url )
 {
-  // Requires cache_mutex to be held.
-
   class InetWrapper : private noncopyable
   {
   public:
@@ -101,12 +388,15 @@ bool download( url_cache_entry_t& entry,
   };
 
   static HINTERNET hINet;
-  if ( !hINet )
   {
-    // hINet = InternetOpen( L"simulationcraft", INTERNET_OPEN_TYPE_PROXY, "proxy-server", NULL, 0 );
-    hINet = InternetOpenW( L"simulationcraft", INTERNET_OPEN_TYPE_PRECONFIG, NULL, NULL, 0 );
-    if ( ! hINet )
-      return false;
+    auto_lock_t lock( network_mutex );
+    if ( !hINet )
+    {
+      // hINet = InternetOpen( L"simulationcraft", INTERNET_OPEN_TYPE_PROXY, "proxy-server", NULL, 0 );
+      hINet = InternetOpenW( L"simulationcraft", INTERNET_OPEN_TYPE_PRECONFIG, NULL, NULL, 0 );
+      if ( ! hINet )
+        return false;
+    }
   }
 
   std::wstring headers = io::widen( cookies );
@@ -212,28 +502,33 @@ struct SocketWrapper
 
 int SocketWrapper::connect( const std::string& host, unsigned short port )
 {
-  struct hostent* h;
   sockaddr_in a;
 
   a.sin_family = AF_INET;
 
-  if ( proxy.type == "http" || proxy.type == "https" )
   {
-    h = gethostbyname( proxy.host.c_str() );
-    a.sin_port = htons( proxy.port );
-  }
-  else
-  {
-    h = gethostbyname( host.c_str() );
-    a.sin_port = htons( port );
+    // gethostbyname returns static data
+    auto_lock_t lock( network_mutex );
+
+    struct hostent* h;
+    if ( proxy.type == "http" || proxy.type == "https" )
+    {
+      h = gethostbyname( proxy.host.c_str() );
+      a.sin_port = htons( proxy.port );
+    }
+    else
+    {
+      h = gethostbyname( host.c_str() );
+      a.sin_port = htons( port );
+    }
+    if ( ! h ) return -1;
+
+    std::memcpy( &a.sin_addr, h -> h_addr_list[ 0 ], sizeof( a.sin_addr ) );
   }
-  if ( ! h ) return -1;
 
   if ( ( fd = ::socket( PF_INET, SOCK_STREAM, IPPROTO_TCP ) ) < 0 )
     return -1;
 
-  std::memcpy( &a.sin_addr, h -> h_addr_list[ 0 ], sizeof( a.sin_addr ) );
-
   return ::connect( fd, reinterpret_cast<const sockaddr*>( &a ), sizeof( a ) );
 }
 
@@ -605,17 +900,23 @@ bool download( url_cache_entry_t& entry,
 #if defined( SC_MINGW )
 
   static bool initialized = false;
-  if ( ! initialized )
   {
-    WSADATA wsa_data;
-    WSAStartup( MAKEWORD( 2, 2 ), &wsa_data );
-    initialized = true;
+    auto_lock_t lock( network_mutex );
+    if ( ! initialized )
+    {
+      WSADATA wsa_data;
+      WSAStartup( MAKEWORD( 2, 2 ), &wsa_data );
+      initialized = true;
+    }
   }
 
 #endif
 
 #if defined( SC_USE_OPENSSL )
-  SSLWrapper::init();
+  {
+    auto_lock_t lock( network_mutex );
+    SSLWrapper::init();
+  }
 #endif
 
   std::string current_url = url;
@@ -772,100 +1073,28 @@ bool http::clear_cache( sim_t* sim,
   return true;
 }
 
-// http::cache_load =========================================================
+// http::cache_open =========================================================
 
-namespace cache {
-std::string get( std::istream& is )
-{
-  std::string result;
-  while ( is )
-  {
-    unsigned char c = is.get();
-    if ( ! c )
-      break;
-    result += c;
-  }
-  return result;
-}
-
-void put( std::ostream& os, const std::string& s )
-{ os.write( s.c_str(), s.size() + 1 ); }
-
-void put( std::ostream& os, const char* s )
-{ os.write( s, std::strlen( s ) + 1 ); }
-}
-
-void http::cache_load( const std::string& file_name )
+void http::cache_open( const std::string& directory )
 {
   auto_lock_t lock( cache_mutex );
 
-  try
-  {
-    io::ifstream file;
-    file.open( file_name, std::ios::binary );
-    if ( !file ) return;
-    file.exceptions( std::ios::eofbit | std::ios::failbit | std::ios::badbit );
-    file.unsetf( std::ios::skipws );
-
-    if ( cache::get( file ) != SC_VERSION )
-    {
-      // invalid version, GTFO
-      return;
-    }
-
-    std::string content;
-    content.reserve( 16 * 1024 );
-
-    while ( ! file.eof() )
-    {
-      std::string url = cache::get( file );
-      std::string last_modified = cache::get( file );
-
-      uint32_t size;
-      file.read( reinterpret_cast<char*>( &size ), sizeof( size ) );
-      content.resize( size );
-      file.read( &content[ 0 ], size );
-
-      url_cache_entry_t& c = url_db[ url ];
-      c.result = content;
-      c.last_modified_header = last_modified;
-      c.modified = c.validated = cache::IN_THE_BEGINNING;
-    }
-  }
-  catch ( ... )
-  {}
+  cache_directory.clear();
+  if ( make_directory( directory ) )
+    cache_directory = directory;
 }
 
-// http::cache_save =========================================================
+// http::cache_close ========================================================
 
-void http::cache_save( const std::string& file_name )
+void http::cache_close()
 {
   auto_lock_t lock( cache_mutex );
 
-  try
-  {
-    io::ofstream file;
-    file.open( file_name, std::ios::binary );
-    if ( ! file ) return;
-    file.exceptions( std::ios::eofbit | std::ios::failbit | std::ios::badbit );
-
-    cache::put( file, SC_VERSION );
-
-    for ( url_db_t::const_iterator p = url_db.begin(), e = url_db.end(); p != e; ++p )
-    {
-      if ( p -> second.validated == cache::INVALID_ERA )
-        continue;
-
-      cache::put( file, p -> first );
-      cache::put( file, p -> second.last_modified_header );
+  if ( ! cache_directory.empty() && cache_modified )
+    cache_evict( CACHE_MAX_AGE, CACHE_MAX_SIZE );
 
-      uint32_t size = as<uint32_t>( p -> second.result.size() );
-      file.write( reinterpret_cast<const char*>( &size ), sizeof( size ) );
-      file.write( p -> second.result.data(), size );
-    }
-  }
-  catch ( ... )
-  {}
+  cache_directory.clear();
+  cache_modified = false;
 }
 
 // http::get ================================================================
@@ -883,63 +1112,84 @@ bool http::get( std::string&       result,
   util::urlencode( encoded_url );
   util::urlencode( encoded_clean_url );
 
-  auto_lock_t lock( cache_mutex );
-
-  url_cache_entry_t& entry = url_db[ encoded_clean_url ];
-
-  if ( HTTP_CACHE_DEBUG )
+  // Work on a copy of the cache entry, so that the cache is not locked during the download
+  url_cache_entry_t entry;
   {
-    io::ofstream http_log;
-    http_log.open( "simc_http_log.txt", std::ios::app );
-    std::ostream::sentry s( http_log );
-    if ( s )
+    auto_lock_t lock( cache_mutex );
+
+    url_db_t::iterator it = url_db.find( encoded_clean_url );
+    if ( it == url_db.end() )
     {
-      http_log << cache::era() << ": get(\"" << cleanurl << "\") [";
+      it = url_db.insert( std::make_pair( encoded_clean_url, url_cache_entry_t() ) ).first;
+      cache_read( encoded_clean_url, it -> second );
+    }
+    const url_cache_entry_t& cached = it -> second;
 
-      if ( entry.validated != cache::INVALID_ERA )
+    if ( HTTP_CACHE_DEBUG )
+    {
+      io::ofstream http_log;
+      http_log.open( "simc_http_log.txt", std::ios::app );
+      std::ostream::sentry s( http_log );
+      if ( s )
       {
-        if ( entry.validated >= cache::era() )
-          http_log << "hot";
-        else if ( caching != cache::CURRENT )
-          http_log << "warm";
+        http_log << cache::era() << ": get(\"" << cleanurl << "\") [";
+
+        if ( cached.validated != cache::INVALID_ERA )
+        {
+          if ( cached.validated >= cache::era() )
+            http_log << "hot";
+          else if ( caching != cache::CURRENT )
+            http_log << "warm";
+          else
+            http_log << "cold";
+          http_log << ": (" << cached.modified << ", " << cached.validated << ')';
+        }
         else
-          http_log << "cold";
-        http_log << ": (" << entry.modified << ", " << entry.validated << ')';
+          http_log << "miss";
+        if ( caching != cache::ONLY &&
+             ( cached.validated == cache::INVALID_ERA ||
+               ( caching == cache::CURRENT && cached.validated < cache::era() ) ) )
+          http_log << " download";
+        http_log << "]\n";
       }
-      else
-        http_log << "miss";
-      if ( caching != cache::ONLY &&
-           ( entry.validated == cache::INVALID_ERA ||
-             ( caching == cache::CURRENT && entry.validated < cache::era() ) ) )
-        http_log << " download";
-      http_log << "]\n";
     }
-  }
 
-  if ( entry.validated < cache::era() && ( caching == cache::CURRENT || entry.validated == cache::INVALID_ERA ) )
-  {
+    if ( ! ( cached.validated < cache::era() && ( caching == cache::CURRENT || cached.validated == cache::INVALID_ERA ) ) )
+    {
+      result = cached.result;
+      return true;
+    }
+
     if ( caching == cache::ONLY )
       return false;
 
-    util::printf( "@" ); fflush( stdout );
+    entry = cached;
+  }
 
-    if ( ! download( entry, encoded_url ) )
-      return false;
+  util::printf( "@" ); fflush( stdout );
 
-    if ( HTTP_CACHE_DEBUG && entry.modified < entry.validated )
-    {
-      io::ofstream http_log;
-      http_log.open( "simc_http_log.txt", std::ios::app );
-      http_log << cache::era() << ": Unmodified (" << entry.modified << ", " << entry.validated << ")\n";
-    }
+  if ( ! download( entry, encoded_url ) )
+    return false;
 
-    if ( confirmation.size() && ( entry.result.find( confirmation ) == std::string::npos ) )
-    {
-      //util::printf( "\nsimulationcraft: HTTP failed on '%s'\n", url.c_str() );
-      //util::printf( "%s\n", ( result.empty() ? "empty" : result.c_str() ) );
-      //fflush( stdout );
-      return false;
-    }
+  {
+    auto_lock_t lock( cache_mutex );
+    url_db[ encoded_clean_url ] = entry;
+    cache_write( encoded_clean_url, entry );
+  }
+
+  if ( HTTP_CACHE_DEBUG && entry.modified < entry.validated )
+  {
+    io::ofstream http_log;
+    http_log.open( "simc_http_log.txt", std::ios::app );
+    http_log << cache::era() << ": Unmodified (" << entry.modified << ", " << entry.validated << ")\n";
+  }
+
+  if ( confirmation.size() && ( entry.result.find( confirmation ) == std::string::npos ) )
+  {
+    //util::printf( "\nsimulationcraft: HTTP failed on '%s'\n", url.c_str() );
+    //util::printf( "%s\n", ( result.empty() ? "empty" : result.c_str() ) );
+    //fflush( stdout );
+    return false;
   }
 
   result = entry.result;
@@ -961,14 +1211,17 @@ int main( int argc, char* argv[] )
     {
       if ( !strcmp( argv[ i ], "--dump" ) )
       {
-        url_db.clear();
-        const char* const url_cache_file = "simc_cache.dat";
-        http::cache_load( url_cache_file );
+        http::cache_open( "simc_cache" );
 
-        for ( auto& i : url_db )
+        for ( const cache_file_t& file : list_directory( cache_directory ) )
         {
-          std::cout << "URL: \"" << i.first << "\" (" << i.second.last_modified_header << ")\n"
-                    << i.second.result << '\n';
+          std::string url;
+          url_cache_entry_t entry;
+          if ( cache_read_file( file.name, url, entry ) )
+          {
+            std::cout << "URL: \"" << url << "\" (" << entry.last_modified_header << ")\n"
+                      << entry.result << '\n';
+          }
         }
       }
       else
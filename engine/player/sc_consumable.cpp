@@ -656,13 +656,13 @@ struct food_t : public dbc_consumable_base_t
 
     // Figure out base food buff (the spell you cast from the food item)
     const spell_data_t* driver = dbc_consumable_base_t::driver();
-    if ( driver -> id() == 0 || ! driver -> _effects )
+    if ( driver -> id() == 0 || ! driver -> effect_list() )
     {
       return driver;
     }
 
     // Find the "Well Fed" buff from the base food
-    for ( const auto& effect : *driver -> _effects )
+    for ( const auto& effect : *driver -> effect_list() )
     {
       if ( ! effect )
       {
@@ -637,7 +637,7 @@ bool item_t::parse_options()
     option_name_str = options_str.substr( 0, cut_pt );
   }
 
-  std::vector<std::unique_ptr<option_t>> options;
+  option_registry_t options;
   options.push_back(opt_uint("id", parsed.data.id));
   options.push_back(opt_int("upgrade", parsed.upgrade_level));
   options.push_back(opt_string("stats", option_stats_str));
@@ -770,9 +770,27 @@ bool item_t::initialize_data()
 
   if ( parsed.data.id > 0 )
   {
-    if ( ! item_t::download_item( *this ) &&
-         option_stats_str.empty() && option_weapon_str.empty() )
-      return false;
+    if ( initialize_data_from_parent() )
+      return true;
+
+    if ( ! item_t::download_item( *this ) )
+    {
+      if ( option_stats_str.empty() && option_weapon_str.empty() )
+        return false;
+    }
+    // Special effects created during download are owned by this item, so such items cannot be
+    // shared
+    else if ( parsed.special_effects.empty() )
+    {
+      std::shared_ptr<source_data_t> data( new source_data_t() );
+      data -> parsed = parsed;
+      data -> xml = xml;
+      data -> name_str = name_str;
+      data -> icon_str = icon_str;
+      data -> source_str = source_str;
+      data -> parsed.data.name = data -> name_str.c_str();
+      source_data = data;
+    }
   }
   else
     name_str = option_name_str;
@@ -780,6 +798,39 @@ bool item_t::initialize_data()
   return true;
 }
 
+// item_t::initialize_data_from_parent ======================================
+
+// Child sims re-create all actors from the same options as the parent sim. Instead of downloading
+// (or loading from client data and applying item bonuses to) the same item again in each child,
+// use the source data of the identically specified item of the parent sim's actor. This saves the
+// work of producing the data, not its memory: the parsed data is copied into each child's item,
+// only the xml tree is shared.
+bool item_t::initialize_data_from_parent()
+{
+  if ( ! sim -> parent || slot == SLOT_INVALID )
+    return false;
+
+  const player_t* parent_player = sim -> parent -> find_player( player -> name() );
+  if ( ! parent_player || static_cast<size_t>( slot ) >= parent_player -> items.size() )
+    return false;
+
+  const item_t& parent_item = parent_player -> items[ slot ];
+  if ( ! parent_item.source_data || parent_item.options_str != options_str ||
+       parent_item.is_ptr != is_ptr )
+    return false;
+
+  const source_data_t& data = *parent_item.source_data;
+  parsed = data.parsed;
+  xml = data.xml;
+  name_str = data.name_str;
+  icon_str = data.icon_str;
+  source_str = data.source_str;
+  parsed.data.name = name_str.c_str();
+  source_data = parent_item.source_data;
+
+  return true;
+}
+
 // item_t::encoded_item =====================================================
 
 void item_t::encoded_item( xml_writer_t& writer )
@@ -2083,17 +2134,21 @@ bool item_t::init_special_effects()
 {
   special_effect_t proxy_effect( this );
 
-  // Enchant
-  const item_enchantment_data_t& enchant_data = player -> dbc.item_enchantment( parsed.enchant_id );
-  if ( ! enchant::initialize_item_enchant( *this, parsed.enchant_stats,
-        SPECIAL_EFFECT_SOURCE_ENCHANT, enchant_data ) )
-    return false;
+  {
+    init_phase_monitor_t monitor( sim, INIT_PHASE_ENCHANTS );
 
-  // Addon (tinker)
-  const item_enchantment_data_t& addon_data = player -> dbc.item_enchantment( parsed.addon_id );
-  if ( ! enchant::initialize_item_enchant( *this, parsed.addon_stats,
-        SPECIAL_EFFECT_SOURCE_ADDON, addon_data ) )
-    return false;
+    // Enchant
+    const item_enchantment_data_t& enchant_data = player -> dbc.item_enchantment( parsed.enchant_id );
+    if ( ! enchant::initialize_item_enchant( *this, parsed.enchant_stats,
+          SPECIAL_EFFECT_SOURCE_ENCHANT, enchant_data ) )
+      return false;
+
+    // Addon (tinker)
+    const item_enchantment_data_t& addon_data = player -> dbc.item_enchantment( parsed.addon_id );
+    if ( ! enchant::initialize_item_enchant( *this, parsed.addon_stats,
+          SPECIAL_EFFECT_SOURCE_ADDON, addon_data ) )
+      return false;
+  }
 
   // On-use effects
   for ( size_t i = 0, end = sizeof_array( parsed.data.id_spell ); i < end; ++i )
@@ -307,3 +307,71 @@ double pet_t::composite_spell_power( school_e school ) const
     sp += owner -> cache.spell_power( school ) * owner -> composite_spell_power_multiplier() * owner_coeff.sp_from_sp;
   return sp;
 }
+
+// ==========================================================================
+// Pet Pool
+// ==========================================================================
+
+// pet_pool_t::create =======================================================
+
+void pet_pool_t::create( size_t capacity, const factory_t& factory, bool quiet )
+{
+  pets.reserve( pets.size() + capacity );
+
+  for ( size_t i = 0; i < capacity; i++ )
+  {
+    pet_t* pet = factory();
+    if ( quiet && ! pets.empty() )
+      pet -> quiet = true;
+
+    pets.push_back( pet );
+  }
+}
+
+// pet_pool_t::acquire ======================================================
+
+pet_t* pet_pool_t::acquire() const
+{
+  for ( size_t i = 0, end = pets.size(); i < end; i++ )
+  {
+    if ( pets[ i ] -> is_sleeping() )
+      return pets[ i ];
+  }
+
+  return nullptr;
+}
+
+// pet_pool_t::spawn ========================================================
+
+pet_t* pet_pool_t::spawn( timespan_t duration )
+{
+  pet_t* pet = acquire();
+  if ( pet )
+    pet -> summon( duration );
+
+  return pet;
+}
+
+// pet_pool_t::shared_stats =================================================
+
+stats_t* pet_pool_t::shared_stats( const pet_t* pet, stats_t* own ) const
+{
+  if ( pets.empty() || pet == pets.front() || pet -> sim -> report_pets_separately )
+    return own;
+
+  return pets.front() -> get_stats( own -> name_str );
+}
+
+// pet_pool_t::n_active =====================================================
+
+size_t pet_pool_t::n_active() const
+{
+  size_t n = 0;
+  for ( size_t i = 0, end = pets.size(); i < end; i++ )
+  {
+    if ( ! pets[ i ] -> is_sleeping() )
+      n++;
+  }
+
+  return n;
+}
@@ -643,7 +643,7 @@ player_t::player_t( sim_t*             s,
   active_during_iteration( false ),
   _mastery( spelleffect_data_t::nil() ),
   cache( this ),
-  regen_type( REGEN_STATIC ),
+  regen_type( REGEN_DYNAMIC ),
   last_regen( timespan_t::zero() ),
   regen_caches( CACHE_MAX ),
   dynamic_regen_pets( false ),
@@ -662,6 +662,11 @@ player_t::player_t( sim_t*             s,
   base.mastery = 8.0;
   base.movement_direction = MOVEMENT_NONE;
 
+  // Base energy and focus regeneration scales with haste, mana regeneration with spirit
+  regen_caches[ CACHE_HASTE ] = true;
+  regen_caches[ CACHE_ATTACK_HASTE ] = true;
+  regen_caches[ CACHE_SPIRIT ] = true;
+
   if ( !is_enemy() && type != HEALING_ENEMY )
   {
     if ( sim -> debug ) sim -> out_debug.printf( "Creating Player %s", name() );
@@ -2453,7 +2458,7 @@ void player_t::init_assessors()
   // Logging and debug .. Technically, this should probably be in action_t::assess_damage, but we
   // don't need this piece of code for the vast majority of sims, so it makes sense to yank it out
   // completely from there, and only conditionally include it if logging/debugging is enabled.
-  if ( sim -> log || sim -> debug || sim -> debug_seed.size() > 0 )
+  if ( sim -> log || sim -> debug || sim -> debug_seed.size() > 0 || sim -> trace )
   {
     assessor_out_damage.add( assessor::LOG, [ this ]( dmg_e type, action_state_t* state )
     {
@@ -2483,6 +2488,19 @@ void player_t::init_assessors()
                          util::result_type_string( state -> result ) );
         }
       }
+
+      if ( sim -> trace )
+      {
+        if ( type == DMG_DIRECT )
+        {
+          sim -> trace -> damage( state, -1, 0 );
+        }
+        else // DMG_OVER_TIME
+        {
+          dot_t* dot = state -> action -> get_dot( state -> target );
+          sim -> trace -> damage( state, dot -> current_tick, dot -> num_ticks );
+        }
+      }
       return assessor::CONTINUE;
     } );
   }
@@ -2518,7 +2536,7 @@ void player_t::init_assessors()
     proc_types pt = state -> proc_type();
     proc_types2 pt2 = state -> impact_proc_type2();
     if ( pt != PROC1_INVALID && pt2 != PROC2_INVALID )
-      action_callback_t::trigger( callbacks.procs[ pt ][ pt2 ], state -> action, state );
+      callbacks.trigger( pt, pt2, state -> action, state );
 
     return assessor::CONTINUE;
   } );
@@ -4054,6 +4072,12 @@ void player_t::merge( player_t& other )
 {
   collected_data.merge( other.collected_data );
 
+  callbacks.n_invoked += other.callbacks.n_invoked;
+  callbacks.n_skipped += other.callbacks.n_skipped;
+
+  state_pool.n_allocated += other.state_pool.n_allocated;
+  state_pool.n_steady_allocated += other.state_pool.n_steady_allocated;
+
   for ( resource_e i = RESOURCE_NONE; i < RESOURCE_MAX; ++i )
   {
     iteration_resource_lost  [ i ] += other.iteration_resource_lost  [ i ];
@@ -4725,6 +4749,9 @@ void player_t::regen( timespan_t periodicity )
 
 void player_t::collect_resource_timeline_information()
 {
+  if ( regen_type == REGEN_DYNAMIC )
+    do_dynamic_regen();
+
   for (auto & elem : collected_data.resource_timelines)
   {
     elem.timeline.add( sim -> current_time(),
@@ -4770,6 +4797,9 @@ double player_t::resource_loss( resource_e resource_type,
   if ( current.sleeping )
     return 0.0;
 
+  if ( regen_type == REGEN_DYNAMIC && resource_type == primary_resource() )
+    do_dynamic_regen();
+
   if ( resource_type == primary_resource() )
     uptimes.primary_resource_cap -> update( false, sim -> current_time() );
 
@@ -4821,6 +4851,10 @@ double player_t::resource_gain( resource_e resource_type,
   if ( current.sleeping || amount == 0.0 )
     return 0.0;
 
+  // Regeneration up to now happened before this gain, and may have capped the resource
+  if ( regen_type == REGEN_DYNAMIC && resource_type == primary_resource() )
+    do_dynamic_regen();
+
   double actual_amount = std::min( amount, resources.max[ resource_type ] - resources.current[ resource_type ] );
 
   if ( actual_amount > 0.0 )
@@ -4846,6 +4880,14 @@ double player_t::resource_gain( resource_e resource_type,
                    resources.current[ resource_type ], resources.max[ resource_type ] );
   }
 
+  if ( sim -> trace )
+  {
+    sim -> trace -> resource_gain( this, resource_type,
+                                   source ? source -> name() : action ? action -> name() : "unknown",
+                                   actual_amount, amount,
+                                   resources.current[ resource_type ], resources.max[ resource_type ] );
+  }
+
   return actual_amount;
 }
 
@@ -5665,7 +5707,7 @@ void player_t::do_damage( action_state_t* incoming_state )
     // On damage/heal in. Proc flags are arranged as such that the "incoming"
     // version of the primary proc flag is always follows the outgoing version.
     if ( pt != PROC1_INVALID && pt2 != PROC2_INVALID )
-      action_callback_t::trigger( callbacks.procs[pt + 1][pt2], incoming_state -> action, incoming_state );
+      callbacks.trigger( static_cast<proc_types>( pt + 1 ), pt2, incoming_state -> action, incoming_state );
   }
 
   // Check if target is dying
@@ -9222,6 +9264,13 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
 
     resource_expr_t( const std::string& n, player_t& p, resource_e r ) :
       player_expr_t( n, p ), rt( r ) {}
+
+    // Bring regenerating resources up to the current time before reading them
+    void regenerate()
+    {
+      if ( player.regen_type == REGEN_DYNAMIC )
+        player.do_dynamic_regen();
+    }
   };
 
   std::vector<std::string> splits = util::string_split( name_str, "." );
@@ -9233,7 +9282,19 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
     return 0;
 
   if ( splits.size() == 1 )
-    return make_ref_expr( name_str, resources.current[ r ] );
+  {
+    struct resource_current_expr_t : public resource_expr_t
+    {
+      resource_current_expr_t( const std::string& n, player_t& p, resource_e r ) :
+        resource_expr_t( n, p, r ) {}
+      virtual double evaluate() override
+      {
+        regenerate();
+        return player.resources.current[ rt ];
+      }
+    };
+    return new resource_current_expr_t( name_str, *this, r );
+  }
 
   if ( splits.size() == 2 )
   {
@@ -9244,7 +9305,10 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
         resource_deficit_expr_t( const std::string& n, player_t& p, resource_e r ) :
           resource_expr_t( n, p, r ) {}
         virtual double evaluate() override
-        { return player.resources.max[ rt ] - player.resources.current[ rt ]; }
+        {
+          regenerate();
+          return player.resources.max[ rt ] - player.resources.current[ rt ];
+        }
       };
       return new resource_deficit_expr_t( name_str, *this, r );
     }
@@ -9262,7 +9326,10 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
           resource_pct_expr_t( const std::string& n, player_t& p, resource_e r  ) :
             resource_expr_t( n, p, r ) {}
           virtual double evaluate() override
-          { return player.resources.pct( rt ) * 100.0; }
+          {
+            regenerate();
+            return player.resources.pct( rt ) * 100.0;
+          }
         };
         return new resource_pct_expr_t( name_str, *this, r  );
       }
@@ -9324,6 +9391,7 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
           }
           virtual double evaluate() override
           {
+            regenerate();
             return ( player.resources.max[RESOURCE_ENERGY] -
               player.resources.current[RESOURCE_ENERGY] ) /
               player.energy_regen_per_second();
@@ -9341,6 +9409,7 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
           }
           virtual double evaluate() override
           {
+            regenerate();
             return ( player.resources.max[RESOURCE_FOCUS] -
               player.resources.current[RESOURCE_FOCUS] ) /
               player.focus_regen_per_second();
@@ -9358,6 +9427,7 @@ expr_t* player_t::create_resource_expression( const std::string& name_str )
           }
           virtual double evaluate() override
           {
+            regenerate();
             return ( player.resources.max[RESOURCE_MANA] -
               player.resources.current[RESOURCE_MANA] ) /
               player.mana_regen_per_second();
@@ -10732,6 +10802,7 @@ player_collected_data_t::player_collected_data_t( const std::string& player_name
   stat_timelines(),
   health_changes(),
   health_changes_tmi(),
+  tmi_window_buffer(),
   buffed_stats_snapshot()
 { }
 
@@ -10898,60 +10969,28 @@ void player_collected_data_t::print_tmi_debug_csv( const sc_timeline_t* nma, con
   }
 }
 
-double player_collected_data_t::calculate_max_spike_damage( const health_changes_timeline_t& tl, int window )
-{
-  double max_spike = 0;
-
-  // declare sliding average timeline
-  sc_timeline_t sliding_average_tl;
-
-  // create sliding average timelines from data
-  tl.timeline_normalized.build_sliding_average_timeline( sliding_average_tl, window );
-
-  // pull the data out of the normalized sliding average timeline
-  std::vector<double> weighted_value = sliding_average_tl.data();
-
-  // extract the max spike size from the sliding average timeline
-  max_spike = *std::max_element( weighted_value.begin(), weighted_value.end() ); // todo: remove weighted_value here
-  max_spike *= window;
-
-  return max_spike;
-}
-
-double player_collected_data_t::calculate_tmi( const health_changes_timeline_t& tl, int window, double f_length, const player_t& p )
+double player_collected_data_t::calculate_tmi( const health_changes_timeline_t& tl, int window, double f_length,
+                                               const player_t& p, double* max_spike )
 {
   // The Theck-Meloree Index is a metric that attempts to quantize the smoothness of damage intake.
   // It performs an exponentially-weighted sum of the moving average of damage intake, with larger
   // damage spikes being weighted more heavily. A formal definition of the metric can be found here:
   // http://www.sacredduty.net/theck-meloree-index-standard-reference-document/
 
-  // accumulator
-  double tmi = 0;
-
-  // declare sliding average timeline
-  sc_timeline_t sliding_average_tl;
-
-  // create sliding average timelines from data
-  tl.timeline_normalized.build_sliding_average_timeline( sliding_average_tl, window );
-
-  // pull the data out of the normalized sliding average timeline
-  std::vector<double> weighted_value = sliding_average_tl.data();
-
   // define constants
   double D = 10; // filtering strength
   double c2 = 450; // N_0, default fight length for normalization
   double c1 = 100000 / D; // health scale factor, determines slope of plot
 
-  for (auto & elem : weighted_value)
-  {
-    // weighted_value is the moving average (i.e. 1-second), so multiply by window size to get damage in "window" seconds
-    elem *= window;
-
-    // calculate exponentially-weighted contribution of this data point using filter strength D
-    elem = std::exp( D * elem );
+  // Sum the exponentially-weighted contributions (using filter strength D) of the moving average
+  // (i.e. 1-second), multiplied by window size to get damage in "window" seconds. The maximum of
+  // the same values is the maximum spike damage.
+  double max_value = 0;
+  double tmi = sliding_window_exp_sum( tl.timeline_normalized.data(), window, D, max_value, tmi_window_buffer );
 
-    // add to the TMI total; strictly speaking this should be moved outside the for loop and turned into a sort() followed by a sum for numerical accuracy
-    tmi += elem;
+  if ( max_spike )
+  {
+    *max_spike = max_value;
   }
 
   // multiply by vertical offset factor c2
@@ -10966,7 +11005,11 @@ double player_collected_data_t::calculate_tmi( const health_changes_timeline_t&
 
   // if an output file has been defined, write to it
   if ( ! p.tmi_debug_file_str.empty() )
-    print_tmi_debug_csv( &sliding_average_tl, weighted_value, p );
+  {
+    sc_timeline_t sliding_average_tl;
+    tl.timeline_normalized.build_sliding_average_timeline( sliding_average_tl, window );
+    print_tmi_debug_csv( &sliding_average_tl, tmi_window_buffer, p );
+  }
 
   return tmi;
 }
@@ -11060,15 +11103,13 @@ void player_collected_data_t::collect_data( const player_t& p )
         // define constants and variables
         int window = (int) std::floor( p.tmi_window / health_changes_tmi.get_bin_size() + 0.5 ); // window size, bin time replaces 1 eventually
 
-        // Standard TMI uses health_changes_tmi, ignoring externals - use health_changes_tmi
-        tmi = calculate_tmi( health_changes_tmi, window, f_length, p );
+        // Standard TMI uses health_changes_tmi, ignoring externals - use health_changes_tmi. Max
+        // spike uses health_changes_tmi as well, so it is computed in the same pass.
+        tmi = calculate_tmi( health_changes_tmi, window, f_length, p, &max_spike );
 
         // ETMI includes external healing - use health_changes
         etmi = calculate_tmi( health_changes, window, f_length, p );
 
-        // Max spike uses health_changes_tmi as well, ignores external heals - use health_changes_tmi
-        max_spike = calculate_max_spike_damage( health_changes_tmi, window );
-
         tank_metric = tmi;
       }
     }
@@ -4080,6 +4080,17 @@ namespace
 {
 bool cmp_dbitem( const special_effect_db_item_t& elem, unsigned id )
 { return elem.spell_id < id; }
+
+// Spell id indexed lookup results of the special effect databases, built once in
+// unique_gear::sort_special_effects() after all special effects have been registered. The
+// databases are not modified afterwards, so the tables are safe to use concurrently from child
+// sims.
+typedef std::unordered_map<unsigned, special_effect_set_t> special_effect_index_t;
+
+special_effect_index_t __special_effect_index, __fallback_effect_index;
+// Unique spell ids of the fallback special effect database, in ascending order
+std::vector<unsigned> __fallback_effect_ids;
+bool __special_effect_indexed = false;
 }
 
 static unique_gear::special_effect_set_t do_find_special_effect_db_item(
@@ -4120,14 +4131,50 @@ static unique_gear::special_effect_set_t do_find_special_effect_db_item(
   return entries;
 }
 
+static void index_special_effect_db( const std::vector<special_effect_db_item_t>& db,
+                                     special_effect_index_t& index )
+{
+  index.clear();
+
+  for ( auto it = db.begin(); it != db.end(); ++it )
+  {
+    if ( it != db.begin() && ( it - 1 ) -> spell_id == it -> spell_id )
+    {
+      continue;
+    }
+
+    index[ it -> spell_id ] = do_find_special_effect_db_item( db, it -> spell_id );
+  }
+}
+
+static special_effect_set_t find_indexed_effect_db_item( const special_effect_index_t& index,
+                                                         const std::vector<special_effect_db_item_t>& db,
+                                                         unsigned spell_id )
+{
+  // Special effects registered after indexing are only found through the (slower) sorted search
+  if ( ! __special_effect_indexed )
+  {
+    return do_find_special_effect_db_item( db, spell_id );
+  }
+
+  auto it = index.find( spell_id );
+  if ( it == index.end() )
+  {
+    return { };
+  }
+
+  return it -> second;
+}
+
 static special_effect_set_t find_fallback_effect_db_item( unsigned spell_id )
-{ return do_find_special_effect_db_item( __fallback_effect_db, spell_id ); }
+{ return find_indexed_effect_db_item( __fallback_effect_index, __fallback_effect_db, spell_id ); }
 
 special_effect_set_t unique_gear::find_special_effect_db_item( unsigned spell_id )
-{ return do_find_special_effect_db_item( __special_effect_db, spell_id ); }
+{ return find_indexed_effect_db_item( __special_effect_index, __special_effect_db, spell_id ); }
 
 void unique_gear::add_effect( const special_effect_db_item_t& dbitem )
 {
+  __special_effect_indexed = false;
   __special_effect_db.push_back( dbitem );
   if ( dbitem.fallback )
     __fallback_effect_db.push_back( dbitem );
@@ -4146,6 +4193,7 @@ void unique_gear::register_special_effect( unsigned           spell_id,
   dbitem.spell_id = spell_id;
   dbitem.cb_obj = new wrapper_callback_t( init_callback );
 
+  __special_effect_indexed = false;
   __special_effect_db.push_back( dbitem );
 }
 
@@ -4155,6 +4203,7 @@ void unique_gear::register_special_effect( unsigned spell_id, const char* encode
   dbitem.spell_id = spell_id;
   dbitem.encoded_options = encoded_str;
 
+  __special_effect_indexed = false;
   __special_effect_db.push_back( dbitem );
 }
 
@@ -4488,20 +4537,39 @@ void unique_gear::initialize_special_effect_fallbacks( player_t* actor )
 {
   special_effect_t fallback_effect( actor );
 
-  // Generate an unique list of fallback spell ids
+  // Unique list of fallback spell ids, either computed in sort_special_effects(), or generated here
+  // if special effects have been registered after it
   std::vector<unsigned> fallback_ids;
-  range::for_each( __fallback_effect_db, [ &fallback_ids ]( const special_effect_db_item_t& elem ) {
-    if ( range::find( fallback_ids, elem.spell_id ) == fallback_ids.end() )
-    {
-      fallback_ids.push_back( elem.spell_id );
-    }
-  });
+  if ( ! __special_effect_indexed )
+  {
+    range::for_each( __fallback_effect_db, [ &fallback_ids ]( const special_effect_db_item_t& elem ) {
+      if ( range::find( fallback_ids, elem.spell_id ) == fallback_ids.end() )
+      {
+        fallback_ids.push_back( elem.spell_id );
+      }
+    });
+  }
+  const std::vector<unsigned>& unique_ids = __special_effect_indexed ? __fallback_effect_ids : fallback_ids;
+
+  // Collect the driver spell ids of all special effects on the actor once, instead of searching the
+  // actor and item special effects for each fallback id
+  std::vector<unsigned> actor_effect_ids;
+  range::for_each( actor -> special_effects, [ &actor_effect_ids ]( const special_effect_t* e ) {
+    actor_effect_ids.push_back( e -> driver() -> id() );
+  } );
+  for ( const auto& item: actor -> items )
+  {
+    range::for_each( item.parsed.special_effects, [ &actor_effect_ids ]( const special_effect_t* e ) {
+      actor_effect_ids.push_back( e -> driver() -> id() );
+    } );
+  }
+  range::sort( actor_effect_ids );
 
   // Check all fallback ids
-  for ( auto fallback_id: fallback_ids )
+  for ( auto fallback_id: unique_ids )
   {
     // Actor already has a special effect with the fallback id, so don't do anything
-    if ( find_special_effect( actor, fallback_id ) )
+    if ( std::binary_search( actor_effect_ids.begin(), actor_effect_ids.end(), fallback_id ) )
     {
       continue;
     }
@@ -4570,8 +4638,24 @@ bool cmp_special_effect( const special_effect_db_item_t& a, const special_effect
 }
 }
 
+// Sort the special effect databases, and build the spell id indexed lookup tables. Must be called
+// once all special effects are registered, before any actor is initialized.
 void unique_gear::sort_special_effects()
 {
   std::sort( __special_effect_db.begin(), __special_effect_db.end(), cmp_special_effect );
   std::sort( __fallback_effect_db.begin(), __fallback_effect_db.end(), cmp_special_effect );
+
+  index_special_effect_db( __special_effect_db, __special_effect_index );
+  index_special_effect_db( __fallback_effect_db, __fallback_effect_index );
+
+  __fallback_effect_ids.clear();
+  for ( const auto& dbitem: __fallback_effect_db )
+  {
+    if ( __fallback_effect_ids.empty() || __fallback_effect_ids.back() != dbitem.spell_id )
+    {
+      __fallback_effect_ids.push_back( dbitem.spell_id );
+    }
+  }
+
+  __special_effect_indexed = true;
 }
@@ -5,6 +5,8 @@
 
 #include "sc_report.hpp"
 #include "simulationcraft.hpp"
+#include "util/rapidjson/filewritestream.h"
+#include "util/rapidjson/writer.h"
 
 // ==========================================================================
 // Report
@@ -35,6 +37,113 @@ struct buff_is_constant
   }
 };
 
+thread_local report::thread_output_t* current_thread_output = nullptr;
+
+// Build the xml description of a single spell query result under root
+void spell_query_to_xml( xml_node_t* root, const sim_t& sim, const spell_data_expr_t& sq,
+                         unsigned id, unsigned level )
+{
+  switch ( sq.data_type )
+  {
+    case DATA_TALENT:
+      spell_info::talent_to_xml( sim.dbc, sim.dbc.talent( id ), root );
+      break;
+    case DATA_EFFECT:
+    {
+      const spelleffect_data_t* dbc_effect = sim.dbc.effect( id );
+      if ( const spell_data_t* spell = dbc::find_spell( &( sim ), dbc_effect->spell() ) )
+      {
+        spell_info::effect_to_xml( sim.dbc, spell, dbc::find_effect( &( sim ), dbc_effect ), root );
+      }
+    }
+    break;
+    default:
+    {
+      const spell_data_t* spell = dbc::find_spell( &( sim ), sim.dbc.spell( id ) );
+      spell_info::to_xml( sim.dbc, spell, root, level );
+    }
+  }
+}
+
+/* Write a spell query xml node as a JSON object. Parameters become string members, and the text of
+ * the node a "text" member. Child nodes are grouped by name into arrays, where a child with only
+ * text is written as a plain string. The root object of a result names its node ("spell", "effect",
+ * "talent") in "kind"; "type" is taken by the effect type parameter.
+ */
+void write_spell_query_json( rapidjson::Writer<rapidjson::FileWriteStream>& writer,
+                             xml_node_t& node, const char* kind )
+{
+  if ( node.children.empty() && node.parameters.size() == 1 &&
+       ! strcmp( node.parameters[ 0 ].name(), "." ) && ! kind )
+  {
+    std::string value = node.parameters[ 0 ].value();
+    writer.String( value.c_str(), static_cast<rapidjson::SizeType>( value.size() ) );
+    return;
+  }
+
+  writer.StartObject();
+
+  if ( kind )
+  {
+    writer.String( "kind" );
+    writer.String( kind );
+  }
+
+  for ( const xml_parm_t& parm : node.parameters )
+  {
+    std::string value = parm.value();
+    writer.String( strcmp( parm.name(), "." ) ? parm.name() : "text" );
+    writer.String( value.c_str(), static_cast<rapidjson::SizeType>( value.size() ) );
+  }
+
+  for ( size_t i = 0; i < node.children.size(); ++i )
+  {
+    const char* name = node.children[ i ]->name();
+
+    // Members are written in the order of the first child of each name
+    bool written = false;
+    for ( size_t j = 0; j < i && ! written; ++j )
+      written = ! strcmp( node.children[ j ]->name(), name );
+    if ( written )
+      continue;
+
+    writer.String( name );
+    writer.StartArray();
+    for ( size_t j = i; j < node.children.size(); ++j )
+    {
+      if ( ! strcmp( node.children[ j ]->name(), name ) )
+        write_spell_query_json( writer, *node.children[ j ], nullptr );
+    }
+    writer.EndArray();
+  }
+
+  writer.EndObject();
+}
+
+/* Generates one report format, on its own thread when the sim runs multiple threads. Its Timer
+ * results and errors are collected and merged in order once all formats are done.
+ */
+struct report_thread_t : public sc_thread_t
+{
+  std::function<void()> print;
+  report::thread_output_t output;
+
+  report_thread_t( std::function<void()> print ) : print( std::move( print ) )
+  { }
+
+  void generate()
+  {
+    report::thread_output_t* previous = report::thread_output();
+    report::set_thread_output( &output );
+    print();
+    report::set_thread_output( previous );
+  }
+
+private:
+  void run() override
+  { generate(); }
+};
+
 struct buff_comp
 {
   bool operator()( const buff_t* i, const buff_t* j )
@@ -788,56 +897,172 @@ void report::print_spell_query( std::ostream& out, const sim_t& sim,
   }
 }
 
-void report::print_spell_query( xml_node_t* root, FILE* file, const sim_t& sim,
+// report::print_spell_query ================================================
+
+void report::print_spell_query( FILE* file, const sim_t& sim,
                                 const spell_data_expr_t& sq, unsigned level )
 {
-  expr_data_e data_type = sq.data_type;
-  for ( auto i = sq.result_spell_list.begin(); i != sq.result_spell_list.end();
-        ++i )
+  util::fprintf( file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" );
+  if ( sq.result_spell_list.empty() )
   {
-    switch ( data_type )
+    util::fprintf( file, "<spell_query />\n" );
+    return;
+  }
+
+  // Each result is built and written on its own, so that the whole document is never held in memory
+  util::fprintf( file, "<spell_query>\n" );
+  for ( auto i = sq.result_spell_list.begin(); i != sq.result_spell_list.end(); ++i )
+  {
+    xml_node_t root( "spell_query" );
+    spell_query_to_xml( &root, sim, sq, *i, level );
+    for ( xml_node_t* node : root.children )
+      node->print_xml( file, 2 );
+  }
+  util::fprintf( file, "</spell_query>\n" );
+}
+
+// report::print_spell_query_json ===========================================
+
+void report::print_spell_query_json( FILE* file, const sim_t& sim,
+                                     const spell_data_expr_t& sq, unsigned level )
+{
+  std::vector<char> buffer( 1 << 16 );
+  rapidjson::FileWriteStream stream( file, buffer.data(), buffer.size() );
+  rapidjson::Writer<rapidjson::FileWriteStream> writer( stream );
+
+  for ( auto i = sq.result_spell_list.begin(); i != sq.result_spell_list.end(); ++i )
+  {
+    xml_node_t root( "spell_query" );
+    spell_query_to_xml( &root, sim, sq, *i, level );
+    for ( xml_node_t* node : root.children )
     {
-      case DATA_TALENT:
-        spell_info::talent_to_xml( sim.dbc, sim.dbc.talent( *i ), root );
-        break;
-      case DATA_EFFECT:
-      {
-        std::ostringstream sqs;
-        const spelleffect_data_t* dbc_effect = sim.dbc.effect( *i );
-        if ( const spell_data_t* spell =
-                 dbc::find_spell( &( sim ), dbc_effect->spell() ) )
-        {
-          spell_info::effect_to_xml(
-              sim.dbc, spell, dbc::find_effect( &( sim ), dbc_effect ), root );
-        }
-      }
-      break;
-      default:
-      {
-        const spell_data_t* spell =
-            dbc::find_spell( &( sim ), sim.dbc.spell( *i ) );
-        spell_info::to_xml( sim.dbc, spell, root, level );
-      }
+      writer.Reset( stream );
+      write_spell_query_json( writer, *node, node->name() );
+      stream.Put( '\n' );
     }
   }
 
-  util::fprintf( file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" );
-  root->print_xml( file );
+  stream.Flush();
 }
+
 // report::print_suite ======================================================
 
 void report::print_suite( sim_t* sim )
 {
   std::cout << "\nGenerating reports...";
 
-  report::print_text( sim, sim->report_details != 0 );
+  // Player report data is shared by the formats, generate it before they run concurrently
+  for ( auto& player : sim->actor_list )
+  {
+    report::generate_player_charts( *player, player->report_information );
+    report::generate_player_buff_lists( *player, player->report_information );
+  }
+
+  std::vector<std::unique_ptr<report_thread_t> > reports;
+  // Batch entries only write the text report to output=, instead of interleaving it on stdout
+  if ( ! sim->batch_entry || ! sim->output_file_str.empty() )
+    reports.emplace_back( new report_thread_t( [ sim ] { report::print_text( sim, sim->report_details != 0 ); } ) );
+  reports.emplace_back( new report_thread_t( [ sim ] { report::print_html( *sim ); } ) );
+  reports.emplace_back( new report_thread_t( [ sim ] { report::print_xml( sim ); } ) );
+  reports.emplace_back( new report_thread_t( [ sim ] { report::print_json( *sim ); } ) );
+
+  Timer t( "Report generation" );
 
-  report::print_html( *sim );
-  report::print_xml( sim );
-  report::print_json( *sim );
+  if ( sim->threads > 1 )
+  {
+    for ( auto& report : reports )
+      report->launch();
+    for ( auto& report : reports )
+      report->join();
+  }
+  else
+  {
+    for ( auto& report : reports )
+      report->generate();
+  }
+
+  // Timer results (wall time of each format) and errors, in the sequential order
+  for ( auto& report : reports )
+    report::merge_thread_output( *sim, report->output );
+
+  // Saving profiles recreates the players' talent strings, which the other formats read
   report::print_profiles( sim );
 }
 
+// report::thread_output ====================================================
+
+report::thread_output_t* report::thread_output()
+{
+  return current_thread_output;
+}
+
+void report::set_thread_output( thread_output_t* output )
+{
+  current_thread_output = output;
+}
+
+std::ostream& report::timer_output()
+{
+  return current_thread_output ? current_thread_output->timers : std::cout;
+}
+
+/* Hand the output collected by a finished thread over to the calling thread: Timer results and
+ * errors go to the calling thread's own collected output if it has one, otherwise they are
+ * printed / added to the sim. Chart data goes to the sim, unless the calling thread captures
+ * charts as well.
+ */
+void report::merge_thread_output( sim_t& sim, thread_output_t& output )
+{
+  timer_output() << output.timers.str();
+
+  for ( auto& error : output.errors )
+  {
+    if ( current_thread_output )
+      current_thread_output->errors.push_back( error );
+    else
+      sim.error_list.push_back( error );
+  }
+
+  if ( current_thread_output && current_thread_output->capture_charts )
+  {
+    range::append( current_thread_output->on_ready_chart_data, output.on_ready_chart_data );
+    range::append( current_thread_output->chart_data, output.chart_data );
+  }
+  else
+  {
+    range::append( sim.on_ready_chart_data, output.on_ready_chart_data );
+    for ( auto& chart : output.chart_data )
+      sim.chart_data[ chart.first ].push_back( chart.second );
+  }
+}
+
+// report::sc_html_stream ===================================================
+
+report::sc_html_stream::sc_html_stream() : std::ostream( nullptr )
+{
+  rdbuf( &buffer );
+}
+
+void report::sc_html_stream::open( const std::string& filename )
+{
+  file.open( filename );
+  rdbuf( file.rdbuf() );
+  if ( ! file )
+    setstate( std::ios_base::failbit );
+}
+
+report::sc_html_stream& report::sc_html_stream::format( const char* fmt, ... )
+{
+  va_list fmtargs;
+  va_start( fmtargs, fmt );
+  std::string str = str::format( fmt, fmtargs );
+  va_end( fmtargs );
+
+  *this << str;
+
+  return *this;
+}
+
 void report::print_html_sample_data( report::sc_html_stream& os,
                                      const player_t& p,
                                      const extended_sample_data_t& data,
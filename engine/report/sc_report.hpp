@@ -9,6 +9,10 @@
 #include <array>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include "config.hpp"
 #include "sc_enums.hpp"
@@ -27,6 +31,33 @@ struct sim_report_information_t;
 struct spell_data_expr_t;
 
 #include <chrono>
+
+namespace report
+{
+/* Output of report code running on a worker thread. Timer results, errors and (when
+ * capture_charts is set) html chart data are collected here instead of being written out
+ * directly, and are handed over in a fixed order once the thread is done, so that reports
+ * generated concurrently come out the same as when generated one after the other.
+ */
+struct thread_output_t
+{
+  std::ostringstream timers;
+  std::vector<std::string> errors;
+  bool capture_charts;
+  std::vector<std::string> on_ready_chart_data;
+  std::vector<std::pair<std::string, std::string> > chart_data;
+
+  thread_output_t() : capture_charts( false ) {}
+};
+
+// Output collected for the calling thread, nullptr if it writes directly
+thread_output_t* thread_output();
+void set_thread_output( thread_output_t* );
+
+// Stream Timer results are written to on the calling thread
+std::ostream& timer_output();
+}  // report
+
 /**
  * Automatic Timer reporting the time between construction and desctruction of
  * the object.
@@ -39,7 +70,7 @@ private:
   std::chrono::time_point<std::chrono::high_resolution_clock> start;
 
 public:
-  Timer( std::string title, std::ostream& out = std::cout )
+  Timer( std::string title, std::ostream& out = report::timer_output() )
     : title( std::move( title ) ),
       out( out ),
       start( std::chrono::high_resolution_clock::now() )
@@ -191,7 +222,23 @@ std::array<std::string, SCALE_METRIC_MAX> askmrrobot( const player_t& );
 // Report
 namespace report
 {
-using sc_html_stream = io::ofstream;
+/* Html report output. Writes to memory until a file is opened, so that sections of the report can
+ * be rendered separately and written out in order.
+ */
+class sc_html_stream : public std::ostream
+{
+private:
+  std::stringbuf buffer;
+  io::ofstream file;
+
+public:
+  sc_html_stream();
+  void open( const std::string& filename );
+  sc_html_stream& format( const char* format, ... );
+  // Contents written to memory
+  std::string str() const
+  { return buffer.str(); }
+};
 
 void generate_player_charts( player_t&,
                              player_processed_report_information_t& );
@@ -218,8 +265,10 @@ std::string decorate_html_string( const std::string& value,
 
 void print_spell_query( std::ostream& out, const sim_t& sim,
                         const spell_data_expr_t&, unsigned level );
-void print_spell_query( xml_node_t* out, FILE* file, const sim_t& sim,
+void print_spell_query( FILE* file, const sim_t& sim,
                         const spell_data_expr_t&, unsigned level );
+void print_spell_query_json( FILE* file, const sim_t& sim,
+                             const spell_data_expr_t&, unsigned level );
 bool check_gear_ilevel( player_t& p, sim_t& sim );
 bool check_artifact_points( const player_t& p, sim_t& sim );
 void print_profiles( sim_t* );
@@ -229,6 +278,7 @@ void print_json( sim_t& );
 void print_html_player( report::sc_html_stream&, player_t&, int );
 void print_xml( sim_t* );
 void print_suite( sim_t* );
+void merge_thread_output( sim_t&, thread_output_t& );
 std::vector<std::string> beta_warnings();
 std::string pretty_spell_text( const spell_data_t& default_spell,
                                const std::string& text, const player_t& p );
@@ -7,6 +7,7 @@
 #include "sc_report.hpp"
 #include "data/report_data.inc"
 #include "interfaces/sc_js.hpp"
+#include <atomic>
 
 // Experimental Raw Ability Output for Blizzard to do comparisons
 namespace raw_ability_summary
@@ -1334,6 +1335,102 @@ void print_nothing_to_report( report::sc_html_stream& os,
      << "</div>\n\n";
 }
 
+/* The html section of an actor and its pets, rendered into memory on its own
+ */
+struct html_section_t
+{
+  player_t* player;
+  int index;
+  bool all_pets;
+  report::sc_html_stream os;
+  report::thread_output_t output;
+
+  html_section_t( player_t* player, int index, bool all_pets )
+    : player( player ), index( index ), all_pets( all_pets )
+  {
+    output.capture_charts = true;
+  }
+};
+
+void print_html_section( html_section_t& section )
+{
+  const sim_t& sim = *section.player -> sim;
+  report::sc_html_stream& os = section.os;
+  os.precision( sim.report_precision );
+  os << std::fixed;
+
+  report::print_html_player( os, *section.player, section.index );
+
+  // Pets
+  if ( sim.report_pets_separately )
+  {
+    for ( auto& pet : section.player -> pet_list )
+    {
+      if ( section.all_pets || ( pet -> summoned && !pet -> quiet ) )
+        report::print_html_player( os, *pet, 1 );
+    }
+  }
+}
+
+/* Renders html sections on up to sim.threads worker threads, each thread taking the next
+ * unrendered section until none are left. Charts are collected per section.
+ */
+struct html_section_thread_t : public sc_thread_t
+{
+  std::vector<std::unique_ptr<html_section_t> >& sections;
+  std::atomic<size_t>& next_section;
+
+  html_section_thread_t( std::vector<std::unique_ptr<html_section_t> >& sections,
+                         std::atomic<size_t>& next_section )
+    : sections( sections ), next_section( next_section )
+  { }
+
+private:
+  void run() override
+  {
+    for ( size_t i = next_section++; i < sections.size(); i = next_section++ )
+    {
+      report::set_thread_output( &sections[ i ] -> output );
+      print_html_section( *sections[ i ] );
+    }
+    report::set_thread_output( nullptr );
+  }
+};
+
+void print_html_sections( const sim_t& sim, std::vector<std::unique_ptr<html_section_t> >& sections )
+{
+  size_t n_threads = std::min( sections.size(), static_cast<size_t>( std::max( 1, sim.threads ) ) );
+  if ( n_threads <= 1 )
+  {
+    report::thread_output_t* previous = report::thread_output();
+    for ( auto& section : sections )
+    {
+      report::set_thread_output( &section -> output );
+      print_html_section( *section );
+    }
+    report::set_thread_output( previous );
+    return;
+  }
+
+  std::atomic<size_t> next_section( 0 );
+  std::vector<std::unique_ptr<html_section_thread_t> > threads;
+  for ( size_t i = 0; i < n_threads; ++i )
+  {
+    threads.emplace_back( new html_section_thread_t( sections, next_section ) );
+    threads.back() -> launch();
+  }
+
+  for ( auto& thread : threads )
+    thread -> join();
+}
+
+// Write out a rendered section, with its charts in the order they were added
+void write_html_section( report::sc_html_stream& os, sim_t& sim, html_section_t& section )
+{
+  os << section.os.str();
+  report::merge_thread_output( sim, section.output );
+}
+
 /* Main function building the html document and calling subfunctions
  */
 void print_html_( report::sc_html_stream& os, sim_t& sim )
@@ -1389,45 +1486,40 @@ void print_html_( report::sc_html_stream& os, sim_t& sim )
 
   int k = 0;  // Counter for both players and enemies, without pets.
 
-  // Report Players
+  // Player and target sections are rendered in parallel, and written out in order
+  std::vector<std::unique_ptr<html_section_t> > sections;
   for ( auto& player : sim.players_by_name )
   {
-    report::print_html_player( os, *player, k );
+    sections.emplace_back( new html_section_t( player, k, false ) );
+  }
+  size_t n_player_sections = sections.size();
 
-    // Pets
-    if ( sim.report_pets_separately )
+  if ( sim.report_targets )
+  {
+    for ( auto& player : sim.targets_by_name )
     {
-      for ( auto& pet : player->pet_list )
-      {
-        if ( pet->summoned && !pet->quiet )
-          report::print_html_player( os, *pet, 1 );
-      }
+      sections.emplace_back( new html_section_t( player, k, true ) );
+      ++k;
     }
   }
 
+  print_html_sections( sim, sections );
+
+  // Report Players
+  for ( size_t i = 0; i < n_player_sections; ++i )
+  {
+    write_html_section( os, sim, *sections[ i ] );
+  }
+
   print_html_sim_summary( os, sim );
 
   if ( sim.report_raw_abilities )
     raw_ability_summary::print( os, sim );
 
   // Report Targets
-  if ( sim.report_targets )
+  for ( size_t i = n_player_sections; i < sections.size(); ++i )
   {
-    for ( auto& player : sim.targets_by_name )
-    {
-      report::print_html_player( os, *player, k );
-      ++k;
-
-      // Pets
-      if ( sim.report_pets_separately )
-      {
-        for ( auto& pet : player->pet_list )
-        {
-          // if ( pet -> summoned )
-          report::print_html_player( os, *pet, 1 );
-        }
-      }
-    }
+    write_html_section( os, sim, *sections[ i ] );
   }
 
   print_html_help_boxes( os, sim );
@@ -4,554 +4,723 @@
 // ==========================================================================
 
 #include "sc_report.hpp"
-#include "interfaces/sc_js.hpp"
 #include "simulationcraft.hpp"
 #include "util/rapidjson/filewritestream.h"
+#include "util/rapidjson/prettywriter.h"
 
 namespace
 {
-double to_json( const timespan_t& t )
+/* The JSON report is streamed straight to the output file through a rapidjson SAX writer, as the
+ * sim is walked. Objects are written member by member, in the order (and with the value types)
+ * the report has always used.
+ */
+typedef rapidjson::PrettyWriter<rapidjson::FileWriteStream> json_writer_t;
+
+// Scalar values ============================================================
+
+void write( json_writer_t& w, bool v )
+{ w.Bool( v ); }
+
+void write( json_writer_t& w, int v )
+{ w.Int( v ); }
+
+void write( json_writer_t& w, unsigned v )
+{ w.Uint( v ); }
+
+void write( json_writer_t& w, uint64_t v )
+{ w.Uint64( v ); }
+
+void write( json_writer_t& w, double v )
+{ w.Double( v ); }
+
+void write( json_writer_t& w, const char* v )
 {
-  return t.total_seconds();
+  assert( v );
+  w.String( v );
 }
 
-// js::sc_js_t to_json( const timespan_t& t )
-//{
-//  js::sc_js_t node;
-//  node.set( "seconds", t.total_seconds() );
-//  std::string formatted_time;
-//  str::format( formatted_time, "%d:%02d.%03d</td>\n", (int)t.total_minutes(),
-//               (int)t.total_seconds() % 60, (int)t.total_millis() % 1000 );
-//  node.set( "formatted", formatted_time );
-//  return node;
-//}
+void write( json_writer_t& w, const std::string& v )
+{ w.String( v.c_str(), static_cast<rapidjson::SizeType>( v.size() ) ); }
+
+void write( json_writer_t& w, const timespan_t& t )
+{ w.Double( t.total_seconds() ); }
 
-js::sc_js_t to_json( const simple_sample_data_t& sd )
+template <typename T>
+void write( json_writer_t& w, const std::vector<T>& values )
 {
-  js::sc_js_t node;
-  node.set( "sum", sd.sum() );
-  node.set( "count", sd.count() );
-  node.set( "mean", sd.mean() );
-  return node;
+  w.StartArray();
+  for ( const auto& value : values )
+  {
+    write( w, value );
+  }
+  w.EndArray();
+}
+
+// Report objects, defined below
+void write( json_writer_t& w, const simple_sample_data_t& sd );
+void write( json_writer_t& w, const ::simple_sample_data_with_min_max_t& sd );
+void write( json_writer_t& w, const ::extended_sample_data_t& sd );
+void write( json_writer_t& w, const sc_timeline_t& tl );
+void write( json_writer_t& w, const gain_t& g );
+void write( json_writer_t& w, const spelleffect_data_t& sed );
+void write( json_writer_t& w, const spellpower_data_t& spd );
+void write( json_writer_t& w, const spell_data_t& sd );
+void write( json_writer_t& w, const cooldown_t& cd );
+void write( json_writer_t& w, const buff_t& b );
+void write( json_writer_t& w, const proc_t& p );
+void write( json_writer_t& w, const stats_t& s );
+void write( json_writer_t& w, const player_collected_data_t::resource_timeline_t& rtl );
+void write( json_writer_t& w, const player_collected_data_t::stat_timeline_t& stl );
+void write( json_writer_t& w, const player_collected_data_t::health_changes_timeline_t& hctl );
+void write( json_writer_t& w, const player_collected_data_t::buffed_stats_t& bs );
+void write( json_writer_t& w, const player_collected_data_t::action_sequence_data_t& asd );
+void write( json_writer_t& w, const pet_t::owner_coefficients_t& oc );
+void write( json_writer_t& w, const pet_t& p );
+void write( json_writer_t& w, const dbc_t& dbc );
+void write( json_writer_t& w, const player_t::base_initial_current_t& );
+void write( json_writer_t& w, const player_t::diminishing_returns_constants_t& );
+void write( json_writer_t& w, const weapon_t& );
+void write( json_writer_t& w, const player_t::resources_t& );
+void write( json_writer_t& w, const player_t::consumables_t& );
+void write( json_writer_t& w, const player_t& p );
+void write( json_writer_t& w, const rng::rng_t& rng );
+void write( json_writer_t& w, const raid_event_t& re );
+void write( json_writer_t& w, const sim_t::overrides_t& o );
+void write( json_writer_t& w, const scaling_t& );
+void write( json_writer_t& w, const plot_t& o );
+void write( json_writer_t& w, const reforge_plot_t& );
+void write( json_writer_t& w, const iteration_data_entry_t& ide );
+void write( json_writer_t& w, const sim_t& sim );
+
+// Write an object member
+template <typename T>
+void member( json_writer_t& w, const char* name, const T& value )
+{
+  w.Key( name );
+  write( w, value );
 }
 
-js::sc_js_t to_json( const ::simple_sample_data_with_min_max_t& sd )
+template <typename T>
+void member( json_writer_t& w, const std::string& name, const T& value )
 {
-  js::sc_js_t node;
-  node.set( "sum", sd.sum() );
-  node.set( "count", sd.count() );
-  node.set( "mean", sd.mean() );
-  node.set( "min", sd.min() );
-  node.set( "max", sd.max() );
-  return node;
+  member( w, name.c_str(), value );
 }
 
-js::sc_js_t to_json( const ::extended_sample_data_t& sd )
+// Write an array member from a range of objects, dereferencing pointers
+template <typename Range>
+void array_member( json_writer_t& w, const char* name, const Range& range )
 {
-  js::sc_js_t node;
-  node.set( "name", sd.name_str );
-  node.set( "sum", sd.sum() );
-  node.set( "count", sd.count() );
-  node.set( "mean", sd.mean() );
-  node.set( "min", sd.min() );
-  node.set( "max", sd.max() );
+  w.Key( name );
+  w.StartArray();
+  for ( const auto& elem : range )
+  {
+    write( w, *elem );
+  }
+  w.EndArray();
+}
+
+// Write an array member, if the range has elements
+template <typename Range>
+void optional_array_member( json_writer_t& w, const char* name, const Range& range )
+{
+  if ( range.begin() != range.end() )
+  {
+    array_member( w, name, range );
+  }
+}
+
+// Report objects ===========================================================
+
+void write( json_writer_t& w, const simple_sample_data_t& sd )
+{
+  w.StartObject();
+  member( w, "sum", sd.sum() );
+  member( w, "count", sd.count() );
+  member( w, "mean", sd.mean() );
+  w.EndObject();
+}
+
+void write( json_writer_t& w, const ::simple_sample_data_with_min_max_t& sd )
+{
+  w.StartObject();
+  member( w, "sum", sd.sum() );
+  member( w, "count", sd.count() );
+  member( w, "mean", sd.mean() );
+  member( w, "min", sd.min() );
+  member( w, "max", sd.max() );
+  w.EndObject();
+}
+
+void write( json_writer_t& w, const ::extended_sample_data_t& sd )
+{
+  w.StartObject();
+  member( w, "name", sd.name_str );
+  member( w, "sum", sd.sum() );
+  member( w, "count", sd.count() );
+  member( w, "mean", sd.mean() );
+  member( w, "min", sd.min() );
+  member( w, "max", sd.max() );
   if ( !sd.simple )
   {
-    node.set( "variance", sd.variance );
-    node.set( "std_dev", sd.std_dev );
-    node.set( "mean_variance", sd.mean_variance );
-    node.set( "mean_std_dev", sd.mean_std_dev );
+    member( w, "variance", sd.variance );
+    member( w, "std_dev", sd.std_dev );
+    member( w, "mean_variance", sd.mean_variance );
+    member( w, "mean_std_dev", sd.mean_std_dev );
   }
-  // node.set( "data", sd.data() );
-  // node.set( "distribution", sd.distribution );
-  return node;
+  // member( w, "data", sd.data() );
+  // member( w, "distribution", sd.distribution );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const sc_timeline_t& tl )
+void write( json_writer_t& w, const sc_timeline_t& tl )
 {
-  js::sc_js_t node;
-  node.set( "mean", tl.mean() );
-  node.set( "mean_std_dev", tl.mean_stddev() );
-  node.set( "min", tl.min() );
-  node.set( "max", tl.max() );
-  node.set( "data", tl.data() );
-  return node;
+  w.StartObject();
+  member( w, "mean", tl.mean() );
+  member( w, "mean_std_dev", tl.mean_stddev() );
+  member( w, "min", tl.min() );
+  member( w, "max", tl.max() );
+  member( w, "data", tl.data() );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const gain_t& g )
+void write( json_writer_t& w, const gain_t& g )
 {
-  js::sc_js_t node;
-  node.set( "name", g.name() );
-  js::sc_js_t data;
+  w.StartObject();
+  member( w, "name", g.name() );
+  w.Key( "data" );
+  w.StartObject();
   for ( resource_e r = RESOURCE_NONE; r < RESOURCE_MAX; ++r )
   {
     if ( g.count[ r ] > 0 )
     {
-      js::sc_js_t node2;
-      node2.set( "actual", g.actual[ r ] );
-      node2.set( "overflow", g.overflow[ r ] );
-      node2.set( "count", g.count[ r ] );
-      data.set( util::resource_type_string( r ), node2 );
+      w.Key( util::resource_type_string( r ) );
+      w.StartObject();
+      member( w, "actual", g.actual[ r ] );
+      member( w, "overflow", g.overflow[ r ] );
+      member( w, "count", g.count[ r ] );
+      w.EndObject();
     }
   }
-  node.set( "data", data );
-  return node;
+  w.EndObject();
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const spelleffect_data_t& /* sed */ )
+void write( json_writer_t& w, const spelleffect_data_t& /* sed */ )
 {
-  js::sc_js_t node;
+  w.StartObject();
   // TODO
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const spellpower_data_t& /* spd */ )
+void write( json_writer_t& w, const spellpower_data_t& /* spd */ )
 {
-  js::sc_js_t node;
+  w.StartObject();
   // TODO
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const spell_data_t& sd )
+void write( json_writer_t& w, const spell_data_t& sd )
 {
-  js::sc_js_t node;
-  node.set( "id", sd.id() );
-  node.set( "found", sd.found() );
-  node.set( "ok", sd.ok() );
+  w.StartObject();
+  member( w, "id", sd.id() );
+  member( w, "found", sd.found() );
+  member( w, "ok", sd.ok() );
   if ( !sd.ok() )
-    return node;
-  node.set( "category", sd.category() );
-  node.set( "class_mask", sd.class_mask() );
-  node.set( "cooldown", to_json( sd.cooldown() ) );
-  node.set( "charges", sd.charges() );
-  node.set( "charge_cooldown", to_json( sd.charge_cooldown() ) );
+  {
+    w.EndObject();
+    return;
+  }
+  member( w, "category", sd.category() );
+  member( w, "class_mask", sd.class_mask() );
+  member( w, "cooldown", sd.cooldown() );
+  member( w, "charges", sd.charges() );
+  member( w, "charge_cooldown", sd.charge_cooldown() );
   if ( sd.desc() )
-    node.set( "desc", sd.desc() );
+    member( w, "desc", sd.desc() );
   if ( sd.desc_vars() )
-    node.set( "desc_vars", sd.desc_vars() );
-  node.set( "duration", to_json( sd.duration() ) );
-  node.set( "gcd", to_json( sd.gcd() ) );
-  node.set( "initial_stacks", sd.initial_stacks() );
-  node.set( "race_mask", sd.race_mask() );
-  node.set( "level", sd.level() );
-  node.set( "name", sd.name_cstr() );
-  node.set( "max_level", sd.max_level() );
-  node.set( "max_stacks", sd.max_stacks() );
-  node.set( "missile_speed", sd.missile_speed() );
-  node.set( "min_range", sd.min_range() );
-  node.set( "max_range", sd.max_range() );
-  node.set( "proc_chance", sd.proc_chance() );
-  node.set( "proc_flags", sd.proc_flags() );
-  node.set( "internal_cooldown", to_json( sd.internal_cooldown() ) );
-  node.set( "real_ppm", sd.real_ppm() );
+    member( w, "desc_vars", sd.desc_vars() );
+  member( w, "duration", sd.duration() );
+  member( w, "gcd", sd.gcd() );
+  member( w, "initial_stacks", sd.initial_stacks() );
+  member( w, "race_mask", sd.race_mask() );
+  member( w, "level", sd.level() );
+  member( w, "name", sd.name_cstr() );
+  member( w, "max_level", sd.max_level() );
+  member( w, "max_stacks", sd.max_stacks() );
+  member( w, "missile_speed", sd.missile_speed() );
+  member( w, "min_range", sd.min_range() );
+  member( w, "max_range", sd.max_range() );
+  member( w, "proc_chance", sd.proc_chance() );
+  member( w, "proc_flags", sd.proc_flags() );
+  member( w, "internal_cooldown", sd.internal_cooldown() );
+  member( w, "real_ppm", sd.real_ppm() );
   if ( sd.rank_str() )
-    node.set( "rank_str", sd.rank_str() );
-  node.set( "replace_spell_id", sd.replace_spell_id() );
-  node.set( "scaling_multiplier", sd.scaling_multiplier() );
-  node.set( "scaling_threshold", sd.scaling_threshold() );
-  node.set( "school_mask", sd.school_mask() );
+    member( w, "rank_str", sd.rank_str() );
+  member( w, "replace_spell_id", sd.replace_spell_id() );
+  member( w, "scaling_multiplier", sd.scaling_multiplier() );
+  member( w, "scaling_threshold", sd.scaling_threshold() );
+  member( w, "school_mask", sd.school_mask() );
   if ( sd.tooltip() )
-    node.set( "tooltip", sd.tooltip() );
-  node.set( "school_type", util::school_type_string( sd.get_school_type() ) );
-  node.set( "scaling_class", util::player_type_string( sd.scaling_class() ) );
-  node.set( "max_scaling_level", sd.max_scaling_level() );
-  for ( size_t i = 0u; i < sd.effect_count(); ++i )
+    member( w, "tooltip", sd.tooltip() );
+  member( w, "school_type", util::school_type_string( sd.get_school_type() ) );
+  member( w, "scaling_class", util::player_type_string( sd.scaling_class() ) );
+  member( w, "max_scaling_level", sd.max_scaling_level() );
+  if ( sd.effect_count() > 0 )
   {
-    node.add( "effects", to_json( sd.effectN( i + 1 ) ) );
+    w.Key( "effects" );
+    w.StartArray();
+    for ( size_t i = 0u; i < sd.effect_count(); ++i )
+    {
+      write( w, sd.effectN( i + 1 ) );
+    }
+    w.EndArray();
   }
-  for ( size_t i = 0u; i < sd.power_count(); ++i )
+  if ( sd.power_count() > 0 )
   {
-    node.add( "powers", to_json( sd.powerN( i + 1 ) ) );
+    w.Key( "powers" );
+    w.StartArray();
+    for ( size_t i = 0u; i < sd.power_count(); ++i )
+    {
+      write( w, sd.powerN( i + 1 ) );
+    }
+    w.EndArray();
   }
-
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const cooldown_t& cd )
+void write( json_writer_t& w, const cooldown_t& cd )
 {
-  js::sc_js_t node;
-  node.set( "name", cd.name() );
-  node.set( "duration", to_json( cd.duration ) );
-  node.set( "charges", cd.charges );
-  return node;
+  w.StartObject();
+  member( w, "name", cd.name() );
+  member( w, "duration", cd.duration );
+  member( w, "charges", cd.charges );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const buff_t& b )
+void write( json_writer_t& w, const buff_t& b )
 {
-  js::sc_js_t node;
-  node.set( "name", b.name() );
-  node.set( "spell_data", to_json( b.data() ) );
+  w.StartObject();
+  member( w, "name", b.name() );
+  member( w, "spell_data", b.data() );
   if ( b.source )
-    node.set( "source", b.source->name() );
+    member( w, "source", b.source->name() );
   if ( b.cooldown )
-    node.set( "cooldown", to_json( *b.cooldown ) );
-  node.set( "uptime_array", to_json( b.uptime_array ) );
-  node.set( "default_value", b.default_value );
-  node.set( "activated", b.activated );
-  node.set( "reactable", b.reactable );
-  node.set( "reverse", b.reverse );
-  node.set( "constant", b.constant );
-  node.set( "quiet", b.quiet );
-  node.set( "overridden", b.overridden );
-  node.set( "can_cancel", b.can_cancel );
-  node.set( "default_chance", b.default_chance );
+    member( w, "cooldown", *b.cooldown );
+  member( w, "uptime_array", b.uptime_array );
+  member( w, "default_value", b.default_value );
+  member( w, "activated", b.activated );
+  member( w, "reactable", b.reactable );
+  member( w, "reverse", b.reverse );
+  member( w, "constant", b.constant );
+  member( w, "quiet", b.quiet );
+  member( w, "overridden", b.overridden );
+  member( w, "can_cancel", b.can_cancel );
+  member( w, "default_chance", b.default_chance );
   // TODO
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( result_e i, const stats_t::stats_results_t& sr )
+void write( json_writer_t& w, result_e i, const stats_t::stats_results_t& sr )
 {
-  js::sc_js_t node;
-  node.set( "result", util::result_type_string( i ) );
-  node.set( "actual_amount", to_json( sr.actual_amount ) );
-  node.set( "avg_actual_amount", to_json( sr.avg_actual_amount ) );
-  node.set( "total_amount", to_json( sr.total_amount ) );
-  node.set( "fight_actual_amount", to_json( sr.fight_actual_amount ) );
-  node.set( "fight_total_amount", to_json( sr.fight_total_amount ) );
-  node.set( "overkill_pct", to_json( sr.overkill_pct ) );
-  node.set( "count", to_json( sr.count ) );
-  node.set( "pct", sr.pct );
-  return node;
+  w.StartObject();
+  member( w, "result", util::result_type_string( i ) );
+  member( w, "actual_amount", sr.actual_amount );
+  member( w, "avg_actual_amount", sr.avg_actual_amount );
+  member( w, "total_amount", sr.total_amount );
+  member( w, "fight_actual_amount", sr.fight_actual_amount );
+  member( w, "fight_total_amount", sr.fight_total_amount );
+  member( w, "overkill_pct", sr.overkill_pct );
+  member( w, "count", sr.count );
+  member( w, "pct", sr.pct );
+  w.EndObject();
 }
-/*
-js::sc_js_t to_json( const benefit_t& b )
+
+// Only the basic results are written, detailed result arrays included
+template <size_t N>
+void write_results( json_writer_t& w, const char* name, const std::array<stats_t::stats_results_t, N>& results )
 {
-  js::sc_js_t node;
-  node.set( "name", b.name() );
-  node.set( "ration", to_json( b.ratio ) );
-  return node;
-}
-*/
-js::sc_js_t to_json( const proc_t& p )
-{
-  js::sc_js_t node;
-  node.set( "name", p.name() );
-  node.set( "interval_sum", to_json( p.interval_sum ) );
-  node.set( "count", to_json( p.count ) );
-  return node;
-}
-
-js::sc_js_t to_json( const stats_t& s )
-{
-  js::sc_js_t node;
-  node.set( "name", s.name() );
-  node.set( "school", util::school_type_string( s.school ) );
-  node.set( "type", util::stats_type_string( s.type ) );
-  node.set( "resource_gain", to_json( s.resource_gain ) );
-  node.set( "num_executes", to_json( s.num_executes ) );
-  node.set( "num_ticks", to_json( s.num_ticks ) );
-  node.set( "num_refreshes", to_json( s.num_refreshes ) );
-  node.set( "num_executes", to_json( s.num_direct_results ) );
-  node.set( "num_tick_results", to_json( s.num_tick_results ) );
-  node.set( "total_execute_time", to_json( s.total_execute_time ) );
-  node.set( "total_tick_time", to_json( s.total_tick_time ) );
-  node.set( "portion_amount", s.portion_amount );
-  node.set( "total_intervals", to_json( s.total_intervals ) );
-  node.set( "actual_amount", to_json( s.actual_amount ) );
-  node.set( "total_amount", to_json( s.total_amount ) );
-  node.set( "portion_aps", to_json( s.portion_aps ) );
-  node.set( "portion_apse", to_json( s.portion_apse ) );
+  w.Key( name );
+  w.StartArray();
   for ( result_e i = RESULT_NONE; i < RESULT_MAX; ++i )
   {
-    node.add( "direct_results", to_json( i, s.direct_results[ i ] ) );
-    node.add( "direct_results_detail",
-              to_json( i, s.direct_results_detail[ i ] ) );
-    node.add( "tick_results", to_json( i, s.tick_results[ i ] ) );
-    node.add( "tick_results_detail", to_json( i, s.tick_results_detail[ i ] ) );
+    write( w, i, results[ i ] );
   }
-  return node;
+  w.EndArray();
+}
+/*
+void write( json_writer_t& w, const benefit_t& b )
+{
+  w.StartObject();
+  member( w, "name", b.name() );
+  member( w, "ration", b.ratio );
+  w.EndObject();
+}
+*/
+void write( json_writer_t& w, const proc_t& p )
+{
+  w.StartObject();
+  member( w, "name", p.name() );
+  member( w, "interval_sum", p.interval_sum );
+  member( w, "count", p.count );
+  w.EndObject();
+}
+
+void write( json_writer_t& w, const stats_t& s )
+{
+  w.StartObject();
+  member( w, "name", s.name() );
+  member( w, "school", util::school_type_string( s.school ) );
+  member( w, "type", util::stats_type_string( s.type ) );
+  member( w, "resource_gain", s.resource_gain );
+  // Historically written under the num_executes name
+  member( w, "num_executes", s.num_direct_results );
+  member( w, "num_ticks", s.num_ticks );
+  member( w, "num_refreshes", s.num_refreshes );
+  member( w, "num_tick_results", s.num_tick_results );
+  member( w, "total_execute_time", s.total_execute_time );
+  member( w, "total_tick_time", s.total_tick_time );
+  member( w, "portion_amount", s.portion_amount );
+  member( w, "total_intervals", s.total_intervals );
+  member( w, "actual_amount", s.actual_amount );
+  member( w, "total_amount", s.total_amount );
+  member( w, "portion_aps", s.portion_aps );
+  member( w, "portion_apse", s.portion_apse );
+  write_results( w, "direct_results", s.direct_results );
+  write_results( w, "direct_results_detail", s.direct_results_detail );
+  write_results( w, "tick_results", s.tick_results );
+  write_results( w, "tick_results_detail", s.tick_results_detail );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const player_collected_data_t::resource_timeline_t& rtl )
+void write( json_writer_t& w, const player_collected_data_t::resource_timeline_t& rtl )
 {
-  js::sc_js_t node;
-  node.set( "resource", util::resource_type_string( rtl.type ) );
-  node.set( "timeline", to_json( rtl.timeline ) );
-  return node;
+  w.StartObject();
+  member( w, "resource", util::resource_type_string( rtl.type ) );
+  member( w, "timeline", rtl.timeline );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const player_collected_data_t::stat_timeline_t& stl )
+void write( json_writer_t& w, const player_collected_data_t::stat_timeline_t& stl )
 {
-  js::sc_js_t node;
-  node.set( "stat", util::stat_type_string( stl.type ) );
-  node.set( "timeline", to_json( stl.timeline ) );
-  return node;
+  w.StartObject();
+  member( w, "stat", util::stat_type_string( stl.type ) );
+  member( w, "timeline", stl.timeline );
+  w.EndObject();
 }
 
-js::sc_js_t to_json(
-    const player_collected_data_t::health_changes_timeline_t& hctl )
+void write( json_writer_t& w, const player_collected_data_t::health_changes_timeline_t& hctl )
 {
-  js::sc_js_t node;
+  w.StartObject();
   if ( hctl.collect )
   {
-    node.set( "timeline", to_json( hctl.merged_timeline ) );
+    member( w, "timeline", hctl.merged_timeline );
   }
-  return node;
+  w.EndObject();
+}
+
+// Buffed stats are written as single element arrays
+template <typename T>
+void array_value( json_writer_t& w, const char* name, const T& value )
+{
+  w.Key( name );
+  w.StartArray();
+  write( w, value );
+  w.EndArray();
 }
 
-js::sc_js_t to_json( const player_collected_data_t::buffed_stats_t& bs )
+void write( json_writer_t& w, const player_collected_data_t::buffed_stats_t& bs )
 {
-  js::sc_js_t node;
+  w.StartObject();
+  bool attributes = false;
   for ( attribute_e a = ATTRIBUTE_NONE; a < ATTRIBUTE_MAX; ++a )
   {
     if ( bs.attribute[ a ] > 0.0 )
     {
-      js::sc_js_t anode;
-      anode.set( "attribute", util::attribute_type_string( a ) );
-      anode.set( "value", bs.attribute[ a ] );
-      node.add( "attributes", anode );
+      if ( ! attributes )
+      {
+        w.Key( "attributes" );
+        w.StartArray();
+        attributes = true;
+      }
+      w.StartObject();
+      member( w, "attribute", util::attribute_type_string( a ) );
+      member( w, "value", bs.attribute[ a ] );
+      w.EndObject();
     }
   }
+  if ( attributes )
+    w.EndArray();
+
+  bool resources = false;
   for ( resource_e r = RESOURCE_NONE; r < RESOURCE_MAX; ++r )
   {
     if ( bs.resource[ r ] > 0.0 )
     {
-      js::sc_js_t rnode;
-      rnode.set( "resource", util::resource_type_string( r ) );
-      rnode.set( "value", bs.resource[ r ] );
-      node.add( "resource_gained", rnode );
+      if ( ! resources )
+      {
+        w.Key( "resource_gained" );
+        w.StartArray();
+        resources = true;
+      }
+      w.StartObject();
+      member( w, "resource", util::resource_type_string( r ) );
+      member( w, "value", bs.resource[ r ] );
+      w.EndObject();
     }
   }
-  node.add( "spell_power", bs.spell_power );
-  node.add( "spell_hit", bs.spell_hit );
-  node.add( "spell_crit", bs.spell_crit_chance );
-  node.add( "manareg_per_second", bs.manareg_per_second );
-  node.add( "attack_power", bs.attack_power );
-  node.add( "attack_hit", bs.attack_hit );
-  node.add( "mh_attack_expertise", bs.mh_attack_expertise );
-  node.add( "oh_attack_expertise", bs.oh_attack_expertise );
-  node.add( "armor", bs.armor );
-  node.add( "miss", bs.miss );
-  node.add( "crit", bs.crit );
-  node.add( "dodge", bs.dodge );
-  node.add( "parry", bs.parry );
-  node.add( "block", bs.block );
-  node.add( "bonus_armor", bs.bonus_armor );
-  node.add( "spell_haste", bs.spell_haste );
-  node.add( "spell_speed", bs.spell_speed );
-  node.add( "attack_haste", bs.attack_haste );
-  node.add( "attack_speed", bs.attack_speed );
-  node.add( "mastery_value", bs.mastery_value );
-  node.add( "damage_versatility", bs.damage_versatility );
-  node.add( "heal_versatility", bs.heal_versatility );
-  node.add( "mitigation_versatility", bs.mitigation_versatility );
-  node.add( "leech", bs.leech );
-  node.add( "run_speed", bs.run_speed );
-  node.add( "avoidance", bs.avoidance );
-  node.add( "leech", bs.leech );
-  return node;
-}
-
-js::sc_js_t to_json(
-    const player_collected_data_t::action_sequence_data_t& asd )
-{
-  js::sc_js_t node;
-  node.set( "time", to_json( asd.time ) );
+  if ( resources )
+    w.EndArray();
+
+  array_value( w, "spell_power", bs.spell_power );
+  array_value( w, "spell_hit", bs.spell_hit );
+  array_value( w, "spell_crit", bs.spell_crit_chance );
+  array_value( w, "manareg_per_second", bs.manareg_per_second );
+  array_value( w, "attack_power", bs.attack_power );
+  array_value( w, "attack_hit", bs.attack_hit );
+  array_value( w, "mh_attack_expertise", bs.mh_attack_expertise );
+  array_value( w, "oh_attack_expertise", bs.oh_attack_expertise );
+  array_value( w, "armor", bs.armor );
+  array_value( w, "miss", bs.miss );
+  array_value( w, "crit", bs.crit );
+  array_value( w, "dodge", bs.dodge );
+  array_value( w, "parry", bs.parry );
+  array_value( w, "block", bs.block );
+  array_value( w, "bonus_armor", bs.bonus_armor );
+  array_value( w, "spell_haste", bs.spell_haste );
+  array_value( w, "spell_speed", bs.spell_speed );
+  array_value( w, "attack_haste", bs.attack_haste );
+  array_value( w, "attack_speed", bs.attack_speed );
+  array_value( w, "mastery_value", bs.mastery_value );
+  array_value( w, "damage_versatility", bs.damage_versatility );
+  array_value( w, "heal_versatility", bs.heal_versatility );
+  array_value( w, "mitigation_versatility", bs.mitigation_versatility );
+  // Leech has always been written twice
+  w.Key( "leech" );
+  w.StartArray();
+  write( w, bs.leech );
+  write( w, bs.leech );
+  w.EndArray();
+  array_value( w, "run_speed", bs.run_speed );
+  array_value( w, "avoidance", bs.avoidance );
+  w.EndObject();
+}
+
+void write( json_writer_t& w, const player_collected_data_t::action_sequence_data_t& asd )
+{
+  w.StartObject();
+  member( w, "time", asd.time );
   if ( asd.action )
   {
-    node.set( "action_name", asd.action->name() );
-    node.set( "target_name", asd.target->name() );
+    member( w, "action_name", asd.action->name() );
+    member( w, "target_name", asd.target->name() );
   }
   else
   {
-    node.set( "wait_time", to_json( asd.wait_time ) );
+    member( w, "wait_time", asd.wait_time );
   }
-  for ( const auto& buff : asd.buff_list )
+  if ( ! asd.buff_list.empty() )
   {
-    js::sc_js_t bnode;
-    bnode.set( "name", buff.first->name() );
-    bnode.set( "stacks", buff.second );
-    node.add( "buffs", bnode );
+    w.Key( "buffs" );
+    w.StartArray();
+    for ( const auto& buff : asd.buff_list )
+    {
+      w.StartObject();
+      member( w, "name", buff.first->name() );
+      member( w, "stacks", buff.second );
+      w.EndObject();
+    }
+    w.EndArray();
   }
 
-  js::sc_js_t resource_snapshot;
+  w.Key( "resource_snapshot" );
+  w.StartObject();
   for ( resource_e r = RESOURCE_NONE; r < RESOURCE_MAX; ++r )
   {
     if ( asd.resource_snapshot[ r ] >= 0.0 )
     {
-      resource_snapshot.set( util::resource_type_string( r ),
-                             asd.resource_snapshot[ r ] );
+      member( w, util::resource_type_string( r ), asd.resource_snapshot[ r ] );
     }
   }
-  node.set( "resource_snapshot", resource_snapshot );
+  w.EndObject();
 
-  js::sc_js_t resource_max_snapshot;
+  w.Key( "resource_max_snapshot" );
+  w.StartObject();
   for ( resource_e r = RESOURCE_NONE; r < RESOURCE_MAX; ++r )
   {
     if ( asd.resource_max_snapshot[ r ] >= 0.0 )
     {
-      resource_max_snapshot.set( util::resource_type_string( r ),
-                                 asd.resource_max_snapshot[ r ] );
+      member( w, util::resource_type_string( r ), asd.resource_max_snapshot[ r ] );
     }
   }
-  node.set( "resource_max_snapshot", resource_max_snapshot );
-
-  return node;
-}
-
-js::sc_js_t to_json( const player_collected_data_t& cd, const sim_t& sim )
-{
-  js::sc_js_t node;
-  node.set( "fight_length", to_json( cd.fight_length ) );
-  node.set( "waiting_time", to_json( cd.waiting_time ) );
-  node.set( "executed_foreground_actions",
-            to_json( cd.executed_foreground_actions ) );
-  node.set( "dmg", to_json( cd.dmg ) );
-  node.set( "compound_dmg", to_json( cd.compound_dmg ) );
-  node.set( "prioritydps", to_json( cd.prioritydps ) );
-  node.set( "dps", to_json( cd.dps ) );
-  node.set( "dpse", to_json( cd.dpse ) );
-  node.set( "dtps", to_json( cd.dtps ) );
-  node.set( "dmg_taken", to_json( cd.dmg_taken ) );
-  node.set( "timeline_dmg", to_json( cd.timeline_dmg ) );
-  node.set( "timeline_dmg_taken", to_json( cd.timeline_dmg_taken ) );
-
-  node.set( "heal", to_json( cd.heal ) );
-  node.set( "compound_heal", to_json( cd.compound_heal ) );
-  node.set( "hps", to_json( cd.hps ) );
-  node.set( "hpse", to_json( cd.hpse ) );
-  node.set( "htps", to_json( cd.htps ) );
-  node.set( "heal_taken", to_json( cd.heal_taken ) );
-  node.set( "timeline_healing_taken", to_json( cd.timeline_healing_taken ) );
-
-  node.set( "absorb", to_json( cd.absorb ) );
-  node.set( "compound_absorb", to_json( cd.compound_absorb ) );
-  node.set( "aps", to_json( cd.aps ) );
-  node.set( "atps", to_json( cd.atps ) );
-  node.set( "absorb_taken", to_json( cd.absorb_taken ) );
-
-  node.set( "deaths", to_json( cd.deaths ) );
-  node.set( "theck_meloree_index", to_json( cd.theck_meloree_index ) );
-  node.set( "effective_theck_meloree_index",
-            to_json( cd.effective_theck_meloree_index ) );
-  node.set( "max_spike_amount", to_json( cd.max_spike_amount ) );
-
-  node.set( "target_metric", to_json( cd.target_metric ) );
+  w.EndObject();
+
+  w.EndObject();
+}
+
+void write( json_writer_t& w, const player_collected_data_t& cd, const sim_t& sim )
+{
+  w.StartObject();
+  member( w, "fight_length", cd.fight_length );
+  member( w, "waiting_time", cd.waiting_time );
+  member( w, "executed_foreground_actions", cd.executed_foreground_actions );
+  member( w, "dmg", cd.dmg );
+  member( w, "compound_dmg", cd.compound_dmg );
+  member( w, "prioritydps", cd.prioritydps );
+  member( w, "dps", cd.dps );
+  member( w, "dpse", cd.dpse );
+  member( w, "dtps", cd.dtps );
+  member( w, "dmg_taken", cd.dmg_taken );
+  member( w, "timeline_dmg", cd.timeline_dmg );
+  member( w, "timeline_dmg_taken", cd.timeline_dmg_taken );
+
+  member( w, "heal", cd.heal );
+  member( w, "compound_heal", cd.compound_heal );
+  member( w, "hps", cd.hps );
+  member( w, "hpse", cd.hpse );
+  member( w, "htps", cd.htps );
+  member( w, "heal_taken", cd.heal_taken );
+  member( w, "timeline_healing_taken", cd.timeline_healing_taken );
+
+  member( w, "absorb", cd.absorb );
+  member( w, "compound_absorb", cd.compound_absorb );
+  member( w, "aps", cd.aps );
+  member( w, "atps", cd.atps );
+  member( w, "absorb_taken", cd.absorb_taken );
+
+  member( w, "deaths", cd.deaths );
+  member( w, "theck_meloree_index", cd.theck_meloree_index );
+  member( w, "effective_theck_meloree_index", cd.effective_theck_meloree_index );
+  member( w, "max_spike_amount", cd.max_spike_amount );
+
+  member( w, "target_metric", cd.target_metric );
 
   if ( sim.report_details != 0 )
   {
-    js::sc_js_t resource_lost;
+    w.Key( "resource_lost" );
+    w.StartObject();
     for ( resource_e r = RESOURCE_NONE; r < RESOURCE_MAX; ++r )
     {
-      resource_lost.set( util::resource_type_string( r ),
-                         to_json( cd.resource_lost[ r ] ) );
+      member( w, util::resource_type_string( r ), cd.resource_lost[ r ] );
     }
-    node.set( "resource_lost", resource_lost );
+    w.EndObject();
 
-    js::sc_js_t combat_end_resource;
+    w.Key( "combat_end_resource" );
+    w.StartObject();
     for ( resource_e r = RESOURCE_NONE; r < RESOURCE_MAX; ++r )
     {
-      combat_end_resource.set( util::resource_type_string( r ),
-                               to_json( cd.combat_end_resource[ r ] ) );
+      member( w, util::resource_type_string( r ), cd.combat_end_resource[ r ] );
     }
-    node.set( "combat_end_resource", combat_end_resource );
+    w.EndObject();
 
-    for ( const auto& rtl : cd.resource_timelines )
+    if ( ! cd.resource_timelines.empty() )
     {
-      node.add( "resource_timelines", to_json( rtl ) );
-    }
-    for ( const auto& stl : cd.stat_timelines )
-    {
-      node.add( "stat_timelines", to_json( stl ) );
-    }
-    node.set( "health_changes", to_json( cd.health_changes ) );
-    node.set( "health_changes", to_json( cd.health_changes_tmi ) );
-    for ( const auto& asd : cd.action_sequence )
-    {
-      node.add( "action_sequence", to_json( *asd ) );
+      w.Key( "resource_timelines" );
+      w.StartArray();
+      for ( const auto& rtl : cd.resource_timelines )
+      {
+        write( w, rtl );
+      }
+      w.EndArray();
     }
-    for ( const auto& asd : cd.action_sequence_precombat )
+    if ( ! cd.stat_timelines.empty() )
     {
-      node.add( "action_sequence_precombat", to_json( *asd ) );
+      w.Key( "stat_timelines" );
+      w.StartArray();
+      for ( const auto& stl : cd.stat_timelines )
+      {
+        write( w, stl );
+      }
+      w.EndArray();
     }
-    node.set( "buffed_stats_snapshot", to_json( cd.buffed_stats_snapshot ) );
+    // Historically written under the health_changes name
+    member( w, "health_changes", cd.health_changes_tmi );
+    optional_array_member( w, "action_sequence", cd.action_sequence );
+    optional_array_member( w, "action_sequence_precombat", cd.action_sequence_precombat );
+    member( w, "buffed_stats_snapshot", cd.buffed_stats_snapshot );
   }
 
-  return node;
+  w.EndObject();
 }
 
-// Forward declaration
-js::sc_js_t to_json( const player_t& p );
-
-js::sc_js_t to_json( const pet_t::owner_coefficients_t& oc )
+void write( json_writer_t& w, const pet_t::owner_coefficients_t& oc )
 {
-  js::sc_js_t node;
-  node.set( "armor", oc.armor );
-  node.set( "health", oc.health );
-  node.set( "ap_from_ap", oc.ap_from_ap );
-  node.set( "ap_from_sp", oc.ap_from_sp );
-  node.set( "sp_from_ap", oc.sp_from_ap );
-  node.set( "sp_from_sp", oc.sp_from_sp );
-  return node;
+  w.StartObject();
+  member( w, "armor", oc.armor );
+  member( w, "health", oc.health );
+  member( w, "ap_from_ap", oc.ap_from_ap );
+  member( w, "ap_from_sp", oc.ap_from_sp );
+  member( w, "sp_from_ap", oc.sp_from_ap );
+  member( w, "sp_from_sp", oc.sp_from_sp );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const pet_t& p )
+void write( json_writer_t& w, const pet_t& p )
 {
-  js::sc_js_t node;
-  node.set( "stamina_per_owner", p.stamina_per_owner );
-  node.set( "intellect_per_owner", p.intellect_per_owner );
-  node.set( "pet_type", util::pet_type_string( p.pet_type ) );
-  node.set( "stamina_per_owner", p.stamina_per_owner );
-  node.set( "stamina_per_owner", p.stamina_per_owner );
-  node.set( "owner_coefficients", to_json( p.owner_coeff ) );
-  node.add( "", to_json( static_cast<const player_t&>( p ) ) );
-  return node;
+  w.StartObject();
+  member( w, "stamina_per_owner", p.stamina_per_owner );
+  member( w, "intellect_per_owner", p.intellect_per_owner );
+  member( w, "pet_type", util::pet_type_string( p.pet_type ) );
+  member( w, "owner_coefficients", p.owner_coeff );
+  // TODO: The pet's player_t data has never been part of the report (it was added under an
+  // empty path)
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const dbc_t& dbc )
+void write( json_writer_t& w, const dbc_t& dbc )
 {
-  js::sc_js_t node;
+  w.StartObject();
   bool versions[] = {false, true};
   for ( const auto& ptr : versions )
   {
-    js::sc_js_t subnode;
-    subnode.set( "build_level", dbc::build_level( ptr ) );
-    subnode.set( "wow_version", dbc::wow_version( ptr ) );
-    node.set( dbc::wow_ptr_status( ptr ), subnode );
+    w.Key( dbc::wow_ptr_status( ptr ) );
+    w.StartObject();
+    member( w, "build_level", dbc::build_level( ptr ) );
+    member( w, "wow_version", dbc::wow_version( ptr ) );
+    w.EndObject();
   }
-  node.set( "version_used", dbc::wow_ptr_status( dbc.ptr ) );
-  return node;
+  member( w, "version_used", dbc::wow_ptr_status( dbc.ptr ) );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const player_t::base_initial_current_t& )
+void write( json_writer_t& w, const player_t::base_initial_current_t& )
 {
-  js::sc_js_t node;
+  w.StartObject();
   // TODO
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const player_t::diminishing_returns_constants_t& )
+void write( json_writer_t& w, const player_t::diminishing_returns_constants_t& )
 {
-  js::sc_js_t node;
+  w.StartObject();
   // TODO
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const weapon_t& )
+void write( json_writer_t& w, const weapon_t& )
 {
-  js::sc_js_t node;
+  w.StartObject();
   // TODO
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const player_t::resources_t& )
+void write( json_writer_t& w, const player_t::resources_t& )
 {
-  js::sc_js_t node;
+  w.StartObject();
   // TODO
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const player_t::consumables_t& )
+void write( json_writer_t& w, const player_t::consumables_t& )
 {
-  js::sc_js_t node;
+  w.StartObject();
   // TODO
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const player_t& p,
-                     const player_processed_report_information_t& /* ri */ )
+void write( json_writer_t& w, const player_t& p,
+            const player_processed_report_information_t& /* ri */ )
 {
-  js::sc_js_t node;
+  w.StartObject();
   if ( p.sim->scaling->has_scale_factors() )
   {
     if ( p.sim->report_precision < 0 )
@@ -566,339 +735,295 @@ js::sc_js_t to_json( const player_t& p,
     {
       if ( p.scales_with[ i ] )
       {
-        node.set( util::stat_type_abbrev( i ), sf.get_stat( i ) );
+        member( w, util::stat_type_abbrev( i ), sf.get_stat( i ) );
       }
     }
   }
-  return node;
-}
-
-js::sc_js_t to_json( const player_t& p )
-{
-  js::sc_js_t node;
-  node.set( "name", p.name() );
-  node.set( "race", util::race_type_string( p.race ) );
-  node.set( "role", util::role_type_string( p.role ) );
-  node.set( "level", p.true_level );
-  node.set( "party", p.party );
-  node.set( "ready_type", p.ready_type );
-  node.set( "specialization",
-            util::specialization_string( p.specialization() ) );
-  node.set( "bugs", p.bugs );
-  node.set( "scale_player", p.scale_player );
-  node.set( "death_pct", p.death_pct );
-  node.set( "height", p.height );
-  node.set( "combat_reach", p.combat_reach );
-  node.set( "potion_used", p.potion_used );
-  node.set( "timeofday", ( p.timeofday == player_t::NIGHT_TIME ? "NIGHT_TIME"
-                                                               : "DAY_TIME" ) );
-  node.set( "gcd_ready", to_json( p.gcd_ready ) );
-  node.set( "base_gcd", to_json( p.base_gcd ) );
-  node.set( "started_waiting", to_json( p.started_waiting ) );
-  for ( const auto& pet : p.pet_list )
-  {
-    node.add( "pets", to_json( *pet ) );
-  }
-  node.set( "invert_scaling", p.invert_scaling );
-  node.set( "reaction_offset", to_json( p.reaction_offset ) );
-  node.set( "reaction_mean", to_json( p.reaction_mean ) );
-  node.set( "reaction_stddev", to_json( p.reaction_stddev ) );
-  node.set( "reaction_nu", to_json( p.reaction_nu ) );
-  node.set( "world_lag", to_json( p.world_lag ) );
-  node.set( "world_lag_stddev", to_json( p.world_lag_stddev ) );
-  node.set( "brain_lag", to_json( p.brain_lag ) );
-  node.set( "brain_lag_stddev", to_json( p.brain_lag_stddev ) );
-  node.set( "world_lag_override", p.world_lag_override );
-  node.set( "world_lag_stddev_override", p.world_lag_stddev_override );
-  node.set( "dbc", to_json( p.dbc ) );
+  w.EndObject();
+}
+
+void write( json_writer_t& w, const player_t& p )
+{
+  w.StartObject();
+  member( w, "name", p.name() );
+  member( w, "race", util::race_type_string( p.race ) );
+  member( w, "role", util::role_type_string( p.role ) );
+  member( w, "level", p.true_level );
+  member( w, "party", p.party );
+  member( w, "ready_type", p.ready_type );
+  member( w, "specialization", util::specialization_string( p.specialization() ) );
+  member( w, "bugs", p.bugs );
+  member( w, "scale_player", p.scale_player );
+  member( w, "death_pct", p.death_pct );
+  member( w, "height", p.height );
+  member( w, "combat_reach", p.combat_reach );
+  member( w, "potion_used", p.potion_used );
+  member( w, "timeofday", ( p.timeofday == player_t::NIGHT_TIME ? "NIGHT_TIME" : "DAY_TIME" ) );
+  member( w, "gcd_ready", p.gcd_ready );
+  member( w, "base_gcd", p.base_gcd );
+  member( w, "started_waiting", p.started_waiting );
+  optional_array_member( w, "pets", p.pet_list );
+  member( w, "invert_scaling", p.invert_scaling );
+  member( w, "reaction_offset", p.reaction_offset );
+  member( w, "reaction_mean", p.reaction_mean );
+  member( w, "reaction_stddev", p.reaction_stddev );
+  member( w, "reaction_nu", p.reaction_nu );
+  member( w, "world_lag", p.world_lag );
+  member( w, "world_lag_stddev", p.world_lag_stddev );
+  member( w, "brain_lag", p.brain_lag );
+  member( w, "brain_lag_stddev", p.brain_lag_stddev );
+  member( w, "world_lag_override", p.world_lag_override );
+  member( w, "world_lag_stddev_override", p.world_lag_stddev_override );
+  member( w, "dbc", p.dbc );
+  bool professions = false;
   for ( auto i = PROFESSION_NONE; i < PROFESSION_MAX; ++i )
   {
     if ( p.profession[ i ] > 0 )
     {
-      js::sc_js_t pnode;
-      pnode.set( util::profession_type_string( i ), p.profession[ i ] );
-      node.add( "professions", pnode );
+      if ( ! professions )
+      {
+        w.Key( "professions" );
+        w.StartArray();
+        professions = true;
+      }
+      w.StartObject();
+      member( w, util::profession_type_string( i ), p.profession[ i ] );
+      w.EndObject();
     }
   }
-  node.set( "base_stats", to_json( p.base ) );
-  node.set( "initial_stats", to_json( p.initial ) );
-  node.set( "current_stats", to_json( p.current ) );
-  node.set( "base_energy_regen_per_second", p.base_energy_regen_per_second );
-  node.set( "base_focus_regen_per_second", p.base_focus_regen_per_second );
-  node.set( "base_chi_regen_per_second", p.base_chi_regen_per_second );
-  node.set( "diminishing_returns_constants", to_json( p.def_dr ) );
-  node.set( "main_hand_weapon", to_json( p.main_hand_weapon ) );
-  node.set( "off_hand_weapon", to_json( p.off_hand_weapon ) );
-  node.set( "resources", to_json( p.resources ) );
-  node.set( "consumables", to_json( p.consumables ) );
-  node.set( "scale_factors", to_json( p, p.report_information ) );
+  if ( professions )
+    w.EndArray();
+  member( w, "base_stats", p.base );
+  member( w, "initial_stats", p.initial );
+  member( w, "current_stats", p.current );
+  member( w, "base_energy_regen_per_second", p.base_energy_regen_per_second );
+  member( w, "base_focus_regen_per_second", p.base_focus_regen_per_second );
+  member( w, "base_chi_regen_per_second", p.base_chi_regen_per_second );
+  member( w, "diminishing_returns_constants", p.def_dr );
+  member( w, "main_hand_weapon", p.main_hand_weapon );
+  member( w, "off_hand_weapon", p.off_hand_weapon );
+  member( w, "resources", p.resources );
+  member( w, "consumables", p.consumables );
+  w.Key( "scale_factors" );
+  write( w, p, p.report_information );
   // TODO : "plot_data"
 
   // TODO
 
-  node.set( "collected_data", to_json( p.collected_data, p.sim ) );
+  w.Key( "collected_data" );
+  write( w, p.collected_data, *p.sim );
   // TODO
 
   if ( p.sim->report_details != 0 )
   {
-    for ( const auto& buff : p.buff_list )
-    {
-      node.add( "buffs", to_json( *buff ) );
-    }
-    for ( const auto& proc : p.proc_list )
-    {
-      node.add( "procs", to_json( *proc ) );
-    }
-    for ( const auto& gain : p.gain_list )
-    {
-      node.add( "gains", to_json( *gain ) );
-    }
-    for ( const auto& stat : p.stats_list )
-    {
-      node.add( "stats", to_json( *stat ) );
-    }
+    optional_array_member( w, "buffs", p.buff_list );
+    optional_array_member( w, "procs", p.proc_list );
+    optional_array_member( w, "gains", p.gain_list );
+    optional_array_member( w, "stats", p.stats_list );
   }
 
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const rng::rng_t& rng )
+void write( json_writer_t& w, const rng::rng_t& rng )
 {
-  js::sc_js_t node;
-  node.set( "name", rng.name() );
-  return node;
+  w.StartObject();
+  member( w, "name", rng.name() );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const raid_event_t& re )
+void write( json_writer_t& w, const raid_event_t& re )
 {
-  js::sc_js_t node;
-  node.set( "name", re.name() );
-  node.set( "first", to_json( re.first ) );
-  node.set( "last", to_json( re.last ) );
-  node.set( "next", to_json( re.next ) );
-  node.set( "cooldown", to_json( re.cooldown ) );
-  node.set( "cooldown_stddev", to_json( re.cooldown_stddev ) );
-  node.set( "cooldown_min", to_json( re.cooldown_min ) );
-  node.set( "cooldown_max", to_json( re.cooldown_max ) );
-  node.set( "duration", to_json( re.duration ) );
-  node.set( "duration_stddev", to_json( re.duration_stddev ) );
-  node.set( "duration_min", to_json( re.duration_min ) );
-  node.set( "duration_max", to_json( re.duration_max ) );
-  node.set( "distance_min", re.distance_min );
-  node.set( "distance_max", re.distance_max );
-  node.set( "players_only", re.players_only );
-  node.set( "player_chance", re.player_chance );
-  node.set( "affected_role", util::role_type_string( re.affected_role ) );
-  node.set( "saved_duration", to_json( re.saved_duration ) );
-  return node;
+  w.StartObject();
+  member( w, "name", re.name() );
+  member( w, "first", re.first );
+  member( w, "last", re.last );
+  member( w, "next", re.next );
+  member( w, "cooldown", re.cooldown );
+  member( w, "cooldown_stddev", re.cooldown_stddev );
+  member( w, "cooldown_min", re.cooldown_min );
+  member( w, "cooldown_max", re.cooldown_max );
+  member( w, "duration", re.duration );
+  member( w, "duration_stddev", re.duration_stddev );
+  member( w, "duration_min", re.duration_min );
+  member( w, "duration_max", re.duration_max );
+  member( w, "distance_min", re.distance_min );
+  member( w, "distance_max", re.distance_max );
+  member( w, "players_only", re.players_only );
+  member( w, "player_chance", re.player_chance );
+  member( w, "affected_role", util::role_type_string( re.affected_role ) );
+  member( w, "saved_duration", re.saved_duration );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const sim_t::overrides_t& o )
+void write( json_writer_t& w, const sim_t::overrides_t& o )
 {
-  js::sc_js_t node;
-  node.set( "mortal_wounds", o.mortal_wounds );
-  node.set( "bleeding", o.bleeding );
-  node.set( "bloodlust", o.bloodlust );
-  node.set( "target_health", o.target_health );
-  return node;
+  w.StartObject();
+  member( w, "mortal_wounds", o.mortal_wounds );
+  member( w, "bleeding", o.bleeding );
+  member( w, "bloodlust", o.bloodlust );
+  member( w, "target_health", o.target_health );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const scaling_t& /* o */ )
+void write( json_writer_t& w, const scaling_t& /* o */ )
 {
-  js::sc_js_t node;
+  w.StartObject();
   // TODO
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const plot_t& o )
+void write( json_writer_t& w, const plot_t& o )
 {
-  js::sc_js_t node;
-  node.set( "dps_plot_stat_str", o.dps_plot_stat_str );
-  node.set( "dps_plot_step", o.dps_plot_step );
-  node.set( "dps_plot_points", o.dps_plot_points );
-  node.set( "dps_plot_iterations", o.dps_plot_iterations );
-  node.set( "dps_plot_target_error", o.dps_plot_target_error );
-  node.set( "dps_plot_debug", o.dps_plot_debug );
-  node.set( "dps_plot_positive", o.dps_plot_positive );
-  node.set( "dps_plot_negative", o.dps_plot_negative );
-  return node;
+  w.StartObject();
+  member( w, "dps_plot_stat_str", o.dps_plot_stat_str );
+  member( w, "dps_plot_step", o.dps_plot_step );
+  member( w, "dps_plot_points", o.dps_plot_points );
+  member( w, "dps_plot_iterations", o.dps_plot_iterations );
+  member( w, "dps_plot_target_error", o.dps_plot_target_error );
+  member( w, "dps_plot_debug", o.dps_plot_debug );
+  member( w, "dps_plot_positive", o.dps_plot_positive );
+  member( w, "dps_plot_negative", o.dps_plot_negative );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const reforge_plot_t& /* o */ )
+void write( json_writer_t& w, const reforge_plot_t& /* o */ )
 {
-  js::sc_js_t node;
+  w.StartObject();
   // TODO
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const iteration_data_entry_t& ide )
+void write( json_writer_t& w, const iteration_data_entry_t& ide )
 {
-  js::sc_js_t node;
-  node.set( "metric", ide.metric );
-  node.set( "seed", ide.seed );
-  node.set( "target_health", ide.target_health );
-  return node;
+  w.StartObject();
+  member( w, "metric", ide.metric );
+  member( w, "seed", ide.seed );
+  member( w, "target_health", ide.target_health );
+  w.EndObject();
 }
 
-js::sc_js_t to_json( const sim_t& sim )
+// Write an array member from a range of objects held by value
+template <typename Range>
+void optional_value_array_member( json_writer_t& w, const char* name, const Range& range )
 {
-  js::sc_js_t node;
-  node.set( "debug", sim.debug );
-  node.set( "max_time", to_json( sim.max_time ) );
-  node.set( "expected_iteration_time", to_json( sim.expected_iteration_time ) );
-  node.set( "vary_combat_length", sim.vary_combat_length );
-  node.set( "iterations", sim.iterations );
-  node.set( "target_error", sim.target_error );
-  for ( const auto& player : sim.player_no_pet_list.data() )
-  {
-    node.add( "players", to_json( *player ) );
-  }
-  if ( sim.report_details != 0 )
+  if ( range.begin() != range.end() )
   {
-    for ( const auto& healing : sim.healing_no_pet_list.data() )
+    w.Key( name );
+    w.StartArray();
+    for ( const auto& elem : range )
     {
-      node.add( "healing_players", to_json( *healing ) );
+      write( w, elem );
     }
-    for ( const auto& target : sim.target_list.data() )
-    {
-      node.add( "target", to_json( *target ) );
-    }
-  }
-  node.set( "queue_lag", to_json( sim.queue_lag ) );
-  node.set( "queue_lag_stddev", to_json( sim.queue_lag_stddev ) );
-  node.set( "gcd_lag", to_json( sim.gcd_lag ) );
-  node.set( "gcd_lag_stddev", to_json( sim.gcd_lag_stddev ) );
-  node.set( "channel_lag", to_json( sim.channel_lag ) );
-  node.set( "channel_lag_stddev", to_json( sim.channel_lag_stddev ) );
-  node.set( "queue_gcd_reduction", to_json( sim.queue_gcd_reduction ) );
-  node.set( "strict_gcd_queue", sim.strict_gcd_queue );
-  node.set( "confidence", sim.confidence );
-  node.set( "confidence_estimator", sim.confidence_estimator );
-  node.set( "world_lag", to_json( sim.world_lag ) );
-  node.set( "world_lag_stddev", to_json( sim.world_lag_stddev ) );
-  node.set( "travel_variance", sim.travel_variance );
-  node.set( "default_skill", sim.default_skill );
-  node.set( "reaction_time", to_json( sim.reaction_time ) );
-  node.set( "regen_periodicity", to_json( sim.regen_periodicity ) );
-  node.set( "ignite_sampling_delta", to_json( sim.ignite_sampling_delta ) );
-  node.set( "fixed_time", sim.fixed_time );
-  node.set( "optimize_expressions", sim.optimize_expressions );
-  node.set( "optimal_raid", sim.optimal_raid );
-  node.set( "log", sim.log );
-  node.set( "debug_each", sim.debug_each );
-  node.set( "auto_ready_trigger", sim.auto_ready_trigger );
-  node.set( "stat_cache", sim.stat_cache );
-  node.set( "max_aoe_enemies", sim.max_aoe_enemies );
-  node.set( "show_etmi", sim.show_etmi );
-  node.set( "tmi_window_global", sim.tmi_window_global );
-  node.set( "tmi_bin_size", sim.tmi_bin_size );
-  node.set( "requires_regen_event", sim.requires_regen_event );
-  node.set( "enemy_death_pct", sim.enemy_death_pct );
-  node.set( "dbc", to_json( sim.dbc ) );
-  node.set( "challenge_mode", sim.challenge_mode );
-  node.set( "pvp_crit", sim.pvp_crit );
-  node.set( "rng", to_json( sim.rng() ) );
-  node.set( "rng_seed", sim.seed );
-  node.set( "deterministic", sim.deterministic );
-  node.set( "average_range", sim.average_range );
-  node.set( "average_gauss", sim.average_gauss );
-  for ( const auto& re : sim.raid_events )
-  {
-    node.add( "raid_events", to_json( *re ) );
-  }
-  node.set( "fight_style", sim.fight_style );
-  node.set( "overrides", to_json( sim.overrides ) );
-  for ( const auto& buff : sim.buff_list )
-  {
-    node.add( "buffs", to_json( *buff ) );
-  }
-  node.set( "default_aura_delay", to_json( sim.default_aura_delay ) );
-  node.set( "default_aura_delay_stddev",
-            to_json( sim.default_aura_delay_stddev ) );
-  for ( const auto& cooldown : sim.cooldown_list )
-  {
-    node.add( "cooldowns", to_json( *cooldown ) );
-  }
-  node.set( "scaling", to_json( *sim.scaling ) );
-  node.set( "plot", to_json( *sim.plot ) );
-  node.set( "reforge_plot", to_json( *sim.reforge_plot ) );
-  node.set( "elapsed_cpu", sim.elapsed_cpu );
-  node.set( "elapsed_time", sim.elapsed_time );
-  node.set( "raid_dps", to_json( sim.raid_dps ) );
-  node.set( "total_dmg", to_json( sim.total_dmg ) );
-  node.set( "raid_hps", to_json( sim.raid_hps ) );
-  node.set( "total_heal", to_json( sim.total_heal ) );
-  node.set( "total_absorb", to_json( sim.total_absorb ) );
-  node.set( "raid_aps", to_json( sim.raid_aps ) );
-  node.set( "simulation_length", to_json( sim.simulation_length ) );
-  for ( const auto& id : sim.iteration_data )
-  {
-    node.add( "iteration_data", to_json( id ) );
-  }
-  for ( const auto& id : sim.low_iteration_data )
-  {
-    node.add( "low_iteration_data", to_json( id ) );
+    w.EndArray();
   }
-  for ( const auto& id : sim.high_iteration_data )
+}
+
+void write( json_writer_t& w, const sim_t& sim )
+{
+  w.StartObject();
+  member( w, "debug", sim.debug );
+  member( w, "max_time", sim.max_time );
+  member( w, "expected_iteration_time", sim.expected_iteration_time );
+  member( w, "vary_combat_length", sim.vary_combat_length );
+  member( w, "iterations", sim.iterations );
+  member( w, "target_error", sim.target_error );
+  optional_array_member( w, "players", sim.player_no_pet_list.data() );
+  if ( sim.report_details != 0 )
   {
-    node.add( "high_iteration_data", to_json( id ) );
+    optional_array_member( w, "healing_players", sim.healing_no_pet_list.data() );
+    optional_array_member( w, "target", sim.target_list.data() );
   }
-  for ( const auto& error : sim.error_list )
+  member( w, "queue_lag", sim.queue_lag );
+  member( w, "queue_lag_stddev", sim.queue_lag_stddev );
+  member( w, "gcd_lag", sim.gcd_lag );
+  member( w, "gcd_lag_stddev", sim.gcd_lag_stddev );
+  member( w, "channel_lag", sim.channel_lag );
+  member( w, "channel_lag_stddev", sim.channel_lag_stddev );
+  member( w, "queue_gcd_reduction", sim.queue_gcd_reduction );
+  member( w, "strict_gcd_queue", sim.strict_gcd_queue );
+  member( w, "confidence", sim.confidence );
+  member( w, "confidence_estimator", sim.confidence_estimator );
+  member( w, "world_lag", sim.world_lag );
+  member( w, "world_lag_stddev", sim.world_lag_stddev );
+  member( w, "travel_variance", sim.travel_variance );
+  member( w, "default_skill", sim.default_skill );
+  member( w, "reaction_time", sim.reaction_time );
+  // Resources regenerate continuously: no periodicity, and no regen event. Kept for readers of
+  // the report format.
+  member( w, "regen_periodicity", timespan_t::zero() );
+  member( w, "ignite_sampling_delta", sim.ignite_sampling_delta );
+  member( w, "fixed_time", sim.fixed_time );
+  member( w, "optimize_expressions", sim.optimize_expressions );
+  member( w, "optimal_raid", sim.optimal_raid );
+  member( w, "log", sim.log );
+  member( w, "debug_each", sim.debug_each );
+  member( w, "auto_ready_trigger", sim.auto_ready_trigger );
+  member( w, "stat_cache", sim.stat_cache );
+  member( w, "max_aoe_enemies", sim.max_aoe_enemies );
+  member( w, "show_etmi", sim.show_etmi );
+  member( w, "tmi_window_global", sim.tmi_window_global );
+  member( w, "tmi_bin_size", sim.tmi_bin_size );
+  member( w, "requires_regen_event", false );
+  member( w, "enemy_death_pct", sim.enemy_death_pct );
+  member( w, "dbc", sim.dbc );
+  member( w, "challenge_mode", sim.challenge_mode );
+  member( w, "pvp_crit", sim.pvp_crit );
+  member( w, "rng", sim.rng() );
+  member( w, "rng_seed", sim.seed );
+  member( w, "deterministic", sim.deterministic );
+  member( w, "average_range", sim.average_range );
+  member( w, "average_gauss", sim.average_gauss );
+  optional_array_member( w, "raid_events", sim.raid_events );
+  member( w, "fight_style", sim.fight_style );
+  member( w, "overrides", sim.overrides );
+  optional_array_member( w, "buffs", sim.buff_list );
+  member( w, "default_aura_delay", sim.default_aura_delay );
+  member( w, "default_aura_delay_stddev", sim.default_aura_delay_stddev );
+  optional_array_member( w, "cooldowns", sim.cooldown_list );
+  member( w, "scaling", *sim.scaling );
+  member( w, "plot", *sim.plot );
+  member( w, "reforge_plot", *sim.reforge_plot );
+  member( w, "elapsed_cpu", sim.elapsed_cpu );
+  member( w, "elapsed_time", sim.elapsed_time );
+  member( w, "raid_dps", sim.raid_dps );
+  member( w, "total_dmg", sim.total_dmg );
+  member( w, "raid_hps", sim.raid_hps );
+  member( w, "total_heal", sim.total_heal );
+  member( w, "total_absorb", sim.total_absorb );
+  member( w, "raid_aps", sim.raid_aps );
+  member( w, "simulation_length", sim.simulation_length );
+  optional_value_array_member( w, "iteration_data", sim.iteration_data );
+  optional_value_array_member( w, "low_iteration_data", sim.low_iteration_data );
+  optional_value_array_member( w, "high_iteration_data", sim.high_iteration_data );
+  if ( ! sim.error_list.empty() )
   {
-    node.add( "errors", error );
+    member( w, "errors", sim.error_list );
   }
 
-  return node;
+  w.EndObject();
 }
 
-js::sc_js_t get_root( const sim_t& sim )
+void write_root( json_writer_t& w, const sim_t& sim )
 {
-  js::sc_js_t root;
-  root.set( "version", SC_VERSION );
-  root.set( "ptr_enabled", SC_USE_PTR );
-  root.set( "beta_enabled", SC_BETA );
-  root.set( "build_date", __DATE__ );
-  root.set( "build_time", __TIME__ );
-  root.set( "sim", to_json( sim ) );
-  return root;
+  w.StartObject();
+  member( w, "version", SC_VERSION );
+  member( w, "ptr_enabled", SC_USE_PTR );
+  member( w, "beta_enabled", SC_BETA );
+  member( w, "build_date", __DATE__ );
+  member( w, "build_time", __TIME__ );
+  member( w, "sim", sim );
+  w.EndObject();
 }
-/*
-void print_json_raw( FILE* o, const sim_t& sim )
-{
-  js::sc_js_t root = get_root( sim );
-  std::array<char, 1024> buffer;
-  rapidjson::FileWriteStream b( o, buffer.data(), buffer.size() );
-  rapidjson::Writer<rapidjson::FileWriteStream> writer( b );
-  root.js_.Accept( writer );
-}*/
 
 void print_json_pretty( FILE* o, const sim_t& sim )
 {
-  js::sc_js_t root = get_root( sim );
-  std::array<char, 1024> buffer;
+  std::vector<char> buffer( 1 << 16 );
   rapidjson::FileWriteStream b( o, buffer.data(), buffer.size() );
-  rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer( b );
-  root.js_.Accept( writer );
+  json_writer_t writer( b );
+  write_root( writer, sim );
+  b.Flush();
 }
-/*
-std::string print_json_string_raw( const sim_t& sim )
-{
-  js::sc_js_t root = get_root( sim );
-  rapidjson::StringBuffer b;
-  rapidjson::Writer<rapidjson::StringBuffer> writer( b );
-  root.js_.Accept( writer );
-  return b.GetString();
-}
-
-std::string print_json_string_pretty( const sim_t& sim )
-{
-  js::sc_js_t root = get_root( sim );
-  rapidjson::StringBuffer b;
-  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer( b );
-  root.js_.Accept( writer );
-  return b.GetString();
-}
-*/
 }  // unnamed namespace
 
 namespace report
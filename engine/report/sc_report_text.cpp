@@ -757,6 +757,7 @@ void print_text_performance( FILE* file, sim_t* sim )
       "  MaxQueueDepth = %u\n"
       "  AvgQueueDepth = %.3f\n"
 #endif
+      "  TargetCache   = %.0f rebuilds, %.0f incremental updates\n"
       "  TargetHealth  = %.0f\n"
       "  SimSeconds    = %.0f\n"
       "  CpuSeconds    = %.3f\n"
@@ -774,6 +775,8 @@ void print_text_performance( FILE* file, sim_t* sim )
       static_cast<double>( sim->event_mgr.events_traversed ) /
           sim->event_mgr.events_added,
 #endif
+      static_cast<double>( sim->target_cache_rebuilds ),
+      static_cast<double>( sim->target_cache_updates ),
       sim->target->resources.base[ RESOURCE_HEALTH ],
       sim->iterations * sim->simulation_length.mean(), sim->elapsed_cpu,
       sim->elapsed_time,
@@ -1101,6 +1104,92 @@ void print_text_monitor_cpu( FILE* file, sim_t* sim )
 #endif  // ACTOR_EVENT_BOOKKEEPING
 }
 
+void print_text_monitor_init( FILE* file, sim_t* sim )
+{
+  if ( !sim->monitor_init )
+    return;
+
+  static const char* phase_names[] = {
+    "Actor Initialization", "Items", "Special Effects", "  Enchants",
+    "Action Lists", "Actions" };
+  static_assert( sizeof( phase_names ) / sizeof( phase_names[ 0 ] ) == INIT_PHASE_MAX,
+                 "Missing actor initialization phase names" );
+
+  double total_time = sim->init_phase_time[ INIT_PHASE_ACTOR ];
+
+  util::fprintf( file, "\nInit Monitor CPU Report:\n" );
+  for ( size_t i = 0; i < INIT_PHASE_MAX; ++i )
+  {
+    util::fprintf( file, "%10.4fsec / %6.2f%% : %s\n", sim->init_phase_time[ i ],
+                   total_time > 0 ? sim->init_phase_time[ i ] / total_time * 100.0 : 0.0,
+                   phase_names[ i ] );
+  }
+}
+
+void print_text_allocation_audit( FILE* file, sim_t* sim )
+{
+  if ( !sim->allocation_audit || sim->allocation_audit_iterations == 0 )
+    return;
+
+  util::fprintf( file, "\nAllocation Audit:\n" );
+  util::fprintf( file, "  %.0f allocations in %d iterations after the first one, %.2f per iteration\n",
+                 static_cast<double>( sim->allocation_audit_count ), sim->allocation_audit_iterations,
+                 static_cast<double>( sim->allocation_audit_count ) / sim->allocation_audit_iterations );
+
+  for ( const auto& site : allocation_audit::call_sites( 30 ) )
+  {
+    util::fprintf( file, "  %12.2f / iteration : %s\n",
+                   static_cast<double>( site.second ) / sim->allocation_audit_iterations,
+                   site.first.c_str() );
+  }
+}
+
+void print_text_state_allocation( FILE* file, sim_t* sim )
+{
+  util::fprintf( file, "\nAction State Allocation:\n" );
+
+  for ( const auto& player : sim->player_no_pet_list.data() )
+  {
+    // Pets are accounted to their owner
+    uint64_t allocated = player->state_pool.n_allocated;
+    uint64_t steady = player->state_pool.n_steady_allocated;
+    size_t types = player->state_pool.free_lists.size();
+    for ( const auto& pet : player->pet_list )
+    {
+      allocated += pet->state_pool.n_allocated;
+      steady += pet->state_pool.n_steady_allocated;
+      types += pet->state_pool.free_lists.size();
+    }
+
+    util::fprintf( file, "  %-20s allocated=%-8.0f after_first_iteration=%-8.0f state_types=%u\n",
+                   player->name(), static_cast<double>( allocated ),
+                   static_cast<double>( steady ), static_cast<unsigned>( types ) );
+  }
+}
+
+void print_text_callback_dispatch( FILE* file, sim_t* sim )
+{
+  bool header = false;
+
+  for ( const auto& player : sim->player_no_pet_list.data() )
+  {
+    uint64_t total = player->callbacks.n_invoked + player->callbacks.n_skipped;
+    if ( total == 0 )
+      continue;
+
+    if ( !header )
+    {
+      util::fprintf( file, "\nProc Callback Dispatch:\n" );
+      header = true;
+    }
+
+    util::fprintf( file, "  %-20s invoked=%-12.0f skipped=%-12.0f (%.2f%% skipped)\n",
+                   player->name(), static_cast<double>( player->callbacks.n_invoked ),
+                   static_cast<double>( player->callbacks.n_skipped ),
+                   100.0 * player->callbacks.n_skipped / total );
+  }
+}
+
 // print_text_player ========================================================
 
 void print_text_player( FILE* file, player_t* p )
@@ -1314,6 +1403,10 @@ void print_text_report( FILE* file, sim_t* sim, bool detail )
     print_text_scale_factors( file, sim );
     print_text_reference_dps( file, sim );
     print_text_monitor_cpu( file, sim );
+    print_text_monitor_init( file, sim );
+    print_text_callback_dispatch( file, sim );
+    print_text_state_allocation( file, sim );
+    print_text_allocation_audit( file, sim );
   }
 
   util::fprintf( file, "\n" );
@@ -23,20 +23,14 @@ enum
 
 enum regen_type_e
 {
-  /**
-   * @brief Old resource regeneration model.
-   *
-   * Actors regen every 'periodicity' seconds through a single global event.
-   * Default.
-   */
-  REGEN_STATIC,
-
   /**
    * @brief Dynamic resource regeneration model.
    *
-   * Resources are regenerated at dynamic intervals when an actor is about to
-   * execute an action, and when the state of the actor changes in a way that
-   * affects resource regeneration.
+   * Resources regenerate linearly between changes of the regeneration rate,
+   * and are brought up to date (player_t::do_dynamic_regen()) when an actor is
+   * about to execute an action, when a regenerating resource is read, gained,
+   * or spent, and when the state of the actor changes in a way that affects
+   * resource regeneration. No periodic events are used. Default.
    *
    * See comment on player_t::regen_caches how to define what state changes
    * affect resource regneration.
@@ -1174,3 +1168,15 @@ enum haste_type_e
   HASTE_ANY, // Special value to indicate any (all) haste types
   SPEED_ANY,
 };
+
+// Actor initialization phases timed by monitor_init=1
+enum init_phase_e
+{
+  INIT_PHASE_ACTOR = 0U,      // Full actor initialization, all of the below included
+  INIT_PHASE_ITEMS,
+  INIT_PHASE_SPECIAL_EFFECTS,
+  INIT_PHASE_ENCHANTS,        // Part of INIT_PHASE_SPECIAL_EFFECTS
+  INIT_PHASE_ACTION_LISTS,
+  INIT_PHASE_ACTIONS,
+  INIT_PHASE_MAX
+};
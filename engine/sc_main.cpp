@@ -136,23 +136,61 @@ std::string get_cache_directory()
   return s;
 }
 
+// Find the binary client data file given on the command line. It must be known before the
+// database is initialized, so it cannot be picked up by the regular option parsing.
+std::string data_file_name( const std::vector<std::string>& args )
+{
+  std::string file_name;
+
+  for ( size_t i = 0; i < args.size(); ++i )
+  {
+    if ( util::str_prefix_ci( args[ i ], "dbc_file=" ) )
+      file_name = args[ i ].substr( 9 );
+  }
+
+  return file_name;
+}
+
+// dbc_file= is also accepted by the option parser, so that it can be given on the command line
+// alongside the rest of the options. Anywhere else (in an options file, or a batch entry) it would
+// come too late to take effect.
+bool check_data_file_option( const sim_t& sim, const std::string& data_file, std::string& error )
+{
+  if ( sim.dbc_file_str == data_file )
+    return true;
+
+  error = "dbc_file= must be given on the command line, not in an options file";
+  return false;
+}
+
 // RAII-wrapper for dbc init / de-init
 struct dbc_initializer_t {
-  dbc_initializer_t()
-  { dbc::init(); }
+  // Non-empty if the client data file could not be used
+  std::string error;
+
+  dbc_initializer_t( const std::string& data_file = std::string() )
+  {
+    if ( ! data_file.empty() && ! dbc::data_file::load( data_file, error ) )
+    {
+      error = "Unable to use client data file '" + data_file + "': " + error;
+    }
+
+    dbc::init();
+  }
   ~dbc_initializer_t()
-  { dbc::de_init(); }
+  {
+    dbc::de_init();
+    if ( dbc::data_file::loaded() )
+      dbc::data_file::unload();
+  }
 };
 
-// RAII-wrapper for http cache load / save
+// RAII-wrapper for http cache open / close
 struct cache_initializer_t {
-  cache_initializer_t( const std::string& fn ) :
-    _file_name( fn )
-  { http::cache_load( _file_name ); }
+  cache_initializer_t( const std::string& directory )
+  { http::cache_open( directory ); }
   ~cache_initializer_t()
-  { http::cache_save( _file_name ); }
-private:
-  std::string _file_name;
+  { http::cache_close(); }
 };
 
 struct special_effect_initializer_t
@@ -167,21 +205,370 @@ struct special_effect_initializer_t
   { unique_gear::unregister_special_effects(); }
 };
 
+// Batch mode ==============================================================
+
+// Find the batch manifest file, and the number of concurrently simulated batch entries, given on
+// the command line. Both are process-level options, and are removed from the arguments that are
+// passed on to the simulation of each batch entry.
+std::string batch_file_name( std::vector<std::string>& args, unsigned& batch_threads )
+{
+  std::string file_name;
+
+  for ( auto it = args.begin(); it != args.end(); )
+  {
+    if ( util::str_prefix_ci( *it, "batch=" ) )
+    {
+      file_name = it -> substr( 6 );
+      it = args.erase( it );
+    }
+    else if ( util::str_prefix_ci( *it, "batch_threads=" ) )
+    {
+      batch_threads = util::to_unsigned( it -> substr( 14 ) );
+      it = args.erase( it );
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  return file_name;
+}
+
+// Find the options on the command line that change process-wide state (the http proxy and the
+// cache behavior). They are applied once for the whole batch, and removed from the arguments that
+// are passed on to the simulation of each batch entry, where they are rejected.
+std::vector<std::string> batch_process_args( std::vector<std::string>& args )
+{
+  static const char* const names[] = { "proxy=", "cache_players=", "cache_items=" };
+
+  std::vector<std::string> process_args;
+  for ( auto it = args.begin(); it != args.end(); )
+  {
+    auto is_process_arg = [ it ]( const char* n ) { return util::str_prefix_ci( *it, n ); };
+    if ( range::find_if( names, is_process_arg ) != range::end( names ) )
+    {
+      process_args.push_back( *it );
+      it = args.erase( it );
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  return process_args;
+}
+
+/* Simulate a manifest of profiles in a single process. Each non-empty line of the manifest (lines
+ * starting with '#' are comments) holds the arguments of one batch entry, in the same format as
+ * the command line (for example a profile file name, followed by option overrides). Options given
+ * on the command line are applied to all entries before the entry-specific ones.
+ *
+ * Client data, class modules, hotfixes and the special effect database are initialized once for
+ * the whole batch. Up to batch_threads entries are simulated concurrently, each with its own
+ * threads= setting. Each entry runs, and writes its reports, the same way as a single simulation.
+ * Each entry writes a JSON report, by default to <manifest>_<line>.json unless the entry defines
+ * json=, and a text report only to output=. Options that change the process-wide client data
+ * (override.spell_data=) are rejected. The http proxy and cache options are only accepted on the
+ * command line, where they apply to the whole batch, and the cache era advances once per batch.
+ */
+struct batch_t
+{
+  struct entry_t
+  {
+    unsigned line;
+    std::vector<std::string> args;
+  };
+
+  struct worker_t : public sc_thread_t
+  {
+    batch_t& batch;
+
+    worker_t( batch_t& b ) : batch( b )
+    { }
+
+    void run() override
+    { batch.run_entries(); }
+  };
+
+  std::string file_name, data_file;
+  std::vector<std::string> common_args, process_args;
+  std::vector<entry_t> entries;
+  unsigned n_threads;
+
+  mutex_t mutex;
+  size_t next_entry;
+  unsigned n_failed;
+
+  batch_t( const std::string& file, const std::string& data, const std::vector<std::string>& args,
+           unsigned threads ) :
+    file_name( file ), data_file( data ), common_args( args ), n_threads( std::max( 1U, threads ) ),
+    next_entry( 0 ), n_failed( 0 )
+  { process_args = batch_process_args( common_args ); }
+
+  // Apply the process-wide options once, before any entry is simulated
+  bool setup_process()
+  {
+    sim_t sim;
+    try
+    {
+      for ( const auto& arg : process_args )
+      {
+        std::string::size_type eq = arg.find( '=' );
+        if ( ! sim.parse_option( arg.substr( 0, eq ), arg.substr( eq + 1 ) ) )
+        {
+          std::cerr << "ERROR! Invalid option '" << arg << "'" << std::endl;
+          return false;
+        }
+      }
+    }
+    catch ( const std::exception& e )
+    {
+      std::cerr << "ERROR! Invalid option: " << e.what() << std::endl;
+      return false;
+    }
+
+    cache::advance_era();
+    return true;
+  }
+
+  bool read_manifest()
+  {
+    io::ifstream manifest;
+    manifest.open( file_name );
+    if ( ! manifest.is_open() )
+    {
+      std::cerr << "ERROR! Unable to open batch manifest '" << file_name << "'" << std::endl;
+      return false;
+    }
+
+    std::string line;
+    unsigned line_number = 0;
+    while ( std::getline( manifest, line ) )
+    {
+      ++line_number;
+
+      entry_t entry;
+      entry.line = line_number;
+      if ( line.empty() || line[ 0 ] == '#' ||
+           util::string_split_allow_quotes( entry.args, line, " \t\n\r" ) == 0 )
+      {
+        continue;
+      }
+
+      entries.push_back( entry );
+    }
+
+    return true;
+  }
+
+  std::string default_json_file( const entry_t& entry ) const
+  {
+    std::string base = file_name;
+    std::string::size_type dot = base.rfind( '.' );
+    std::string::size_type sep = base.find_last_of( "/\\" );
+    if ( dot != std::string::npos && ( sep == std::string::npos || dot > sep ) )
+    {
+      base.resize( dot );
+    }
+
+    return base + "_" + util::to_string( entry.line ) + ".json";
+  }
+
+  void message( const entry_t& entry, const std::string& msg )
+  {
+    AUTO_LOCK( mutex );
+    std::cout << "Batch entry " << entry.line << ": " << msg << std::endl;
+  }
+
+  void error( const entry_t& entry, const std::string& msg )
+  {
+    AUTO_LOCK( mutex );
+    std::cerr << "ERROR! Batch entry " << entry.line << ": " << msg << std::endl;
+    n_failed++;
+  }
+
+  void simulate( const entry_t& entry )
+  {
+    stopwatch_t wall_time( STOPWATCH_WALL );
+    sim_t sim;
+    sim_control_t control;
+    sim.batch_entry = true;
+
+    try
+    {
+      control.options.parse_args( common_args );
+      control.options.parse_args( entry.args );
+      sim.setup( &control );
+    }
+    catch ( const std::exception& e )
+    {
+      error( entry, std::string( "Setup failure: " ) + e.what() );
+      return;
+    }
+
+    std::string errmsg;
+    if ( ! check_data_file_option( sim, data_file, errmsg ) )
+    {
+      error( entry, "Setup failure: " + errmsg );
+      return;
+    }
+
+    if ( sim.json_file_str.empty() )
+    {
+      sim.json_file_str = default_json_file( entry );
+    }
+
+    // Interleaved progress bars of concurrent entries would be unreadable
+    if ( n_threads > 1 )
+    {
+      sim.report_progress = 0;
+    }
+
+    if ( sim.canceled || ! sim.run_and_report() )
+    {
+      error( entry, "Simulation canceled" );
+      return;
+    }
+
+    message( entry, "json=" + sim.json_file_str + " in " + util::to_string( wall_time.elapsed(), 3 ) + "sec" );
+  }
+
+  void run_entries()
+  {
+    while ( true )
+    {
+      size_t index;
+      {
+        AUTO_LOCK( mutex );
+        if ( next_entry == entries.size() )
+        {
+          break;
+        }
+        index = next_entry++;
+      }
+
+      simulate( entries[ index ] );
+    }
+  }
+
+  int run()
+  {
+    if ( ! read_manifest() || ! setup_process() )
+    {
+      return 1;
+    }
+
+    util::printf( "\nSimulating batch '%s' ( entries=%u, batch_threads=%u )\n\n",
+        file_name.c_str(), as<unsigned>( entries.size() ), n_threads );
+
+    std::vector<std::unique_ptr<worker_t>> workers;
+    for ( unsigned i = 1; i < std::min( n_threads, as<unsigned>( entries.size() ) ); ++i )
+    {
+      workers.push_back( std::unique_ptr<worker_t>( new worker_t( *this ) ) );
+      workers.back() -> launch();
+    }
+
+    run_entries();
+
+    for ( auto& worker : workers )
+    {
+      worker -> join();
+    }
+
+    util::printf( "\nBatch done: %u of %u entries failed\n", n_failed, as<unsigned>( entries.size() ) );
+
+    return n_failed > 0;
+  }
+};
+
 } // anonymous namespace ====================================================
 
+// sim_t::run_and_report ====================================================
+
+/* Run a sim that has been set up: evaluate its spell query, generate its profiles, load its
+ * results, or simulate it, and print the reports. Shared by sim_t::main() and the entries of a
+ * batch, returns false on failure.
+ */
+bool sim_t::run_and_report()
+{
+  if ( spell_query )
+  {
+    try
+    {
+      spell_query -> evaluate();
+      print_spell_query();
+    }
+    catch( const std::exception& e ){
+      std::cerr <<  "ERROR! Spell Query failure: " << e.what() << std::endl;
+      return false;
+    }
+  }
+  else if ( need_to_save_profiles( this ) )
+  {
+    init();
+    std::cout << "\nGenerating profiles... \n";
+    report::print_profiles( this );
+  }
+  else if ( ! load_results_file_str.empty() )
+  {
+    std::cout << "\nLoading results from '" << load_results_file_str << "'...\n";
+    if ( init() && results::load( *this, load_results_file_str ) )
+      report::print_suite( this );
+    else
+      canceled = 1;
+  }
+  else
+  {
+    util::printf( "\nSimulating... ( iterations=%d, threads=%d, target_error=%.3f,  max_time=%.0f, vary_combat_length=%0.2f, optimal_raid=%d, fight_style=%s )\n\n",
+      iterations, threads, target_error, max_time.total_seconds(), vary_combat_length, optimal_raid, fight_style.c_str() );
+
+    sim_phase_str = "Generating Baseline:   ";
+    if ( execute() )
+    {
+      scaling      -> analyze();
+      plot         -> analyze();
+      reforge_plot -> analyze();
+      if ( ! save_results_file_str.empty() )
+        results::save( *this, save_results_file_str );
+      report::print_suite( this );
+    }
+    else
+      canceled = 1;
+  }
+
+  return ! canceled;
+}
+
 // sim_t::main ==============================================================
 
 int sim_t::main( const std::vector<std::string>& args )
 {
   sim_signal_handler_t handler( this );
 
-  cache_initializer_t cache_init( get_cache_directory() + "/simc_cache.dat" );
-  dbc_initializer_t dbc_init;
+  cache_initializer_t cache_init( get_cache_directory() + "/simc_cache" );
+  std::string data_file = data_file_name( args );
+  dbc_initializer_t dbc_init( data_file );
+  if ( ! dbc_init.error.empty() )
+  {
+    std::cerr << "ERROR! " << dbc_init.error << std::endl;
+    return 1;
+  }
   module_t::init();
   unique_gear::register_hotfixes();
 
   special_effect_initializer_t special_effect_init;
 
+  unsigned batch_threads = 1;
+  std::vector<std::string> sim_args = args;
+  std::string batch_file = batch_file_name( sim_args, batch_threads );
+  if ( ! batch_file.empty() )
+  {
+    hotfix::apply();
+    return batch_t( batch_file, data_file, sim_args, batch_threads ).run();
+  }
+
   sim_control_t control;
 
   try
@@ -208,6 +595,11 @@ int sim_t::main( const std::vector<std::string>& args )
     setup_success = false;
   }
 
+  if ( setup_success && ! check_data_file_option( *this, data_file, errmsg ) )
+  {
+    setup_success = false;
+  }
+
 #if ! defined( SC_GIT_REV )
   util::printf("SimulationCraft %s for World of Warcraft %s %s (wow build %s)\n",
       SC_VERSION, dbc.wow_version(), dbc.wow_ptr_status(), util::to_string(dbc.build_level()).c_str());
@@ -228,6 +620,19 @@ int sim_t::main( const std::vector<std::string>& args )
     return 0;
   }
 
+  if ( ! dbc_export_file_str.empty() )
+  {
+    std::string error;
+    if ( ! dbc::data_file::write( dbc_export_file_str, error ) )
+    {
+      std::cerr << "ERROR! Client data export failure: " << error << std::endl;
+      return 1;
+    }
+
+    std::cout << "Client data written to '" << dbc_export_file_str << "'" << std::endl;
+    return 0;
+  }
+
   if ( ! setup_success )
   {
     std::cerr <<  "ERROR! Setup failure: " << errmsg << std::endl;
@@ -238,44 +643,14 @@ int sim_t::main( const std::vector<std::string>& args )
 
   std::cout << std::endl;
 
-  if ( spell_query )
+  if ( ! run_and_report() )
   {
-    try
-    {
-      spell_query -> evaluate();
-      print_spell_query();
-    }
-    catch( const std::exception& e ){
-      std::cerr <<  "ERROR! Spell Query failure: " << e.what() << std::endl;
-      return 1;
-    }
-  }
-  else if ( need_to_save_profiles( this ) )
-  {
-    init();
-    std::cout << "\nGenerating profiles... \n";
-    report::print_profiles( this );
-  }
-  else
-  {
-    util::printf( "\nSimulating... ( iterations=%d, threads=%d, target_error=%.3f,  max_time=%.0f, vary_combat_length=%0.2f, optimal_raid=%d, fight_style=%s )\n\n",
-      iterations, threads, target_error, max_time.total_seconds(), vary_combat_length, optimal_raid, fight_style.c_str() );
-
-    sim_phase_str = "Generating Baseline:   ";
-    if ( execute() )
-    {
-      scaling      -> analyze();
-      plot         -> analyze();
-      reforge_plot -> analyze();
-      report::print_suite( this );
-    }
-    else
-      canceled = 1;
+    return 1;
   }
 
   std::cout << std::endl;
 
-  return canceled;
+  return 0;
 }
 
 // ==========================================================================
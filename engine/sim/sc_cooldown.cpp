@@ -7,62 +7,29 @@
 
 namespace { // UNNAMED NAMESPACE
 
-struct recharge_event_t : event_t
+// Charges are regained without events (see cooldown_t::update_charges()). Players using
+// ready_trigger wait for an event to re-evaluate their action list, so they get one at the end of
+// every recharge cycle.
+struct recharge_trigger_event_t : public player_event_t
 {
-  cooldown_t* cooldown_;
-  timespan_t duration_, event_duration_;
-
-  recharge_event_t( cooldown_t* cd, timespan_t base_duration )
-    : event_t( cd->sim, cooldown_t::cooldown_duration( cd, base_duration ) ),
-      cooldown_( cd ),
-      duration_( base_duration ),
-      event_duration_( cooldown_t::cooldown_duration( cd, base_duration ) )
-  {
-  }
+  cooldown_t* cooldown;
 
-  recharge_event_t( cooldown_t* cd, timespan_t event_duration,
-                    timespan_t base_duration )
-    : event_t( *cd->player, event_duration ),
-      cooldown_( cd ),
-      duration_( base_duration ),
-      event_duration_( event_duration )
+  recharge_trigger_event_t( player_t& p, cooldown_t* cd ) :
+    player_event_t( p, cd -> recharge_end - p.sim -> current_time() ),
+    cooldown( cd )
   {
   }
 
   virtual const char* name() const override
-  { return "recharge_event"; }
+  { return "recharge_trigger_event"; }
 
-  virtual void execute() override
+  void execute() override
   {
-    assert( cooldown_ -> current_charge < cooldown_ -> charges );
-    cooldown_ -> current_charge++;
-    cooldown_ -> ready = cooldown_t::ready_init();
-
-    if ( cooldown_ -> current_charge < cooldown_ -> charges )
-    {
-      cooldown_ -> recharge_event = make_event<recharge_event_t>( sim(), cooldown_, duration_ );
-    }
-    else
-    {
-      cooldown_ -> recharge_event = nullptr;
-      cooldown_ -> last_charged = sim().current_time();
-    }
-
-    if ( sim().debug )
-    {
-      sim().out_debug.printf( "%s recharge cooldown %s regenerated charge, current=%d, total=%d, next=%.3f, ready=%.3f, base_duration=%.3f, mul=%f",
-        cooldown_ -> player -> name(), cooldown_ -> name_str.c_str(), cooldown_ -> current_charge, cooldown_ -> charges,
-        cooldown_ -> recharge_event ? cooldown_ -> recharge_event -> occurs().total_seconds() : 0,
-        cooldown_ -> ready.total_seconds(),
-        cooldown_t::cooldown_duration( cooldown_, duration_ ).total_seconds(),
-        cooldown_ -> recharge_multiplier );
-    }
-
-    cooldown_ -> player -> trigger_ready();
+    cooldown -> recharge_trigger_event = nullptr;
+    cooldown -> update_charges();
+    cooldown -> update_recharge_trigger();
+    p() -> trigger_ready();
   }
-
-  static recharge_event_t* cast( event_t* e )
-  { return debug_cast<recharge_event_t*>( e ); }
 };
 
 struct ready_trigger_event_t : public player_event_t
@@ -113,7 +80,10 @@ cooldown_t::cooldown_t( const std::string& n, player_t& p ) :
   reset_react( timespan_t::zero() ),
   charges( 1 ),
   current_charge( 1 ),
-  recharge_event( nullptr ),
+  recharge_end( timespan_t::max() ),
+  recharge_duration( timespan_t::zero() ),
+  recharge_base_duration( timespan_t::min() ),
+  recharge_trigger_event( nullptr ),
   ready_trigger_event( nullptr ),
   last_start( timespan_t::zero() ),
   last_charged( timespan_t::zero() ),
@@ -131,7 +101,10 @@ cooldown_t::cooldown_t( const std::string& n, sim_t& s ) :
   reset_react( timespan_t::zero() ),
   charges( 1 ),
   current_charge( 1 ),
-  recharge_event( nullptr ),
+  recharge_end( timespan_t::max() ),
+  recharge_duration( timespan_t::zero() ),
+  recharge_base_duration( timespan_t::min() ),
+  recharge_trigger_event( nullptr ),
   ready_trigger_event( nullptr ),
   last_start( timespan_t::zero() ),
   last_charged( timespan_t::zero() ),
@@ -140,10 +113,87 @@ cooldown_t::cooldown_t( const std::string& n, sim_t& s ) :
   action( nullptr )
 {}
 
+// Account for all recharge cycles that have finished by now. Each finished cycle regains a
+// charge, and the next cycle (if any) starts right where the previous one ended, with the
+// duration and recharge multiplier in effect. They only change through set_duration(), start()
+// and adjust_recharge_multiplier(), which bring the charges up to date first.
+void cooldown_t::regain_charges()
+{
+  while ( recharge_end <= sim.current_time() )
+  {
+    assert( current_charge < charges );
+    timespan_t regained = recharge_end;
+    current_charge++;
+    ready = ready_init();
+
+    if ( current_charge < charges )
+    {
+      timespan_t duration = cooldown_duration( this, recharge_base_duration );
+      set_recharge( regained + duration, duration );
+    }
+    else
+    {
+      set_recharge( timespan_t::max(), timespan_t::zero() );
+      last_charged = regained;
+    }
+
+    if ( sim.debug )
+    {
+      sim.out_debug.printf( "%s recharge cooldown %s regenerated charge at %.3f, current=%d, total=%d, next=%.3f, ready=%.3f, base_duration=%.3f, mul=%f",
+        player -> name(), name_str.c_str(), regained.total_seconds(), current_charge, charges,
+        recharging() ? recharge_end.total_seconds() : 0,
+        ready.total_seconds(),
+        cooldown_duration( this, recharge_base_duration ).total_seconds(),
+        recharge_multiplier );
+    }
+  }
+}
+
+void cooldown_t::set_recharge( timespan_t end, timespan_t duration )
+{
+  recharge_end = end;
+  recharge_duration = duration;
+  update_recharge_trigger();
+}
+
+void cooldown_t::update_recharge_trigger()
+{
+  if ( ! player || player -> ready_type != READY_TRIGGER )
+  {
+    return;
+  }
+
+  // A trigger event occurring right now will execute, and rearm itself for the next cycle
+  if ( recharge_trigger_event && recharge_trigger_event -> occurs() <= sim.current_time() )
+  {
+    return;
+  }
+
+  if ( ! recharging() )
+  {
+    event_t::cancel( recharge_trigger_event );
+  }
+  else if ( ! recharge_trigger_event )
+  {
+    recharge_trigger_event = make_event<recharge_trigger_event_t>( sim, *player, this );
+  }
+  else if ( recharge_trigger_event -> occurs() > recharge_end )
+  {
+    event_t::cancel( recharge_trigger_event );
+    recharge_trigger_event = make_event<recharge_trigger_event_t>( sim, *player, this );
+  }
+  else if ( recharge_trigger_event -> occurs() < recharge_end )
+  {
+    recharge_trigger_event -> reschedule( recharge_end - sim.current_time() );
+  }
+}
+
 // Adjust a dynamic cooldown (reduction) multiplier based on the current action associated with the
 // cooldown. Actions are associated by start() calls.
 void cooldown_t::adjust_recharge_multiplier()
 {
+  update_charges();
+
   if ( up() )
   {
     return;
@@ -166,19 +216,11 @@ void cooldown_t::adjust_recharge_multiplier()
   }
   else
   {
-    remains = recharge_event -> remains();
+    remains = recharge_end - sim.current_time();
     new_remains = remains * delta;
-    // Shortened, reschedule the event
-    if ( delta < 1 )
-    {
-      timespan_t duration_ = recharge_event_t::cast( recharge_event ) -> duration_;
-      event_t::cancel( recharge_event );
-      recharge_event = make_event<recharge_event_t>( sim, this, new_remains, duration_ );
-    }
-    else
-    {
-      recharge_event -> reschedule( new_remains );
-    }
+    // A shortened recharge counts as a new cycle for charges_fractional, a lengthened one
+    // keeps its cycle length
+    set_recharge( sim.current_time() + new_remains, delta < 1 ? new_remains : recharge_duration );
   }
 
   if ( sim.debug )
@@ -197,6 +239,8 @@ void cooldown_t::adjust_recharge_multiplier()
 
 void cooldown_t::adjust( timespan_t amount, bool require_reaction )
 {
+  update_charges();
+
   // Normal cooldown, just adjust as we see fit
   if ( charges == 1 )
   {
@@ -214,45 +258,38 @@ void cooldown_t::adjust( timespan_t amount, bool require_reaction )
   // Charge-based cooldown
   else if ( current_charge < charges )
   {
-    // Remaining time on the recharge event
-    timespan_t remains = recharge_event -> remains() + amount;
+    // Remaining time on the current recharge cycle
+    timespan_t remains = recharge_end - sim.current_time() + amount;
 
-    // Didnt recharge a charge, just recreate the recharge event to occur
-    // sooner
+    // Didnt recharge a charge, just restart the recharge cycle to end sooner
     if ( remains > timespan_t::zero() )
     {
-      timespan_t duration_ = recharge_event_t::cast( recharge_event ) -> duration_;
-      event_t::cancel( recharge_event );
-      recharge_event = make_event<recharge_event_t>( sim, this, remains, duration_ );
+      set_recharge( sim.current_time() + remains, remains );
 
-      // If we have no charges, adjust ready time to the new occurrence time
-      // of the recharge event, plus a millisecond
+      // If we have no charges, adjust ready time to the new end of the recharge cycle, plus a
+      // millisecond
       if ( current_charge == 0 )
         ready += amount;
 
       if ( sim.debug )
         sim.out_debug.printf( "%s recharge cooldown %s adjustment=%.3f, remains=%.3f, occurs=%.3f, ready=%.3f",
           player -> name(), name_str.c_str(), amount.total_seconds(), remains.total_seconds(),
-          recharge_event -> occurs().total_seconds(), ready.total_seconds() );
+          recharge_end.total_seconds(), ready.total_seconds() );
     }
     // Recharged a charge
     else
     {
       reset( require_reaction );
-      // Excess time adjustment goes to the next recharge event, if we didnt
-      // max out on charges (recharge_event is still present after reset()
-      // call)
-      if ( remains < timespan_t::zero() && recharge_event )
+      // Excess time adjustment goes to the next recharge cycle, if we didnt max out on charges
+      // (still recharging after reset() call)
+      if ( remains < timespan_t::zero() && recharging() )
       {
-        timespan_t duration_ = recharge_event_t::cast( recharge_event ) -> duration_;
-        event_t::cancel( recharge_event );
-
-        // Note, the next recharge cycle uses the previous recharge cycle's
-        // base duration, if overridden
-        timespan_t new_duration = cooldown_duration( this, duration_ );
+        // Note, the next recharge cycle uses the previous recharge cycle's base duration, if
+        // overridden
+        timespan_t new_duration = cooldown_duration( this, recharge_base_duration );
         new_duration += remains;
 
-        recharge_event = make_event<recharge_event_t>( sim, this, new_duration, duration_ );
+        set_recharge( sim.current_time() + new_duration, new_duration );
       }
 
       if ( sim.debug )
@@ -260,7 +297,7 @@ void cooldown_t::adjust( timespan_t amount, bool require_reaction )
         sim.out_debug.printf( "%s recharge cooldown %s regenerated charge, current=%d, total=%d, reminder=%.3f, next=%.3f, ready=%.3f",
           player -> name(), name_str.c_str(), current_charge, charges,
           remains.total_seconds(),
-          recharge_event ? recharge_event -> occurs().total_seconds() : 0,
+          recharging() ? recharge_end.total_seconds() : 0,
           ready.total_seconds() );
       }
     }
@@ -276,12 +313,17 @@ void cooldown_t::reset_init()
 
   current_charge = charges;
 
-  recharge_event = nullptr;
+  recharge_end = timespan_t::max();
+  recharge_duration = timespan_t::zero();
+  recharge_base_duration = timespan_t::min();
+  recharge_trigger_event = nullptr;
   ready_trigger_event = nullptr;
 }
 
 void cooldown_t::reset( bool require_reaction, bool all_charges )
 {
+  update_charges();
+
   bool was_down = down();
   ready = ready_init();
   if ( last_start > sim.current_time() )
@@ -301,7 +343,7 @@ void cooldown_t::reset( bool require_reaction, bool all_charges )
   }
   if ( current_charge == charges )
   {
-    event_t::cancel( recharge_event );
+    set_recharge( timespan_t::max(), timespan_t::zero() );
     last_charged = sim.current_time();
   }
   event_t::cancel( ready_trigger_event );
@@ -319,6 +361,9 @@ void cooldown_t::start( action_t* a, timespan_t _override, timespan_t delay )
     return;
   }
 
+  // Recharge cycles that finished by now used the previous multiplier
+  update_charges();
+
   reset_react = timespan_t::zero();
 
   action = a;
@@ -339,9 +384,8 @@ void cooldown_t::start( action_t* a, timespan_t _override, timespan_t delay )
     event_duration += delay;
   }
 
-  // Normal cooldowns have charges = 0 or 1, and do not use the event system to
-  // trigger ready status (for efficiency reasons). Charged cooldowns recharge
-  // through the event system.
+  // Normal cooldowns have charges = 0 or 1, and are ready when their ready timestamp passes.
+  // Charged cooldowns regain charges at the end of recharge cycles, see update_charges().
   if ( charges > 1 )
   {
     last_charged = timespan_t::zero();
@@ -349,19 +393,18 @@ void cooldown_t::start( action_t* a, timespan_t _override, timespan_t delay )
     assert( current_charge > 0 );
     current_charge--;
 
-    // Begin a recharge event
-    if ( ! recharge_event )
+    // Begin a recharge cycle
+    if ( ! recharging() )
     {
-      recharge_event = make_event<recharge_event_t>( sim, this, event_duration, _override );
+      recharge_base_duration = _override;
+      set_recharge( sim.current_time() + event_duration, event_duration );
     }
 
-    // No charges left, the cooldown won't be ready until a recharge event
-    // occurs. Note, ready still needs to be properly set as it ultimately
-    // controls whether a cooldown is "up".
+    // No charges left, the cooldown won't be ready until the recharge cycle ends. Note, ready
+    // still needs to be properly set as it ultimately controls whether a cooldown is "up".
     if ( current_charge == 0 )
     {
-      assert( recharge_event );
-      ready = recharge_event -> occurs() + timespan_t::from_millis( 1 );
+      ready = recharge_end + timespan_t::from_millis( 1 );
     }
   }
   else
@@ -390,23 +433,28 @@ expr_t* cooldown_t::create_expression( action_t*, const std::string& name_str )
   else if ( name_str == "up" || name_str == "ready" )
     return make_mem_fn_expr( name_str, *this, &cooldown_t::up );
   else if ( name_str == "charges" )
-    return make_ref_expr( name_str, current_charge );
+  {
+    return make_fn_expr( name_str, [ this ]() {
+      update_charges();
+      return current_charge;
+    } );
+  }
   else if ( name_str == "charges_fractional" )
   {
     struct charges_fractional_expr_t : public expr_t
     {
-      const cooldown_t* cd;
-      charges_fractional_expr_t( const cooldown_t* c ) :
+      cooldown_t* cd;
+      charges_fractional_expr_t( cooldown_t* c ) :
         expr_t( "charges_fractional" ), cd( c )
       { }
 
       virtual double evaluate() override
       {
+        cd -> update_charges();
         double charges = cd -> current_charge;
-        if ( cd -> recharge_event )
+        if ( cd -> recharging() )
         {
-          recharge_event_t* re = debug_cast<recharge_event_t*>( cd -> recharge_event );
-          charges += 1 - ( re -> remains() / re -> event_duration_ );
+          charges += 1 - ( ( cd -> recharge_end - cd -> sim.current_time() ) / cd -> recharge_duration );
         }
         return charges;
       }
@@ -417,15 +465,16 @@ expr_t* cooldown_t::create_expression( action_t*, const std::string& name_str )
   {
     struct recharge_time_expr_t : public expr_t
     {
-      const cooldown_t* cd;
-      recharge_time_expr_t( const cooldown_t* c ) :
+      cooldown_t* cd;
+      recharge_time_expr_t( cooldown_t* c ) :
         expr_t( "recharge_time" ), cd( c )
       { }
 
       virtual double evaluate() override
       {
-        if ( cd -> recharge_event )
-          return cd -> recharge_event -> remains().total_seconds();
+        cd -> update_charges();
+        if ( cd -> recharging() )
+          return ( cd -> recharge_end - cd -> sim.current_time() ).total_seconds();
         else
           return cd -> duration.total_seconds();
       }
@@ -436,14 +485,15 @@ expr_t* cooldown_t::create_expression( action_t*, const std::string& name_str )
   {
     struct full_recharge_time_expr_t : public expr_t
     {
-      const cooldown_t* cd;
-      full_recharge_time_expr_t( const cooldown_t* c ) :
+      cooldown_t* cd;
+      full_recharge_time_expr_t( cooldown_t* c ) :
         expr_t( "full_recharge_time" ), cd( c )
       { }
 
       virtual double evaluate() override
       {
-        if ( cd -> recharge_event )
+        cd -> update_charges();
+        if ( cd -> recharging() )
         {
           return cd -> current_charge_remains().total_seconds() +
             ( cd -> charges - cd -> current_charge - 1 ) * cd -> duration.total_seconds();
@@ -1172,6 +1172,40 @@ bool convert_to_rpn( std::vector<expr_token_t>& tokens )
   return true;
 }
 
+// cached_tokens ============================================================
+
+// Look up the RPN tokens of an expression parsed by the top level sim. The top level sim only
+// adds to its cache until it is initialized, which happens before any child sim is created, so
+// child sims can read the cache concurrently without locking. The tokens are used in place, since
+// copying them costs several times more than the lookup.
+const std::vector<expr_token_t>* cached_tokens( const sim_t& sim,
+                                                const std::string& expr_str )
+{
+  const sim_t* root = &sim;
+  while ( root->parent )
+    root = root->parent;
+
+  if ( root != &sim && !root->initialized )
+    return nullptr;
+
+  auto it = root->expression_cache.find( expr_str );
+  if ( it == root->expression_cache.end() )
+    return nullptr;
+
+  return &it->second;
+}
+
+// cache_tokens =============================================================
+
+void cache_tokens( sim_t& sim, const std::string& expr_str,
+                   const std::vector<expr_token_t>& tokens )
+{
+  if ( sim.parent || sim.initialized )
+    return;
+
+  sim.expression_cache.emplace( expr_str, tokens );
+}
+
 }  // expression
 
 #if !defined( NDEBUG )
@@ -1185,7 +1219,7 @@ int expr_t::get_global_id()
 // build_expression_tree ====================================================
 
 static expr_t* build_expression_tree(
-    action_t* action, std::vector<expression::expr_token_t>& tokens,
+    action_t* action, const std::vector<expression::expr_token_t>& tokens,
     bool optimize )
 {
   auto_dispose<std::vector<expr_t*>> stack;
@@ -1193,7 +1227,7 @@ static expr_t* build_expression_tree(
   size_t num_tokens = tokens.size();
   for ( size_t i = 0; i < num_tokens; i++ )
   {
-    expression::expr_token_t& t = tokens[ i ];
+    const expression::expr_token_t& t = tokens[ i ];
 
     if ( t.type == expression::TOK_NUM )
     {
@@ -1260,30 +1294,38 @@ expr_t* expr_t::parse( action_t* action, const std::string& expr_str,
   if ( expr_str.empty() )
     return nullptr;
 
-  std::vector<expression::expr_token_t> tokens =
-      expression::parse_tokens( action, expr_str );
+  std::vector<expression::expr_token_t> tokens;
+  const std::vector<expression::expr_token_t>* rpn =
+      expression::cached_tokens( *action->sim, expr_str );
+  if ( ! rpn )
+  {
+    tokens = expression::parse_tokens( action, expr_str );
 
-  if ( action->sim->debug )
-    expression::print_tokens( tokens, action->sim );
+    if ( action->sim->debug )
+      expression::print_tokens( tokens, action->sim );
 
-  expression::convert_to_unary( tokens );
+    expression::convert_to_unary( tokens );
 
-  if ( action->sim->debug )
-    expression::print_tokens( tokens, action->sim );
+    if ( action->sim->debug )
+      expression::print_tokens( tokens, action->sim );
 
-  if ( !expression::convert_to_rpn( tokens ) )
-  {
-    action->sim->errorf( "%s-%s: Unable to convert %s into RPN\n",
-                         action->player->name(), action->name(),
-                         expr_str.c_str() );
-    action->sim->cancel();
-    return nullptr;
-  }
+    if ( !expression::convert_to_rpn( tokens ) )
+    {
+      action->sim->errorf( "%s-%s: Unable to convert %s into RPN\n",
+                           action->player->name(), action->name(),
+                           expr_str.c_str() );
+      action->sim->cancel();
+      return nullptr;
+    }
 
-  if ( action->sim->debug )
-    expression::print_tokens( tokens, action->sim );
+    if ( action->sim->debug )
+      expression::print_tokens( tokens, action->sim );
+
+    expression::cache_tokens( *action->sim, expr_str, tokens );
+    rpn = &tokens;
+  }
 
-  if ( expr_t* e = build_expression_tree( action, tokens, optimize ) )
+  if ( expr_t* e = build_expression_tree( action, *rpn, optimize ) )
     return e;
 
   action->sim->errorf( "%s-%s: Unable to build expression tree from %s\n",
@@ -67,6 +67,10 @@ std::vector<expr_token_t> parse_tokens( action_t* action,
 void print_tokens( std::vector<expr_token_t>& tokens, sim_t* sim );
 void convert_to_unary( std::vector<expr_token_t>& tokens );
 bool convert_to_rpn( std::vector<expr_token_t>& tokens );
+const std::vector<expr_token_t>* cached_tokens( const sim_t& sim,
+                                                const std::string& expr_str );
+void cache_tokens( sim_t& sim, const std::string& expr_str,
+                   const std::vector<expr_token_t>& tokens );
 }
 
 /// Action expression
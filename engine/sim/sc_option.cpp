@@ -531,7 +531,7 @@ private:
 struct opts_map_t : public option_t
 {
   opts_map_t( const std::string& name, map_t& ref ) :
-    option_t( name ),
+    option_t( name, true ),
     _ref( ref )
   { }
 protected:
@@ -621,25 +621,96 @@ private:
 
 } // opts
 
-// option_t::parse ==========================================================
+// option_registry_t::add ==================================================
 
-bool opts::parse( sim_t*                 sim,
-                  const std::vector<std::unique_ptr<option_t>>& options,
-                      const std::string&     name,
-                      const std::string&     value )
+void option_registry_t::add( std::unique_ptr<option_t>& option, int key )
 {
-  for ( auto& option : options )
+  index_t& index = option -> is_prefix() ? by_prefix : by_name;
+  entry_list_t& entries = index[ option -> name() ];
+  auto entry = std::make_pair( key, static_cast<const option_t*>( option.get() ) );
+  if ( key < 0 )
+    entries.insert( entries.begin(), entry );
+  else
+    entries.push_back( entry );
+}
+
+// option_registry_t::push_front ===========================================
+
+void option_registry_t::push_front( std::unique_ptr<option_t> option )
+{
+  add( option, --front_key );
+  options.insert( options.begin(), std::move( option ) );
+}
+
+// option_registry_t::push_back ============================================
+
+void option_registry_t::push_back( std::unique_ptr<option_t> option )
+{
+  add( option, ++back_key );
+  options.push_back( std::move( option ) );
+}
+
+// option_registry_t::parse ================================================
+
+bool option_registry_t::parse( sim_t*             sim,
+                               const std::string& name,
+                               const std::string& value ) const
+{
+  static const entry_list_t no_entries;
+
+  auto it = by_name.find( name );
+  const entry_list_t& exact = it != by_name.end() ? it -> second : no_entries;
+
+  // Prefix of the name as matched by prefix options: up to and including the last '.', ignoring
+  // a trailing '+'
+  const entry_list_t* prefixed = &no_entries;
+  if ( ! by_prefix.empty() && ! name.empty() )
+  {
+    std::string::size_type last = name.size() - 1;
+    if ( name[ last ] == '+' && last > 0 )
+      --last;
+    std::string::size_type dot = name.rfind( '.', last );
+    if ( dot != std::string::npos )
+    {
+      auto prefix_it = by_prefix.find( name.substr( 0, dot + 1 ) );
+      if ( prefix_it != by_prefix.end() )
+        prefixed = &prefix_it -> second;
+    }
+  }
+
+  // Try both candidate lists in order of precedence. Options may decline a name they are
+  // registered for (opt_list), so every candidate has to be tried.
+  size_t i = 0, j = 0;
+  while ( i < exact.size() || j < prefixed -> size() )
+  {
+    const option_t* option;
+    if ( j == prefixed -> size() || ( i < exact.size() && exact[ i ].first < ( *prefixed )[ j ].first ) )
+      option = exact[ i++ ].second;
+    else
+      option = ( *prefixed )[ j++ ].second;
+
     if ( option -> parse_option( sim, name, value ) )
       return true;
+  }
 
   return false;
 }
 
 // option_t::parse ==========================================================
 
+bool opts::parse( sim_t*                   sim,
+                  const option_registry_t& options,
+                  const std::string&       name,
+                  const std::string&       value )
+{
+  return options.parse( sim, name, value );
+}
+
+// option_t::parse ==========================================================
+
 void opts::parse( sim_t*                 sim,
     const std::string&            context,
-    const std::vector<std::unique_ptr<option_t>>& options,
+    const option_registry_t&      options,
                       const std::vector<std::string>& splits )
 {
   for (auto & s : splits)
@@ -670,7 +741,7 @@ void opts::parse( sim_t*                 sim,
 
 void opts::parse( sim_t*                 sim,
     const std::string&            context,
-    const std::vector<std::unique_ptr<option_t>>& options,
+    const option_registry_t&      options,
                       const std::string&     options_str )
 {
   opts::parse( sim, context, options, util::string_split( options_str, "," ) );
@@ -24,14 +24,17 @@ struct sim_t;
 struct option_t
 {
 public:
-  option_t( const std::string& name ) :
-    _name( name )
+  // Prefix options parse any name of the form <name><key>, where name ends in '.' (see opt_map)
+  option_t( const std::string& name, bool prefix = false ) :
+    _name( name ), _prefix( prefix )
 { }
   virtual ~option_t() { }
   bool parse_option( sim_t* sim , const std::string& n, const std::string& value ) const
   { return parse( sim, n, value ); }
-  std::string name() const
+  const std::string& name() const
   { return _name; }
+  bool is_prefix() const
+  { return _prefix; }
   std::ostream& print_option( std::ostream& stream ) const
   { return print( stream ); }
 protected:
@@ -39,6 +42,51 @@ protected:
   virtual std::ostream& print( std::ostream& stream ) const = 0;
 private:
   std::string _name;
+  bool _prefix;
+};
+
+/* Options of an object (sim, player, action, ...), indexed by name so that parsing a name=value
+ * pair does not have to try every option in turn. Options pushed to the front take precedence
+ * over existing options of the same name (eg. enemy_t overriding player_t options), which is
+ * also the order options are printed in. Prefix options are indexed by their prefix.
+ */
+class option_registry_t
+{
+public:
+  typedef std::vector<std::unique_ptr<option_t>>::const_iterator const_iterator;
+
+  option_registry_t() : front_key( 0 ), back_key( 0 )
+  { }
+
+  void push_front( std::unique_ptr<option_t> );
+  void push_back( std::unique_ptr<option_t> );
+  void reserve( size_t n )
+  { options.reserve( n ); by_name.reserve( n ); }
+
+  // Parse name=value with the options registered for name, in order of precedence
+  bool parse( sim_t*, const std::string& name, const std::string& value ) const;
+
+  size_t size() const
+  { return options.size(); }
+  bool empty() const
+  { return options.empty(); }
+  const std::unique_ptr<option_t>& operator[]( size_t i ) const
+  { return options[ i ]; }
+  const_iterator begin() const
+  { return options.begin(); }
+  const_iterator end() const
+  { return options.end(); }
+
+private:
+  // ( precedence key, option ), lowest key first
+  typedef std::vector<std::pair<int, const option_t*>> entry_list_t;
+  typedef std::unordered_map<std::string, entry_list_t> index_t;
+
+  void add( std::unique_ptr<option_t>&, int key );
+
+  std::vector<std::unique_ptr<option_t>> options;
+  index_t by_name, by_prefix;
+  int front_key, back_key;
 };
 
 
@@ -47,9 +95,9 @@ namespace opts {
 typedef std::unordered_map<std::string, std::string> map_t;
 typedef std::function<bool(sim_t*,const std::string&, const std::string&)> function_t;
 typedef std::vector<std::string> list_t;
-bool parse( sim_t*, const std::vector<std::unique_ptr<option_t>>&, const std::string& name, const std::string& value );
-void parse( sim_t*, const std::string& context, const std::vector<std::unique_ptr<option_t>>&, const std::string& options_str );
-void parse( sim_t*, const std::string& context, const std::vector<std::unique_ptr<option_t>>&, const std::vector<std::string>& strings );
+bool parse( sim_t*, const option_registry_t&, const std::string& name, const std::string& value );
+void parse( sim_t*, const std::string& context, const option_registry_t&, const std::string& options_str );
+void parse( sim_t*, const std::string& context, const option_registry_t&, const std::vector<std::string>& strings );
 }
 inline std::ostream& operator<<( std::ostream& stream, const std::unique_ptr<option_t>& opt )
 { return opt -> print_option( stream ); }
@@ -180,6 +180,9 @@ struct adds_event_t : public raid_event_t
 
   void regenerate_cache()
   {
+    // Enemies moved, positions in the spatial index are stale
+    sim -> actor_grid.invalidate();
+
     for (auto p : affected_players)
     {
       
@@ -273,6 +276,9 @@ struct move_enemy_t : public raid_event_t
 
   void regenerate_cache()
   {
+    // Enemies moved, positions in the spatial index are stale
+    sim -> actor_grid.invalidate();
+
     for (auto p : affected_players)
     {
       
@@ -290,6 +296,7 @@ struct move_enemy_t : public raid_event_t
     {
       enemy -> x_position = enemy -> default_x_position;
       enemy -> y_position = enemy -> default_y_position;
+      sim -> actor_grid.invalidate();
     }
   }
 
@@ -0,0 +1,577 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+/**
+ * Binary results files.
+ *
+ * save_results=<file> writes the merged results of a simulation to a compact binary file, and
+ * load_results=<file> generates the reports (html, json, xml, text) from such a file instead of
+ * simulating. The sim loading the file must be set up with the same options and profiles that
+ * produced it: the results are applied to the actors, buffs, stats etc. created by sim
+ * initialization, and analyzed in place.
+ *
+ * Only the raw, merged collected data is stored. It is captured by results::snapshot() before
+ * sim_t::analyze() runs, because analysis modifies the collected data in place. Results of the
+ * scale factor and plot simulations are stored separately after it, as they cannot be recomputed.
+ *
+ * File layout (all integers and floating point values in native byte order, the file is not
+ * portable between architectures):
+ *
+ * results_file_header_t
+ * uint64_t size, results block (see transfer_results())
+ * uint64_t size, analysis block (see transfer_analysis())
+ *
+ * Lists of objects (actors, buffs, stats, ...) are stored as keyed, size-prefixed records. Records
+ * that do not match an object of the loading sim are skipped, so results produced by a slightly
+ * different setup still load, minus the unmatched data. Data merged by class modules in their own
+ * player_t::merge() overrides is not stored.
+ */
+
+#include "simulationcraft.hpp"
+
+namespace { // ANONYMOUS namespace ==========================================
+
+const char     RESULTS_FILE_MAGIC[ 4 ] = { 'S', 'C', 'R', 'S' };
+const uint32_t RESULTS_FILE_VERSION    = 1;
+
+struct results_file_header_t
+{
+  char     magic[ 4 ];
+  uint32_t version;
+  uint32_t word_size; // sizeof( size_t ) of the writing build
+  uint32_t reserved;
+};
+
+/* Serialization archive. The same transfer functions are used to save and to load data, so the
+ * two directions cannot get out of sync: when saving, values are appended to the data string;
+ * when loading, they are read from it and assigned. Malformed or truncated data throws
+ * std::runtime_error.
+ */
+class archive_t
+{
+  std::string& data;
+  size_t position;
+
+public:
+  const bool loading;
+  // Records of the file that did not match an object of the loading sim
+  unsigned skipped;
+
+  archive_t( std::string& d, bool l, size_t pos = 0 ) :
+    data( d ), position( pos ), loading( l ), skipped( 0 )
+  { }
+
+  size_t remaining() const
+  { return data.size() - position; }
+
+  void raw( void* p, size_t n )
+  {
+    if ( loading )
+    {
+      if ( n > remaining() )
+        throw std::runtime_error( "unexpected end of data" );
+      std::memcpy( p, data.data() + position, n );
+      position += n;
+    }
+    else
+      data.append( static_cast<const char*>( p ), n );
+  }
+
+  template <typename T>
+  void value( T& v )
+  {
+    static_assert( std::is_arithmetic<T>::value, "archive_t::value requires an arithmetic type" );
+    raw( &v, sizeof( v ) );
+  }
+
+  // Transfer a container size. Returns the stored size when loading.
+  size_t size( size_t n )
+  {
+    uint64_t v = n;
+    value( v );
+    // Every element takes at least one byte, anything larger is corrupt
+    if ( loading && v > remaining() )
+      throw std::runtime_error( "invalid container size" );
+    return static_cast<size_t>( v );
+  }
+
+  template <typename T>
+  void values( std::vector<T>& v )
+  {
+    static_assert( std::is_arithmetic<T>::value, "archive_t::values requires an arithmetic type" );
+    size_t n = size( v.size() );
+    if ( loading )
+      v.resize( n );
+    if ( n > 0 )
+      raw( v.data(), n * sizeof( T ) );
+  }
+
+  // Size-prefixed block written by f. When loading, the block is skipped if skip is set.
+  template <typename F>
+  void block( bool skip, F f )
+  {
+    uint64_t n = 0;
+    if ( loading )
+    {
+      value( n );
+      if ( n > remaining() )
+        throw std::runtime_error( "invalid block size" );
+      size_t end = position + static_cast<size_t>( n );
+      if ( skip )
+        skipped++;
+      else
+      {
+        f();
+        if ( position != end )
+          throw std::runtime_error( "block size mismatch" );
+      }
+      position = end;
+    }
+    else
+    {
+      size_t start = data.size();
+      value( n );
+      f();
+      n = data.size() - start - sizeof( n );
+      std::memcpy( &data[ start ], &n, sizeof( n ) );
+    }
+  }
+};
+
+// Transfer functions =======================================================
+
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type transfer( archive_t& ar, T& v )
+{ ar.value( v ); }
+
+template <typename T>
+typename std::enable_if<std::is_enum<T>::value>::type transfer( archive_t& ar, T& v )
+{
+  int32_t i = static_cast<int32_t>( v );
+  ar.value( i );
+  v = static_cast<T>( i );
+}
+
+// Sample data and timelines
+template <typename T>
+auto transfer( archive_t& ar, T& x ) -> decltype( x.serialize( ar ), void() )
+{ x.serialize( ar ); }
+
+void transfer( archive_t& ar, timespan_t& t )
+{
+  int64_t ms = t.total_millis();
+  ar.value( ms );
+  t = timespan_t::from_millis( ms );
+}
+
+void transfer( archive_t& ar, std::string& s )
+{
+  size_t n = ar.size( s.size() );
+  if ( ar.loading )
+    s.resize( n );
+  if ( n > 0 )
+    ar.raw( &s[ 0 ], n );
+}
+
+template <typename T>
+void transfer( archive_t& ar, std::vector<T>& v )
+{
+  size_t n = ar.size( v.size() );
+  if ( ar.loading )
+    v.resize( n );
+  for ( auto& e : v )
+    transfer( ar, e );
+}
+
+template <typename T, size_t N>
+void transfer( archive_t& ar, std::array<T, N>& a )
+{
+  if ( ar.size( N ) != N )
+    throw std::runtime_error( "array size mismatch" );
+  for ( auto& e : a )
+    transfer( ar, e );
+}
+
+// Structs of plain numbers, transferred as is
+template <typename T>
+void transfer_plain( archive_t& ar, T& x )
+{
+  static_assert( std::is_trivially_copyable<T>::value, "transfer_plain requires a trivially copyable type" );
+  ar.raw( &x, sizeof( x ) );
+}
+
+void transfer( archive_t& ar, gear_stats_t& s )
+{ transfer_plain( ar, s ); }
+
+void transfer( archive_t& ar, plot_data_t& d )
+{ transfer_plain( ar, d ); }
+
+void transfer( archive_t& ar, player_collected_data_t::buffed_stats_t& s )
+{ transfer_plain( ar, s ); }
+
+void fields( archive_t& )
+{ }
+
+template <typename T, typename... Rest>
+void fields( archive_t& ar, T& x, Rest&... rest )
+{
+  transfer( ar, x );
+  fields( ar, rest... );
+}
+
+/* Keyed list of objects. Each object is stored as its key followed by a block transferred by f.
+ * When loading, blocks are matched to the objects of the list by key, and skipped if there is
+ * no match.
+ */
+template <typename T, typename K, typename F>
+void transfer_list( archive_t& ar, const std::vector<T*>& list, K key, F f )
+{
+  std::unordered_map<std::string, T*> by_key;
+  if ( ar.loading )
+  {
+    for ( T* x : list )
+      by_key.emplace( key( *x ), x );
+  }
+
+  size_t n = ar.size( list.size() );
+  for ( size_t i = 0; i < n; ++i )
+  {
+    T* x = ar.loading ? nullptr : list[ i ];
+    std::string k = ar.loading ? std::string() : key( *x );
+    transfer( ar, k );
+    if ( ar.loading )
+    {
+      auto it = by_key.find( k );
+      if ( it != by_key.end() )
+        x = it -> second;
+    }
+    ar.block( x == nullptr, [ & ]() { f( *x ); } );
+  }
+}
+
+std::string actor_key( const player_t& p )
+{ return p.name_str + '#' + util::to_string( p.actor_index ); }
+
+std::string buff_key( const buff_t& b )
+{ return b.name_str + '#' + ( b.source ? util::to_string( b.source -> actor_index ) : std::string( "-" ) ); }
+
+template <typename T>
+std::string name_key( const T& x )
+{ return x.name_str; }
+
+void transfer( archive_t& ar, gain_t& g )
+{ fields( ar, g.actual, g.overflow, g.count ); }
+
+void transfer( archive_t& ar, proc_t& p )
+{ fields( ar, p.count, p.interval_sum ); }
+
+void transfer( archive_t& ar, benefit_t& b )
+{ fields( ar, b.ratio ); }
+
+void transfer( archive_t& ar, uptime_t& u )
+{ fields( ar, u.uptime_sum ); }
+
+void transfer( archive_t& ar, buff_t& b )
+{
+  fields( ar, b.start_intervals, b.trigger_intervals, b.uptime_pct, b.benefit_pct, b.trigger_pct,
+          b.avg_start, b.avg_refresh, b.avg_expire, b.avg_overflow_count, b.avg_overflow_total,
+          b.uptime_array );
+
+  size_t n = ar.size( b.stack_uptime.size() );
+  for ( size_t i = 0; i < n; ++i )
+  {
+    simple_sample_data_t unused;
+    transfer( ar, i < b.stack_uptime.size() ? b.stack_uptime[ i ].uptime_sum : unused );
+  }
+}
+
+void transfer( archive_t& ar, stats_t::stats_results_t& r )
+{
+  fields( ar, r.actual_amount, r.avg_actual_amount, r.total_amount, r.fight_actual_amount,
+          r.fight_total_amount, r.overkill_pct, r.count );
+}
+
+void transfer( archive_t& ar, stats_t& s )
+{
+  fields( ar, s.resource_gain, s.num_executes, s.num_ticks, s.num_refreshes,
+          s.num_direct_results, s.num_tick_results, s.total_execute_time, s.total_tick_time,
+          s.total_intervals, s.actual_amount, s.total_amount, s.portion_aps, s.portion_apse,
+          s.direct_results, s.direct_results_detail, s.tick_results, s.tick_results_detail,
+          s.timeline_amount );
+}
+
+void transfer( archive_t& ar, player_collected_data_t::resource_timeline_t& t )
+{ fields( ar, t.type, t.timeline ); }
+
+void transfer( archive_t& ar, player_collected_data_t::stat_timeline_t& t )
+{ fields( ar, t.type, t.timeline ); }
+
+void transfer( archive_t& ar, std::vector<iteration_data_entry_t>& data )
+{
+  size_t n = ar.size( data.size() );
+  if ( ar.loading )
+    data.assign( n, iteration_data_entry_t( 0, 0, 0 ) );
+  for ( auto& entry : data )
+    fields( ar, entry.metric, entry.seed, entry.iteration, entry.target_health );
+}
+
+/* Action sequences refer to actions and targets by actor index (and action list index), and to
+ * buffs of the player by key.
+ */
+void transfer_action_sequence( archive_t& ar, player_t& p,
+                               auto_dispose< std::vector<player_collected_data_t::action_sequence_data_t*> >& sequence )
+{
+  sim_t& sim = *p.sim;
+
+  std::unordered_map<std::string, buff_t*> buffs;
+  if ( ar.loading )
+  {
+    for ( buff_t* b : p.buff_list )
+      buffs.emplace( buff_key( *b ), b );
+  }
+
+  size_t n = ar.size( sequence.size() );
+  if ( ar.loading )
+    sequence.dispose();
+
+  for ( size_t i = 0; i < n; ++i )
+  {
+    player_collected_data_t::action_sequence_data_t* entry = ar.loading ? nullptr : sequence[ i ];
+
+    timespan_t time = entry ? entry -> time : timespan_t::zero();
+    timespan_t wait_time = entry ? entry -> wait_time : timespan_t::zero();
+    fields( ar, time, wait_time );
+    if ( ar.loading )
+    {
+      entry = new player_collected_data_t::action_sequence_data_t( time, wait_time, &p );
+      entry -> buff_list.clear();
+      sequence.push_back( entry );
+    }
+
+    int64_t actor = -1, action = -1, target = -1;
+    if ( ! ar.loading )
+    {
+      if ( entry -> action )
+      {
+        const auto& list = entry -> action -> player -> action_list;
+        actor = entry -> action -> player -> actor_index;
+        action = std::find( list.begin(), list.end(), entry -> action ) - list.begin();
+      }
+      if ( entry -> target )
+        target = entry -> target -> actor_index;
+    }
+    fields( ar, actor, action, target );
+    if ( ar.loading )
+    {
+      if ( actor >= 0 && static_cast<size_t>( actor ) < sim.actor_list.size() )
+      {
+        const auto& list = sim.actor_list[ actor ] -> action_list;
+        if ( action >= 0 && static_cast<size_t>( action ) < list.size() )
+          entry -> action = list[ action ];
+      }
+      if ( target >= 0 && static_cast<size_t>( target ) < sim.actor_list.size() )
+        entry -> target = sim.actor_list[ target ];
+    }
+
+    size_t n_buffs = ar.size( entry -> buff_list.size() );
+    for ( size_t j = 0; j < n_buffs; ++j )
+    {
+      std::string key = ar.loading ? std::string() : buff_key( *entry -> buff_list[ j ].first );
+      int stack = ar.loading ? 0 : entry -> buff_list[ j ].second;
+      fields( ar, key, stack );
+      if ( ar.loading )
+      {
+        auto it = buffs.find( key );
+        if ( it != buffs.end() )
+          entry -> buff_list.push_back( std::make_pair( it -> second, stack ) );
+        else
+          ar.skipped++;
+      }
+    }
+
+    fields( ar, entry -> resource_snapshot, entry -> resource_max_snapshot );
+  }
+}
+
+void transfer_actor( archive_t& ar, player_t& p )
+{
+  player_collected_data_t& cd = p.collected_data;
+
+  fields( ar, cd.fight_length, cd.waiting_time, cd.pooling_time, cd.executed_foreground_actions,
+          cd.dmg, cd.compound_dmg, cd.prioritydps, cd.dps, cd.dpse, cd.dtps, cd.dmg_taken,
+          cd.timeline_dmg, cd.timeline_dmg_taken,
+          cd.heal, cd.compound_heal, cd.hps, cd.hpse, cd.htps, cd.heal_taken,
+          cd.timeline_healing_taken,
+          cd.absorb, cd.compound_absorb, cd.aps, cd.atps, cd.absorb_taken,
+          cd.deaths, cd.theck_meloree_index, cd.effective_theck_meloree_index, cd.max_spike_amount,
+          cd.target_metric,
+          cd.resource_lost, cd.resource_gained, cd.resource_timelines, cd.combat_end_resource,
+          cd.stat_timelines, cd.health_changes.merged_timeline, cd.health_changes_tmi.merged_timeline,
+          cd.buffed_stats_snapshot );
+
+  transfer_action_sequence( ar, p, cd.action_sequence );
+  transfer_action_sequence( ar, p, cd.action_sequence_precombat );
+
+  fields( ar, p.callbacks.n_invoked, p.callbacks.n_skipped,
+          p.state_pool.n_allocated, p.state_pool.n_steady_allocated,
+          p.iteration_resource_lost, p.iteration_resource_gained,
+          p.resources.base, p.resources.initial );
+
+  transfer_list( ar, p.buff_list, buff_key, [ &ar ]( buff_t& b ) { transfer( ar, b ); } );
+  transfer_list( ar, p.proc_list, name_key<proc_t>, [ &ar ]( proc_t& x ) { transfer( ar, x ); } );
+  transfer_list( ar, p.gain_list, name_key<gain_t>, [ &ar ]( gain_t& x ) { transfer( ar, x ); } );
+  transfer_list( ar, p.stats_list, name_key<stats_t>, [ &ar ]( stats_t& x ) { transfer( ar, x ); } );
+  transfer_list( ar, p.uptime_list, name_key<uptime_t>, [ &ar ]( uptime_t& x ) { transfer( ar, x ); } );
+  transfer_list( ar, p.benefit_list, name_key<benefit_t>, [ &ar ]( benefit_t& x ) { transfer( ar, x ); } );
+  transfer_list( ar, p.sample_data_list, name_key<luxurious_sample_data_t>,
+                 [ &ar ]( luxurious_sample_data_t& x ) { transfer( ar, x ); } );
+
+  // Actions are keyed by their position in the action list, as in player_t::merge()
+  std::vector<action_t*> actions( p.action_list.begin(), p.action_list.end() );
+  transfer_list( ar, actions,
+                 [ &actions ]( const action_t& a ) {
+                   size_t i = std::find( actions.begin(), actions.end(), &a ) - actions.begin();
+                   return util::to_string( i ) + ':' + util::to_string( a.internal_id );
+                 },
+                 [ &ar ]( action_t& a ) { transfer( ar, a.total_executions ); } );
+}
+
+// Merged collected data of the sim and all actors, before analysis
+void transfer_results( archive_t& ar, sim_t& sim )
+{
+  fields( ar, sim.iterations, sim.simulation_length, sim.total_dmg, sim.raid_dps, sim.total_heal,
+          sim.raid_hps, sim.total_absorb, sim.raid_aps,
+          sim.event_mgr.total_events_processed, sim.event_mgr.max_events_remaining,
+          sim.init_phase_time, sim.target_cache_rebuilds, sim.target_cache_updates,
+          sim.allocation_audit_count, sim.allocation_audit_iterations, sim.iteration_data );
+
+  transfer_list( ar, sim.buff_list, name_key<buff_t>, [ &ar ]( buff_t& b ) { transfer( ar, b ); } );
+  transfer_list( ar, sim.actor_list, actor_key, [ &ar ]( player_t& p ) { transfer_actor( ar, p ); } );
+}
+
+// Results computed outside of the main simulation: timing, scale factors and plots
+void transfer_analysis( archive_t& ar, sim_t& sim )
+{
+  fields( ar, sim.elapsed_cpu, sim.elapsed_time, sim.scaling -> num_scaling_stats,
+          sim.scaling -> stats, sim.reforge_plot -> reforge_plot_stat_indices );
+
+  transfer_list( ar, sim.actor_list, actor_key, [ &ar ]( player_t& p ) {
+    fields( ar, p.scaling, p.scaling_normalized, p.scaling_error, p.scaling_delta_dps,
+            p.scaling_compare_error, p.scaling_lag, p.scaling_lag_error, p.scaling_stats,
+            p.dps_plot_data, p.reforge_plot_data );
+
+    transfer_list( ar, p.stats_list, name_key<stats_t>, [ &ar ]( stats_t& s ) {
+      bool has_scaling = s.scaling != nullptr;
+      ar.value( has_scaling );
+      if ( ! has_scaling )
+        return;
+      if ( ar.loading && ! s.scaling )
+        s.scaling = std::unique_ptr<stats_t::stats_scaling_t>( new stats_t::stats_scaling_t() );
+      fields( ar, s.scaling -> value, s.scaling -> error );
+    } );
+  } );
+}
+
+} // ANONYMOUS namespace ====================================================
+
+void results::snapshot( sim_t& sim )
+{
+  sim.results_snapshot.clear();
+  archive_t ar( sim.results_snapshot, false );
+  transfer_results( ar, sim );
+}
+
+bool results::save( sim_t& sim, const std::string& file_name )
+{
+  if ( sim.results_snapshot.empty() )
+  {
+    sim.errorf( "No results to save to '%s'.", file_name.c_str() );
+    return false;
+  }
+
+  std::string data;
+  archive_t ar( data, false );
+
+  results_file_header_t header = results_file_header_t();
+  std::memcpy( header.magic, RESULTS_FILE_MAGIC, sizeof( header.magic ) );
+  header.version = RESULTS_FILE_VERSION;
+  header.word_size = sizeof( size_t );
+  ar.raw( &header, sizeof( header ) );
+
+  ar.block( false, [ & ]() { data += sim.results_snapshot; } );
+  ar.block( false, [ & ]() { transfer_analysis( ar, sim ); } );
+
+  io::cfile file( file_name, "wb" );
+  if ( ! file || std::fwrite( data.data(), 1, data.size(), file ) != data.size() )
+  {
+    sim.errorf( "Failed to write results file '%s'.", file_name.c_str() );
+    return false;
+  }
+
+  return true;
+}
+
+bool results::load( sim_t& sim, const std::string& file_name )
+{
+  std::string data;
+  {
+    io::cfile file( file_name, "rb" );
+    if ( ! file )
+    {
+      sim.errorf( "Failed to open results file '%s'.", file_name.c_str() );
+      return false;
+    }
+
+    char buffer[ 1 << 16 ];
+    size_t n;
+    while ( ( n = std::fread( buffer, 1, sizeof( buffer ), file ) ) > 0 )
+      data.append( buffer, n );
+  }
+
+  results_file_header_t header;
+  if ( data.size() < sizeof( header ) )
+  {
+    sim.errorf( "Results file '%s' is truncated.", file_name.c_str() );
+    return false;
+  }
+
+  std::memcpy( &header, data.data(), sizeof( header ) );
+  if ( std::memcmp( header.magic, RESULTS_FILE_MAGIC, sizeof( header.magic ) ) != 0 ||
+       header.version != RESULTS_FILE_VERSION || header.word_size != sizeof( size_t ) )
+  {
+    sim.errorf( "'%s' is not a results file of this version and architecture.", file_name.c_str() );
+    return false;
+  }
+
+  archive_t ar( data, true, sizeof( header ) );
+  try
+  {
+    ar.block( false, [ & ]() { transfer_results( ar, sim ); } );
+    sim.analyze();
+    ar.block( false, [ & ]() { transfer_analysis( ar, sim ); } );
+  }
+  catch ( const std::exception& e )
+  {
+    sim.errorf( "Results file '%s' is malformed: %s", file_name.c_str(), e.what() );
+    return false;
+  }
+
+  if ( ar.skipped > 0 )
+  {
+    sim.errorf( "%u entries of results file '%s' did not match the simulation setup and were skipped.",
+                ar.skipped, file_name.c_str() );
+  }
+
+  for ( const player_t* p : sim.player_no_pet_list )
+  {
+    if ( p -> merges_module_data() )
+    {
+      sim.errorf( "Player %s: class specific data (e.g. counters, cooldown or rune waste) is not stored in "
+                  "results files, and is empty in reports from '%s'.", p -> name(), file_name.c_str() );
+    }
+  }
+
+  return true;
+}
@@ -252,6 +252,12 @@ bool parse_proxy( sim_t*             sim,
                          const std::string& /* name */,
                          const std::string& value )
 {
+  // The proxy is shared by the whole process, it would leak into the following entries of a
+  // batch, and race with the entries simulated concurrently
+  if ( sim -> batch_entry )
+  {
+    throw std::invalid_argument( "proxy is not supported in batch entries, give it on the command line" );
+  }
 
   std::vector<std::string> splits = util::string_split( value, "," );
 
@@ -273,10 +279,16 @@ bool parse_proxy( sim_t*             sim,
 
 // parse_cache ==============================================================
 
-bool parse_cache( sim_t*             /* sim */,
+bool parse_cache( sim_t*             sim,
                          const std::string& name,
                          const std::string& value )
 {
+  // Cache behavior is shared by the whole process, see parse_proxy()
+  if ( sim -> batch_entry )
+  {
+    throw std::invalid_argument( name + " is not supported in batch entries, give it on the command line" );
+  }
+
   if ( name == "cache_players" )
   {
     if ( value == "1" ) cache::players( cache::ANY );
@@ -358,11 +370,11 @@ public:
   cache::behavior_e cache;
 
   names_and_options_t( sim_t* sim, const std::string& context,
-                       std::vector<std::unique_ptr<option_t>> client_options, const std::string& input )
+                       option_registry_t client_options, const std::string& input )
   {
     int use_cache = 0;
 
-    std::vector<std::unique_ptr<option_t>> options;
+    option_registry_t options;
     options = std::move(client_options);
     //options.insert( options.begin(), client_options.begin(), client_options.end() );
     options.push_back( opt_string( "region", region ) );
@@ -426,7 +438,7 @@ bool parse_armory( sim_t*             sim,
   {
     std::string spec = "active";
 
-    std::vector<std::unique_ptr<option_t>> options;
+    option_registry_t options;
     options.push_back( opt_string( "spec", spec ) );
 
     names_and_options_t stuff( sim, name, std::move(options), value );
@@ -499,7 +511,7 @@ bool parse_guild( sim_t*             sim,
     std::string ranks_str;
     int max_rank = 0;
 
-    std::vector<std::unique_ptr<option_t>> options;
+    option_registry_t options;
     options.push_back( opt_string( "class", type_str ) );
     options.push_back( opt_int( "max_rank", max_rank ) );
     options.push_back( opt_string( "ranks", ranks_str ) );
@@ -672,6 +684,13 @@ bool parse_override_spell_data( sim_t*             sim,
     return true;
   }
 
+  // Overrides replace the client data of the whole process, they would leak into the following
+  // entries of a batch, and race with the entries simulated concurrently
+  if ( sim -> batch_entry )
+  {
+    throw std::invalid_argument( "override.spell_data is not supported in batch mode" );
+  }
+
   size_t v_pos = value.find( '=' );
 
   if ( v_pos == std::string::npos )
@@ -877,6 +896,16 @@ bool parse_maximize_reporting( sim_t*             sim,
   return true;
 }
 
+// Resources regenerate continuously, there is no regeneration event whose period could be set
+bool parse_regen_periodicity( sim_t*             sim,
+                              const std::string& name,
+                              const std::string& )
+{
+  sim -> errorf( "Option '%s' has been deprecated and is ignored, resources regenerate continuously.\n",
+                 name.c_str() );
+  return true;
+}
+
 /**
  * Parse threads option, and if equal or lower than 0, adjust
  * the number of threads to the number of cpu cores minus the absolute value given as a thread option.
@@ -1036,55 +1065,6 @@ struct resource_timeline_collect_event_t : public event_t
   }
 };
 
-struct regen_event_t : public event_t
-{
-  regen_event_t( sim_t& s ) :
-    event_t( s, s.regen_periodicity )
-  {
-    if ( sim().debug )
-    {
-      sim().out_debug.printf( "New Regen Event" );
-    }
-  }
-
-  virtual const char* name() const override
-  { return "Regen Event"; }
-
-  virtual void execute() override
-  {
-    if ( ! sim().single_actor_batch )
-    {
-      // targets do not get any resource regen for performance reasons
-      for ( size_t i = 0, actors = sim().player_non_sleeping_list.size(); i < actors; i++ )
-      {
-        player_t* p = sim().player_non_sleeping_list[ i ];
-        if ( p -> primary_resource() == RESOURCE_NONE ) continue;
-        if ( p -> regen_type != REGEN_STATIC ) continue;
-
-        p -> regen( sim().regen_periodicity );
-      }
-    }
-    else
-    {
-      auto p = sim().player_no_pet_list[ sim().current_index ];
-      if ( p -> primary_resource() != RESOURCE_NONE && p -> regen_type == REGEN_STATIC )
-      {
-        p -> regen( sim().regen_periodicity );
-        for ( auto pet : p -> pet_list )
-        {
-          if ( ! pet -> is_sleeping() && p -> primary_resource() != RESOURCE_NONE &&
-               p -> regen_type == REGEN_STATIC )
-          {
-            pet -> regen( sim().regen_periodicity );
-          }
-        }
-      }
-    }
-
-    make_event<regen_event_t>( sim(), sim() );
-  }
-};
-
 /// List of files from which to look for Blizzard API key
 std::vector<std::string> get_api_key_locations()
 {
@@ -1344,7 +1324,6 @@ sim_t::sim_t( sim_t* p, int index ) :
   confidence( 0.95 ), confidence_estimator( 0.0 ),
   world_lag( timespan_t::from_seconds( 0.1 ) ), world_lag_stddev( timespan_t::min() ),
   travel_variance( 0 ), default_skill( 1.0 ), reaction_time( timespan_t::from_seconds( 0.5 ) ),
-  regen_periodicity( timespan_t::from_seconds( 0.25 ) ),
   ignite_sampling_delta( timespan_t::from_seconds( 0.2 ) ),
   fixed_time( false ), optimize_expressions( false ),
   current_slot( -1 ),
@@ -1355,7 +1334,7 @@ sim_t::sim_t( sim_t* p, int index ) :
   save_talent_str( 0 ),
   talent_format( TALENT_FORMAT_UNCHANGED ),
   auto_ready_trigger( 0 ), stat_cache( 1 ), max_aoe_enemies( 20 ), show_etmi( 0 ), tmi_window_global( 0 ), tmi_bin_size( 0.5 ),
-  requires_regen_event( false ), single_actor_batch( false ),
+  single_actor_batch( false ),
   enemy_death_pct( 0 ), rel_target_level( -1 ), target_level( -1 ), target_adds( 0 ), desired_targets( 0 ), enable_taunts( false ),
   challenge_mode( false ), timewalk( -1 ), scale_to_itemlevel( -1 ), scale_itemlevel_down_only( false ), disable_artifacts( false ),
   disable_set_bonuses( false ), disable_2_set( 1 ), disable_4_set( 1 ), enable_2_set( 1 ), enable_4_set( 1 ),
@@ -1373,11 +1352,15 @@ sim_t::sim_t( sim_t* p, int index ) :
   reforge_plot( new reforge_plot_t( this ) ),
   elapsed_cpu( 0.0 ),
   elapsed_time( 0.0 ),
+  monitor_init( false ), init_phase_time(),
+  target_cache_rebuilds( 0 ), target_cache_updates( 0 ),
+  allocation_audit( false ), allocation_audit_count( 0 ), allocation_audit_iterations( 0 ),
   iteration_dmg( 0 ), priority_iteration_dmg( 0 ), iteration_heal( 0 ), iteration_absorb( 0 ),
   raid_dps(), total_dmg(), raid_hps(), total_heal(), total_absorb(), raid_aps(),
   simulation_length( "Simulation Length", false ),
   report_iteration_data( 0.025 ), min_report_iteration_data( -1 ),
   report_progress( 1 ),
+  batch_entry( false ),
   bloodlust_percent( 25 ), bloodlust_time( timespan_t::from_seconds( 0.5 ) ),
   // Report
   report_precision(2), report_pets_separately( 0 ), report_targets( 1 ), report_details( 1 ), report_raw_abilities( 1 ),
@@ -1391,8 +1374,11 @@ sim_t::sim_t( sim_t* p, int index ) :
   global_item_upgrade_level( 0 ),
   maximize_reporting( false ),
   apikey( get_api_key() ),
+  armory_threads( 4 ),
+  armory_rate( 0 ),
   ilevel_raid_report( false ),
   distance_targeting_enabled( false ),
+  actor_grid( *this ),
   enable_dps_healing( false ),
   scaling_normalized( 1.0 ),
   // Multi-Threading
@@ -1410,6 +1396,8 @@ sim_t::sim_t( sim_t* p, int index ) :
   item_db_sources.assign( std::begin( default_item_db_sources ),
                           std::end( default_item_db_sources ) );
 
+  target_non_sleeping_list.register_callback( [ this ]( player_t* ) { actor_grid.invalidate(); } );
+
   max_time = timespan_t::from_seconds( 300 );
   vary_combat_length = 0.2;
   use_optimal_buffs_and_debuffs( 1 );
@@ -1571,9 +1559,22 @@ void sim_t::combat()
   // combat_end   will flush any events remaining due to early termination
   // In the future, flushing may occur in event manager execute().
 
+  // The first iteration warms up caches and free lists, audit the steady state after it
+  bool audit = allocation_audit && current_iteration > 0;
+  uint64_t allocations = allocation_audit::allocations();
+  if ( audit )
+    allocation_audit::record( true );
+
   combat_begin();
   event_mgr.execute();
   combat_end();
+
+  if ( audit )
+  {
+    allocation_audit::record( false );
+    allocation_audit_count += allocation_audit::allocations() - allocations;
+    allocation_audit_iterations++;
+  }
 }
 
 /// Reset simulation.
@@ -1587,6 +1588,8 @@ void sim_t::reset()
 
   event_mgr.reset();
 
+  actor_grid.invalidate();
+
   expected_iteration_time = max_time * iteration_time_adjust();
 
   for ( auto& buff : buff_list )
@@ -1648,6 +1651,9 @@ void sim_t::combat_begin()
   if ( debug )
     out_debug << "Combat Begin";
 
+  if ( trace )
+    trace -> iteration( current_iteration );
+
   reset();
 
   // Debug seed needs to be done _after_ sim reset, because deterministic=1 will reseed in
@@ -1697,9 +1703,6 @@ void sim_t::combat_begin()
     }
   }
 
-  if ( requires_regen_event )
-    make_event<regen_event_t>( *this, *this );
-
   if ( overrides.bloodlust )
   {
      make_event<bloodlust_check_t>( *this, *this );
@@ -2140,6 +2143,7 @@ bool sim_t::init_actors()
 bool sim_t::init_actor( player_t* p )
 {
   bool ret = true;
+  init_phase_monitor_t actor_monitor( this, INIT_PHASE_ACTOR );
 
   // initialize class/enemy modules
   for ( player_e i = PLAYER_NONE; i < PLAYER_MAX; ++i )
@@ -2167,9 +2171,12 @@ bool sim_t::init_actor( player_t* p )
   p -> init_character_properties();
 
   // Initialize each actor's items, construct gear information & stats
-  if ( ! p -> init_items() )
   {
-    ret = false;
+    init_phase_monitor_t monitor( this, INIT_PHASE_ITEMS );
+    if ( ! p -> init_items() )
+    {
+      ret = false;
+    }
   }
 
   p -> init_artifact();
@@ -2179,15 +2186,21 @@ bool sim_t::init_actor( player_t* p )
 
   // First-phase creation of special effects from various sources. Needed to be able to create
   // actions (APLs, really) based on the presence of special effects on items.
-  if ( ! p -> create_special_effects() )
   {
-    ret = false;
+    init_phase_monitor_t monitor( this, INIT_PHASE_SPECIAL_EFFECTS );
+    if ( ! p -> create_special_effects() )
+    {
+      ret = false;
+    }
   }
 
   // First, create all the action objects and set up action lists properly
-  if ( ! p -> create_actions() )
   {
-    ret = false;
+    init_phase_monitor_t monitor( this, INIT_PHASE_ACTION_LISTS );
+    if ( ! p -> create_actions() )
+    {
+      ret = false;
+    }
   }
 
   // Create all actor pets before special effects get initialized. This ensures that we can use
@@ -2197,15 +2210,21 @@ bool sim_t::init_actor( player_t* p )
   p -> create_pets();
 
   // Second-phase initialize all special effects and register them to actors
-  if ( ! p -> init_special_effects() )
   {
-    ret = false;
+    init_phase_monitor_t monitor( this, INIT_PHASE_SPECIAL_EFFECTS );
+    if ( ! p -> init_special_effects() )
+    {
+      ret = false;
+    }
   }
 
   // Finally, initialize all action objects
-  if ( ! p -> init_actions() )
   {
-    ret = false;
+    init_phase_monitor_t monitor( this, INIT_PHASE_ACTIONS );
+    if ( ! p -> init_actions() )
+    {
+      ret = false;
+    }
   }
 
   // Once all transient properties are initialized (e.g., base stats, spells, special effects,
@@ -2275,6 +2294,19 @@ bool sim_t::init()
 
   event_mgr.init();
 
+  // Threads of the sim write to the trace file opened in setup(), scaling and plotting sims are
+  // not traced
+  if ( thread_index > 0 && parent -> trace )
+  {
+    trace = std::unique_ptr<trace::writer_t>( new trace::writer_t( *this, parent -> trace -> sink() ) );
+  }
+
+  if ( allocation_audit && ! allocation_audit::available() )
+  {
+    errorf( "allocation_audit=1 requires a build with SC_ALLOCATION_AUDIT (make ALLOCATION_AUDIT=1), disabling." );
+    allocation_audit = false;
+  }
+
   unique_gear::register_target_data_initializers( this );
 
   // Seed RNG
@@ -2391,15 +2423,6 @@ bool sim_t::init()
 
   simulation_length.reserve( std::min( iterations, 10000 ) );
 
-  for ( const auto& player : player_list )
-  {
-    if ( player -> regen_type == REGEN_STATIC )
-    {
-      requires_regen_event = true;
-      break;
-    }
-  }
-
   // We are committed to simulating something. Tell actors that the sim init is now complete if they
   // need to do something.
   if ( ! canceled )
@@ -2549,6 +2572,9 @@ bool sim_t::iterate()
 
   reset();
 
+  if ( trace )
+    trace -> flush();
+
   iterations = current_iteration + 1;
 
   return iterations > 0;
@@ -2595,6 +2621,16 @@ void sim_t::merge( sim_t& other_sim )
   raid_aps.merge( other_sim.raid_aps );
   event_mgr.merge( other_sim.event_mgr );
 
+  for ( size_t i = 0; i < init_phase_time.size(); ++i )
+  {
+    init_phase_time[ i ] += other_sim.init_phase_time[ i ];
+  }
+
+  target_cache_rebuilds += other_sim.target_cache_rebuilds;
+  target_cache_updates += other_sim.target_cache_updates;
+  allocation_audit_count += other_sim.allocation_audit_count;
+  allocation_audit_iterations += other_sim.allocation_audit_iterations;
+
   for ( auto & buff : buff_list )
   {
     if ( buff_t* otherbuff = buff_t::find( &other_sim, buff -> name_str.c_str() ) )
@@ -2713,7 +2749,11 @@ bool sim_t::execute()
   bool success = iterate();
   merge(); // Always merge, even in cases of unsuccessful simulation!
   if( success )
+  {
+    if ( ! parent && ! save_results_file_str.empty() )
+      results::snapshot( *this );
     analyze();
+  }
 
   elapsed_cpu  = util::cpu_time()  - start_cpu_time;
   elapsed_time = util::wall_time() - start_wall_time;
@@ -2949,7 +2989,7 @@ void sim_t::print_options()
 
 void sim_t::add_option( std::unique_ptr<option_t> opt )
 {
-  options.insert( options.begin(), std::move(opt) );
+  options.push_front( std::move( opt ) );
 }
 
 // sim_t::create_options ====================================================
@@ -2969,6 +3009,7 @@ void sim_t::create_options()
   add_option( opt_float( "confidence", confidence, 0.0, 1.0 ) );
   add_option( opt_func( "spell_query", parse_spell_query ) );
   add_option( opt_string( "spell_query_xml_output_file", spell_query_xml_output_file_str ) );
+  add_option( opt_string( "spell_query_json_output_file", spell_query_json_output_file_str ) );
   add_option( opt_func( "item_db_source", parse_item_sources ) );
   add_option( opt_func( "proxy", parse_proxy ) );
   add_option( opt_int( "auto_ready_trigger", auto_ready_trigger ) );
@@ -3012,8 +3053,11 @@ void sim_t::create_options()
   add_option( opt_int( "healing", healing ) );
   add_option( opt_string( "xml", xml_file_str ) );
   add_option( opt_string( "xml_style", xml_stylesheet_file_str ) );
+  add_option( opt_string( "save_results", save_results_file_str ) );
+  add_option( opt_string( "load_results", load_results_file_str ) );
   add_option( opt_bool( "log", log ) );
   add_option( opt_string( "output", output_file_str ) );
+  add_option( opt_string( "trace", trace_file_str ) );
   add_option( opt_bool( "save_raid_summary", save_raid_summary ) );
   add_option( opt_bool( "save_gear_comments", save_gear_comments ) );
   add_option( opt_bool( "buff_uptime_timeline", buff_uptime_timeline ) );
@@ -3026,7 +3070,7 @@ void sim_t::create_options()
   add_option( opt_bool( "override.allow_flasks", allow_flasks ) );
   add_option( opt_bool( "override.bloodlust", overrides.bloodlust ) );
   // Regen
-  add_option( opt_timespan( "regen_periodicity", regen_periodicity ) );
+  add_option( opt_func( "regen_periodicity", parse_regen_periodicity ) );
   // RNG
   add_option( opt_string( "rng", rng_str ) );
   add_option( opt_bool( "deterministic", deterministic ) );
@@ -3133,8 +3177,12 @@ void sim_t::create_options()
   add_option( opt_bool( "report_raid_summary", report_raid_summary ) ); // Force reporting of raid summary
   add_option( opt_string( "reforge_plot_output_file", reforge_plot_output_file_str ) );
   add_option( opt_bool( "monitor_cpu", event_mgr.monitor_cpu ) );
+  add_option( opt_bool( "monitor_init", monitor_init ) );
+  add_option( opt_bool( "allocation_audit", allocation_audit ) );
   add_option( opt_func( "maximize_reporting", parse_maximize_reporting ) );
   add_option( opt_string( "apikey", apikey ) );
+  add_option( opt_int( "armory_threads", armory_threads, 1, 64 ) );
+  add_option( opt_float( "armory_rate", armory_rate ) );
   add_option( opt_bool( "ilevel_raid_report", ilevel_raid_report ) );
   add_option( opt_bool( "distance_targeting_enabled", distance_targeting_enabled ) );
   add_option( opt_bool( "enable_dps_healing", enable_dps_healing ) );
@@ -3148,6 +3196,9 @@ void sim_t::create_options()
   add_option( opt_bool( "show_hotfixes", display_hotfixes ) );
   // Bonus ids
   add_option( opt_bool( "show_bonus_ids", display_bonus_ids ) );
+  // Binary client data
+  add_option( opt_string( "dbc_file", dbc_file_str ) );
+  add_option( opt_string( "dbc_export", dbc_export_file_str ) );
 }
 
 // sim_t::parse_option ======================================================
@@ -3173,7 +3224,8 @@ void sim_t::setup( sim_control_t* c )
 
   control = c;
 
-  if ( ! parent ) cache::advance_era();
+  // A batch advances the era once for all of its entries (see batch_t in sc_main.cpp)
+  if ( ! parent && ! batch_entry ) cache::advance_era();
 
   // Global Options
   for ( const auto& option : control -> options )
@@ -3247,6 +3299,18 @@ void sim_t::setup( sim_control_t* c )
       throw std::runtime_error( s.str() );
     }
   }
+
+  if ( ! parent && ! trace_file_str.empty() )
+  {
+    auto sink = std::make_shared<trace::sink_t>( trace_file_str );
+    if ( ! sink -> is_open() )
+    {
+      std::stringstream s;
+      s << "Unable to open trace file '" << trace_file_str << "'";
+      throw std::runtime_error( s.str() );
+    }
+    trace = std::unique_ptr<trace::writer_t>( new trace::writer_t( *this, sink ) );
+  }
   if ( debug_each )
     debug = 1;
 
@@ -3395,7 +3459,11 @@ void sim_t::errorf( const char* fmt, ... )
   util::replace_all( s, "\n", "" );
   std::cerr << s << "\n";
 
-  error_list.push_back( s );
+  // Errors of reports generated concurrently are added once all reports are done
+  if ( report::thread_output_t* output = report::thread_output() )
+    output -> errors.push_back( s );
+  else
+    error_list.push_back( s );
 }
 
 void sim_t::abort()
@@ -3417,6 +3485,17 @@ void sim_t::abort()
 /// add chart to sim for end of report processing
 void sim_t::add_chart_data( const highchart::chart_t& chart )
 {
+  // Html sections rendered on worker threads collect their charts, see report::thread_output_t
+  report::thread_output_t* output = report::thread_output();
+  if ( output && output -> capture_charts )
+  {
+    if ( chart.toggle_id_str_.empty() )
+      output -> on_ready_chart_data.push_back( chart.to_aggregate_string( false ) );
+    else
+      output -> chart_data.push_back( std::make_pair( chart.toggle_id_str_, chart.to_data() ) );
+    return;
+  }
+
   if ( chart.toggle_id_str_.empty() )
   {
     on_ready_chart_data.push_back( chart.to_aggregate_string( false ) );
@@ -3429,6 +3508,12 @@ void sim_t::add_chart_data( const highchart::chart_t& chart )
 
 void sim_t::print_spell_query()
 {
+  if ( spell_query_xml_output_file_str.empty() && spell_query_json_output_file_str.empty() )
+  {
+    report::print_spell_query( std::cout, *this, *spell_query, spell_query_level );
+    return;
+  }
+
   if ( ! spell_query_xml_output_file_str.empty() )
   {
     io::cfile file( spell_query_xml_output_file_str.c_str(), "w" );
@@ -3437,13 +3522,20 @@ void sim_t::print_spell_query()
       std::cerr << "Unable to open spell query xml output file '" << spell_query_xml_output_file_str << "', using stdout instead\n";
       file = io::cfile( stdout, io::cfile::no_close() );
     }
-    std::shared_ptr<xml_node_t> root( new xml_node_t( "spell_query" ) );
 
-    report::print_spell_query( root.get(), file, *this, *spell_query, spell_query_level );
+    report::print_spell_query( file, *this, *spell_query, spell_query_level );
   }
-  else
+
+  if ( ! spell_query_json_output_file_str.empty() )
   {
-    report::print_spell_query( std::cout, *this, *spell_query, spell_query_level );
+    io::cfile file( spell_query_json_output_file_str.c_str(), "w" );
+    if ( ! file )
+    {
+      std::cerr << "Unable to open spell query json output file '" << spell_query_json_output_file_str << "', using stdout instead\n";
+      file = io::cfile( stdout, io::cfile::no_close() );
+    }
+
+    report::print_spell_query_json( file, *this, *spell_query, spell_query_level );
   }
 }
 
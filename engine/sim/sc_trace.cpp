@@ -0,0 +1,303 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#include "simulationcraft.hpp"
+
+// Record layouts, after the u8 type and i32 timestamp. Name ids are u32, 0 for no name (a buff
+// without an actor is a raid buff), and a tick of -1 marks direct damage or healing.
+//
+// NAME           id, u16 length, text
+// ITERATION      i32 iteration
+// EXECUTE        actor, action, f64 primary resource
+// CONSUME        actor, action, resource, f64 amount, f64 current resource
+// DAMAGE         actor, action, target, school, result, f64 amount, i32 tick, i32 ticks
+// HEAL           actor, action, target, result, f64 total, f64 amount, i32 tick, i32 ticks
+// AVOID          target, actor, action, result
+// BUFF_GAIN      actor, buff, i32 stack, f64 value
+// BUFF_LOSS      actor, buff
+// RESOURCE_GAIN  actor, resource, source, f64 actual, f64 amount, f64 current, f64 max
+
+namespace { // UNNAMED NAMESPACE
+
+const uint32_t TRACE_VERSION = 1;
+
+// Blocks are written when full, so this is also the largest block in the file
+const size_t BUFFER_SIZE = 64 * 1024;
+// Longer names are truncated, so that any record fits in an empty buffer
+const size_t MAX_NAME_LENGTH = 1024;
+const size_t RECORD_HEADER_SIZE = sizeof( uint8_t ) + sizeof( int32_t );
+
+enum record_e
+{
+  RECORD_NAME = 1,
+  RECORD_ITERATION,
+  RECORD_EXECUTE,
+  RECORD_CONSUME,
+  RECORD_DAMAGE,
+  RECORD_HEAL,
+  RECORD_AVOID,
+  RECORD_BUFF_GAIN,
+  RECORD_BUFF_LOSS,
+  RECORD_RESOURCE_GAIN
+};
+
+// Values are written in host byte order, which the file format assumes is little endian
+void write_u32( FILE* file, uint32_t value )
+{
+  fwrite( &value, sizeof( value ), 1, file );
+}
+
+} // UNNAMED NAMESPACE
+
+// trace::sink_t::sink_t ====================================================
+
+trace::sink_t::sink_t( const std::string& file_name ) :
+  file( io::fopen( file_name, "wb" ) )
+{
+  if ( file )
+  {
+    fwrite( "SCTR", 4, 1, file );
+    write_u32( file, TRACE_VERSION );
+  }
+}
+
+// trace::sink_t::~sink_t ===================================================
+
+trace::sink_t::~sink_t()
+{
+  if ( file )
+    fclose( file );
+}
+
+// trace::sink_t::write_block ===============================================
+
+void trace::sink_t::write_block( uint32_t writer_id, const char* data, size_t size )
+{
+  auto_lock_t lock( mutex );
+
+  if ( ! file )
+    return;
+
+  write_u32( file, writer_id );
+  write_u32( file, static_cast<uint32_t>( size ) );
+  fwrite( data, 1, size, file );
+}
+
+// trace::writer_t::writer_t ================================================
+
+trace::writer_t::writer_t( sim_t& s, std::shared_ptr<sink_t> sink ) :
+  sim( s ),
+  _sink( std::move( sink ) ),
+  writer_id( static_cast<uint32_t>( s.thread_index ) ),
+  buffer( BUFFER_SIZE ),
+  size( 0 ),
+  names( 1 )
+{
+}
+
+// trace::writer_t::~writer_t ===============================================
+
+trace::writer_t::~writer_t()
+{
+  flush();
+}
+
+// trace::writer_t::flush ===================================================
+
+void trace::writer_t::flush()
+{
+  if ( size == 0 )
+    return;
+
+  _sink -> write_block( writer_id, buffer.data(), size );
+  size = 0;
+}
+
+// trace::writer_t::put =====================================================
+
+template <typename T>
+void trace::writer_t::put( T value )
+{
+  std::memcpy( &buffer[ size ], &value, sizeof( value ) );
+  size += sizeof( value );
+}
+
+// trace::writer_t::begin ===================================================
+
+void trace::writer_t::begin( uint8_t type, size_t record_size )
+{
+  if ( size + RECORD_HEADER_SIZE + record_size > buffer.size() )
+    flush();
+
+  put( type );
+  put( static_cast<int32_t>( sim.current_time().total_millis() ) );
+}
+
+// trace::writer_t::name ====================================================
+
+uint32_t trace::writer_t::name( const char* str )
+{
+  if ( ! str )
+    return 0;
+
+  auto it = name_ids.find( str );
+  if ( it != name_ids.end() && names[ it -> second ] == str )
+    return it -> second;
+
+  uint32_t id = static_cast<uint32_t>( names.size() );
+  names.push_back( str );
+  name_ids[ str ] = id;
+
+  uint16_t length = static_cast<uint16_t>( std::min( names.back().size(), MAX_NAME_LENGTH ) );
+  begin( RECORD_NAME, sizeof( id ) + sizeof( length ) + length );
+  put( id );
+  put( length );
+  std::memcpy( &buffer[ size ], str, length );
+  size += length;
+
+  return id;
+}
+
+// trace::writer_t::iteration ===============================================
+
+void trace::writer_t::iteration( int iteration )
+{
+  begin( RECORD_ITERATION, sizeof( int32_t ) );
+  put( static_cast<int32_t>( iteration ) );
+}
+
+// trace::writer_t::execute =================================================
+
+void trace::writer_t::execute( const action_t* action, double resource )
+{
+  uint32_t actor_id = name( action -> player -> name() );
+  uint32_t action_id = name( action -> name() );
+
+  begin( RECORD_EXECUTE, 2 * sizeof( uint32_t ) + sizeof( double ) );
+  put( actor_id );
+  put( action_id );
+  put( resource );
+}
+
+// trace::writer_t::consume =================================================
+
+void trace::writer_t::consume( const action_t* action, resource_e resource, double amount, double current )
+{
+  uint32_t actor_id = name( action -> player -> name() );
+  uint32_t action_id = name( action -> name() );
+  uint32_t resource_id = name( util::resource_type_string( resource ) );
+
+  begin( RECORD_CONSUME, 3 * sizeof( uint32_t ) + 2 * sizeof( double ) );
+  put( actor_id );
+  put( action_id );
+  put( resource_id );
+  put( amount );
+  put( current );
+}
+
+// trace::writer_t::damage ==================================================
+
+void trace::writer_t::damage( const action_state_t* state, int tick, int num_ticks )
+{
+  const action_t* action = state -> action;
+  uint32_t actor_id = name( action -> player -> name() );
+  uint32_t action_id = name( action -> name() );
+  uint32_t target_id = name( state -> target -> name() );
+  uint32_t school_id = name( util::school_type_string( action -> get_school() ) );
+  uint32_t result_id = name( util::result_type_string( state -> result ) );
+
+  begin( RECORD_DAMAGE, 5 * sizeof( uint32_t ) + sizeof( double ) + 2 * sizeof( int32_t ) );
+  put( actor_id );
+  put( action_id );
+  put( target_id );
+  put( school_id );
+  put( result_id );
+  put( state -> result_amount );
+  put( static_cast<int32_t>( tick ) );
+  put( static_cast<int32_t>( num_ticks ) );
+}
+
+// trace::writer_t::heal ====================================================
+
+void trace::writer_t::heal( const action_state_t* state, int tick, int num_ticks )
+{
+  const action_t* action = state -> action;
+  uint32_t actor_id = name( action -> player -> name() );
+  uint32_t action_id = name( action -> name() );
+  uint32_t target_id = name( state -> target -> name() );
+  uint32_t result_id = name( util::result_type_string( state -> result ) );
+
+  begin( RECORD_HEAL, 4 * sizeof( uint32_t ) + 2 * sizeof( double ) + 2 * sizeof( int32_t ) );
+  put( actor_id );
+  put( action_id );
+  put( target_id );
+  put( result_id );
+  put( state -> result_total );
+  put( state -> result_amount );
+  put( static_cast<int32_t>( tick ) );
+  put( static_cast<int32_t>( num_ticks ) );
+}
+
+// trace::writer_t::avoid ===================================================
+
+void trace::writer_t::avoid( const action_state_t* state )
+{
+  const action_t* action = state -> action;
+  uint32_t target_id = name( state -> target -> name() );
+  uint32_t actor_id = name( action -> player -> name() );
+  uint32_t action_id = name( action -> name() );
+  uint32_t result_id = name( util::result_type_string( state -> result ) );
+
+  begin( RECORD_AVOID, 4 * sizeof( uint32_t ) );
+  put( target_id );
+  put( actor_id );
+  put( action_id );
+  put( result_id );
+}
+
+// trace::writer_t::buff_gain ===============================================
+
+void trace::writer_t::buff_gain( const buff_t* buff )
+{
+  uint32_t actor_id = buff -> player ? name( buff -> player -> name() ) : 0;
+  uint32_t buff_id = name( buff -> name() );
+
+  begin( RECORD_BUFF_GAIN, 2 * sizeof( uint32_t ) + sizeof( int32_t ) + sizeof( double ) );
+  put( actor_id );
+  put( buff_id );
+  put( static_cast<int32_t>( buff -> current_stack ) );
+  put( buff -> current_value );
+}
+
+// trace::writer_t::buff_loss ===============================================
+
+void trace::writer_t::buff_loss( const buff_t* buff )
+{
+  uint32_t actor_id = buff -> player ? name( buff -> player -> name() ) : 0;
+  uint32_t buff_id = name( buff -> name() );
+
+  begin( RECORD_BUFF_LOSS, 2 * sizeof( uint32_t ) );
+  put( actor_id );
+  put( buff_id );
+}
+
+// trace::writer_t::resource_gain ===========================================
+
+void trace::writer_t::resource_gain( const player_t* actor, resource_e resource, const char* source,
+                                     double actual, double amount, double current, double max )
+{
+  uint32_t actor_id = name( actor -> name() );
+  uint32_t resource_id = name( util::resource_type_string( resource ) );
+  uint32_t source_id = name( source );
+
+  begin( RECORD_RESOURCE_GAIN, 3 * sizeof( uint32_t ) + 4 * sizeof( double ) );
+  put( actor_id );
+  put( resource_id );
+  put( source_id );
+  put( actual );
+  put( amount );
+  put( current );
+  put( max );
+}
@@ -40,6 +40,7 @@
 #include <sstream>
 #include <stack>
 #include <string>
+#include <typeindex>
 #include <typeinfo>
 #include <vector>
 #include <bitset>
@@ -54,11 +55,6 @@
 #include <Availability.h>
 #endif
 
-// Needed for usleep in engine/interface/sc_bcp_api.cpp when default apikey builds are done
-#if defined( SC_DEFAULT_APIKEY ) && ! defined( SC_WINDOWS )
-#include <unistd.h>
-#endif
-
 // Forward Declarations =====================================================
 
 struct absorb_buff_t;
@@ -170,6 +166,7 @@ inline int snprintf( char* buf, size_t size, const char* fmt, ... )
 #include "sc_util.hpp"
 
 #include "util/stopwatch.hpp"
+#include "util/allocation_audit.hpp"
 #include "sim/sc_option.hpp"
 
 // Data Access ==============================================================
@@ -317,7 +314,7 @@ struct raid_event_t : private noncopyable
 
   timespan_t saved_duration;
   std::vector<player_t*> affected_players;
-  std::vector<std::unique_ptr<option_t>> options;
+  option_registry_t options;
 
   raid_event_t( sim_t*, const std::string& );
 private:
@@ -329,7 +326,7 @@ public:
   virtual bool filter_player( const player_t* );
 
   void add_option( std::unique_ptr<option_t> new_option )
-  { options.insert( options.begin(), std::move(new_option) ); }
+  { options.push_front( std::move( new_option ) ); }
   timespan_t cooldown_time();
   timespan_t duration_time();
   timespan_t next_time() { return next; }
@@ -987,6 +984,7 @@ public:
   virtual timespan_t tick_time() const;
 
   void add_invalidate( cache_e );
+  void update_regen();
 #if defined(SC_USE_STAT_CACHE)
   virtual void invalidate_cache();
 #else
@@ -1287,11 +1285,13 @@ private:
   std::vector<std::function<void(T)> > _callbacks ;
 public:
   /* Register your custom callback, which will be called when the vector is modified
+   * Callbacks are only registered during init; the std::function is moved into place, and calling
+   * it does not allocate memory.
    */
   void register_callback( std::function<void(T)> c )
   {
     if ( c )
-      _callbacks.push_back( c );
+      _callbacks.push_back( std::move( c ) );
   }
 
   typename std::vector<T>::iterator begin()
@@ -1458,6 +1458,107 @@ struct event_manager_t
   void merge( event_manager_t& other );
 };
 
+// Actor Grid ===============================================================
+
+/* Uniform grid spatial index over the positions of active enemies. Distance targeting queries
+ * it once per target list, and discards the targets outside of the queried area without
+ * computing their distance. The grid is rebuilt lazily when the active enemy list changes; code
+ * that moves enemies must call invalidate().
+ */
+struct actor_grid_t
+{
+  actor_grid_t( sim_t& s, double cell_size = 10.0 );
+
+  void invalidate()
+  { is_valid = false; }
+
+  // Select the indexed actors that can be within distance (plus their combat reach, if
+  // with_combat_reach is set) of the given coordinates
+  void query( double x, double y, double distance, bool with_combat_reach );
+
+  // True if the actor was selected by the last query, or is not indexed at all
+  bool candidate( const player_t* actor ) const;
+
+private:
+  sim_t& sim;
+  double cell_size;
+  bool is_valid;
+  double max_combat_reach;
+  // (cell key, actor) pairs, sorted by cell key
+  std::vector<std::pair<uint64_t, player_t*> > cells;
+  // Per actor index, the generation the actor was indexed in, and the last query selecting it
+  std::vector<unsigned> indexed, selected;
+  unsigned generation, query_id;
+
+  void rebuild();
+  int cell( double coord ) const;
+  static uint64_t key( int cx, int cy );
+};
+
+// Combat Trace =============================================================
+
+/* Binary form of the combat log (trace=<file>), cheap enough to record every iteration of a
+ * multi-threaded sim. Each sim thread appends fixed layout records to its own buffer, and writes
+ * the buffer to the shared file as one block when it fills up. Strings (actor, action, buff
+ * names) are written once per thread as name records, and referred to by id afterwards.
+ * util_scripts/decode_trace.py converts a trace back to the text of log=1.
+ *
+ * File: "SCTR", u32 version, then blocks of { u32 thread index, u32 size, records }. Records start
+ * with a u8 type and an i32 timestamp in milliseconds, followed by the type specific fields
+ * documented in sc_trace.cpp, in little endian byte order.
+ */
+namespace trace
+{
+struct sink_t : private noncopyable
+{
+  sink_t( const std::string& file_name );
+  ~sink_t();
+
+  bool is_open() const
+  { return file != nullptr; }
+  void write_block( uint32_t writer_id, const char* data, size_t size );
+
+private:
+  mutex_t mutex;
+  FILE* file;
+};
+
+struct writer_t : private noncopyable
+{
+  writer_t( sim_t& sim, std::shared_ptr<sink_t> sink );
+  ~writer_t();
+
+  const std::shared_ptr<sink_t>& sink() const
+  { return _sink; }
+
+  void iteration( int iteration );
+  void execute( const action_t* action, double resource );
+  void consume( const action_t* action, resource_e resource, double amount, double current );
+  void damage( const action_state_t* state, int tick, int num_ticks );
+  void heal( const action_state_t* state, int tick, int num_ticks );
+  void avoid( const action_state_t* state );
+  void buff_gain( const buff_t* buff );
+  void buff_loss( const buff_t* buff );
+  void resource_gain( const player_t* actor, resource_e resource, const char* source,
+                      double actual, double amount, double current, double max );
+  void flush();
+
+private:
+  sim_t& sim;
+  std::shared_ptr<sink_t> _sink;
+  uint32_t writer_id;
+  std::vector<char> buffer;
+  size_t size;
+  // Interned strings, by address. The text is kept to detect a different string at a reused address.
+  std::unordered_map<const char*, uint32_t> name_ids;
+  std::vector<std::string> names;
+
+  uint32_t name( const char* str );
+  void begin( uint8_t type, size_t record_size );
+  template <typename T> void put( T value );
+};
+} // trace
+
 // Simulation Engine ========================================================
 
 struct sim_t : private sc_thread_t
@@ -1511,12 +1612,15 @@ struct sim_t : private sc_thread_t
   // Latency
   timespan_t  world_lag, world_lag_stddev;
   double      travel_variance, default_skill;
-  timespan_t  reaction_time, regen_periodicity;
+  timespan_t  reaction_time;
   timespan_t  ignite_sampling_delta;
   bool        fixed_time, optimize_expressions;
   int         current_slot;
   int         optimal_raid, log, debug_each;
   std::vector<uint64_t> debug_seed;
+  // Binary combat log, see trace::writer_t. Unlike log=1, does not limit threads or iterations.
+  std::string trace_file_str;
+  std::unique_ptr<trace::writer_t> trace;
   int         save_profiles, default_actions;
   stat_e      normalized_stat;
   std::string current_name, default_region_str, default_server_str, save_prefix_str, save_suffix_str;
@@ -1530,7 +1634,6 @@ struct sim_t : private sc_thread_t
   bool        show_etmi;
   double      tmi_window_global;
   double      tmi_bin_size;
-  bool        requires_regen_event;
   bool        single_actor_batch;
 
   // Target options
@@ -1565,7 +1668,7 @@ struct sim_t : private sc_thread_t
   int active_allies;
 
   std::unordered_map<std::string, std::string> var_map;
-  std::vector<std::unique_ptr<option_t>> options;
+  option_registry_t options;
   std::vector<std::string> party_encoding;
   std::vector<std::string> item_db_sources;
 
@@ -1611,6 +1714,16 @@ struct sim_t : private sc_thread_t
   std::unique_ptr<reforge_plot_t> reforge_plot;
   double elapsed_cpu;
   double elapsed_time;
+  // Accumulated (thread) cpu time of actor initialization phases, collected with monitor_init=1
+  bool monitor_init;
+  std::array<double, INIT_PHASE_MAX> init_phase_time;
+  // Action target cache recomputations, and active enemy list changes applied incrementally
+  uint64_t target_cache_rebuilds, target_cache_updates;
+  // Heap allocations during iterations after the first one, counted with allocation_audit=1
+  // in builds with SC_ALLOCATION_AUDIT
+  bool allocation_audit;
+  uint64_t allocation_audit_count;
+  int allocation_audit_iterations;
   double     iteration_dmg, priority_iteration_dmg,  iteration_heal, iteration_absorb;
   simple_sample_data_t raid_dps, total_dmg, raid_hps, total_heal, total_absorb, raid_aps;
   extended_sample_data_t simulation_length;
@@ -1622,6 +1735,8 @@ struct sim_t : private sc_thread_t
   // Minimum number of low/high iterations reported (default 5 of each)
   int        min_report_iteration_data;
   int        report_progress;
+  // Simulated as an entry of a batch (see batch=), in a process shared with the other entries
+  bool       batch_entry;
   int        bloodlust_percent;
   timespan_t bloodlust_time;
   std::string reference_player_str;
@@ -1637,8 +1752,13 @@ struct sim_t : private sc_thread_t
   std::vector<player_t*> targets_by_name;
   std::vector<std::string> id_dictionary;
   std::map<double, std::vector<double> > divisor_timeline_cache;
+  // Expressions in RPN token form, filled while the top level sim initializes and reused by all
+  // child sims to skip tokenization (see expr_t::parse)
+  std::unordered_map<std::string, std::vector<expression::expr_token_t> > expression_cache;
   std::string output_file_str, html_file_str, json_file_str;
   std::string xml_file_str, xml_stylesheet_file_str;
+  std::string save_results_file_str, load_results_file_str;
+  std::string results_snapshot; // merged, not yet analyzed results, see results::snapshot()
   std::string reforge_plot_output_file_str;
   std::vector<std::string> error_list;
   int report_precision;
@@ -1663,8 +1783,12 @@ struct sim_t : private sc_thread_t
   int global_item_upgrade_level;
   bool maximize_reporting;
   std::string apikey;
+  // Armory imports: characters downloaded concurrently, and requests per second (0 = no limit)
+  int armory_threads;
+  double armory_rate;
   bool ilevel_raid_report;
   bool distance_targeting_enabled;
+  actor_grid_t actor_grid;
   bool enable_dps_healing;
   double scaling_normalized;
 
@@ -1756,6 +1880,8 @@ struct sim_t : private sc_thread_t
   std::unique_ptr<spell_data_expr_t> spell_query;
   unsigned           spell_query_level;
   std::string        spell_query_xml_output_file_str;
+  // One JSON object per line and result
+  std::string        spell_query_json_output_file_str;
 
   mutex_t* pause_mutex; // External pause mutex, instantiated an external entity (in our case the GUI).
   bool paused;
@@ -1780,11 +1906,15 @@ struct sim_t : private sc_thread_t
   bool display_hotfixes, disable_hotfixes;
   bool display_bonus_ids;
 
+  // Binary client data file to load ( dbc_file, command line only ) or write ( dbc_export )
+  std::string dbc_file_str, dbc_export_file_str;
+
   sim_t( sim_t* parent = nullptr, int thread_index = 0 );
   virtual ~sim_t();
 
   virtual void run() override;
   int       main( const std::vector<std::string>& args );
+  bool      run_and_report();
   double    iteration_time_adjust() const;
   double    expected_max_time() const;
   bool      is_canceled() const;
@@ -1851,6 +1981,27 @@ private:
   void disable_debug_seed();
 };
 
+// Scoped actor initialization phase timer, accumulates into sim_t::init_phase_time when
+// monitor_init=1
+struct init_phase_monitor_t
+{
+  sim_t* sim;
+  init_phase_e phase;
+  stopwatch_t stopwatch;
+
+  init_phase_monitor_t( sim_t* s, init_phase_e p ) :
+    sim( s ), phase( p ), stopwatch( STOPWATCH_THREAD )
+  { }
+
+  ~init_phase_monitor_t()
+  {
+    if ( sim -> monitor_init )
+    {
+      sim -> init_phase_time[ phase ] += stopwatch.elapsed();
+    }
+  }
+};
+
 // Module ===================================================================
 
 struct module_t
@@ -2557,6 +2708,17 @@ struct item_t
     }
   } parsed;
 
+  // Item data as initialized from the item data sources, before the rest of the item
+  // initialization. Built once by the parent sim, and shared read-only with the child sims. The
+  // children copy the parsed data out of it, as the rest of the item initialization modifies it.
+  struct source_data_t
+  {
+    parsed_input_t parsed;
+    std::shared_ptr<xml_node_t> xml;
+    std::string name_str, icon_str, source_str;
+  };
+  std::shared_ptr<const source_data_t> source_data;
+
   std::shared_ptr<xml_node_t> xml;
 
   std::string name_str;
@@ -2610,6 +2772,7 @@ struct item_t
   bool init();
   bool parse_options();
   bool initialize_data(); // Initializes item data from a data source
+  bool initialize_data_from_parent(); // Initializes item data from the parent sim's item
   inventory_type inv_type() const;
 
   bool is_matching_type() const;
@@ -2932,12 +3095,16 @@ struct cooldown_t
   sim_t& sim;
   player_t* player;
   std::string name_str;
-  timespan_t duration;
+  timespan_t duration; // Use set_duration() to change it in combat
   timespan_t ready;
   timespan_t reset_react;
   int charges;
-  int current_charge;
-  event_t* recharge_event;
+  int current_charge; // Charges as of the last update_charges() call
+  // Charge recovery is tracked analytically: the charge currently recovering is regained at
+  // recharge_end (timespan_t::max() if no charge is recovering), and further charges follow in
+  // cycles of recharge_base_duration. Regained charges are accounted for lazily by update_charges().
+  timespan_t recharge_end, recharge_duration, recharge_base_duration;
+  event_t* recharge_trigger_event; // Wakes up ready_trigger players when a charge is regained
   event_t* ready_trigger_event;
   timespan_t last_start, last_charged;
   double recharge_multiplier;
@@ -2957,19 +3124,43 @@ struct cooldown_t
 
   void reset_init();
 
+  // Account for the charges regained since the last call. Must be called before reading or
+  // modifying current_charge or last_charged directly.
+  void update_charges()
+  {
+    if ( recharge_end <= sim.current_time() )
+      regain_charges();
+  }
+
+  // Change the duration in combat. Recharge cycles that have ended by now are accounted for
+  // first, so the cycle following them has the length it had when they ended.
+  void set_duration( timespan_t d )
+  {
+    update_charges();
+    duration = d;
+  }
+
+  // Return true if a charge is currently recovering
+  bool recharging() const
+  { return recharge_end != timespan_t::max(); }
+
+  // A charge that has been regained, but not yet accounted for, makes the cooldown ready
   timespan_t remains() const
-  { return std::max( timespan_t::zero(), ready - sim.current_time() ); }
+  { return recharge_end <= sim.current_time() ? timespan_t::zero() : std::max( timespan_t::zero(), ready - sim.current_time() ); }
 
-  timespan_t current_charge_remains() const
-  { return recharge_event != NULL ? recharge_event -> remains() : timespan_t::zero(); }
+  timespan_t current_charge_remains()
+  {
+    update_charges();
+    return recharging() ? recharge_end - sim.current_time() : timespan_t::zero();
+  }
 
   // return true if the cooldown is done (i.e., the associated ability is ready)
   bool up() const
-  { return ready <= sim.current_time(); }
+  { return ready <= sim.current_time() || recharge_end <= sim.current_time(); }
 
   // Return true if the cooldown is currently ticking down
   bool down() const
-  { return ready > sim.current_time(); }
+  { return ! up(); }
 
   // Return true if the action bound to this cooldown is ready. Cooldowns are ready either when
   // their cooldown has elapsed, or a short while before its cooldown is finished. The latter case
@@ -2979,7 +3170,7 @@ struct cooldown_t
 
   // Return the queueing delay for cooldowns that are queueable
   timespan_t queue_delay() const
-  { return std::max( timespan_t::zero(), ready - sim.current_time() ); }
+  { return remains(); }
 
   const char* name() const
   { return name_str.c_str(); }
@@ -2993,6 +3184,11 @@ struct cooldown_t
   { return timespan_t::from_seconds( -60 * 60 ); }
 
   static timespan_t cooldown_duration( const cooldown_t* cd, const timespan_t& override_duration = timespan_t::min() );
+
+  void regain_charges();
+  void set_recharge( timespan_t end, timespan_t duration );
+  // Keep a wake up event at recharge_end for ready_trigger players
+  void update_recharge_trigger();
 };
 
 // Player Callbacks
@@ -3012,7 +3208,11 @@ struct effect_callbacks_t
 
   proc_array_t procs;
 
-  effect_callbacks_t( sim_t* sim ) : sim( sim )
+  // Callback dispatch statistics: callbacks invoked, and callbacks in the dispatched proc lists
+  // that were skipped (inactive, or cannot trigger for the action)
+  uint64_t n_invoked, n_skipped;
+
+  effect_callbacks_t( sim_t* sim ) : sim( sim ), n_invoked( 0 ), n_skipped( 0 )
   { }
 
   virtual ~effect_callbacks_t()
@@ -3021,6 +3221,9 @@ struct effect_callbacks_t
   void reset();
 
   void register_callback( unsigned proc_flags, unsigned proc_flags2, T_CB* cb );
+
+  // Trigger the proc callbacks of the given proc types, that can trigger for the action
+  void trigger( proc_types type, proc_types2 type2, action_t* a, action_state_t* state );
 private:
   void add_proc_callback( proc_types type, unsigned flags, T_CB* cb );
 };
@@ -3260,6 +3463,7 @@ struct player_collected_data_t
 
   health_changes_timeline_t health_changes;     //records all health changes
   health_changes_timeline_t health_changes_tmi; //records only health changes due to damage and self-healng/self-absorb
+  std::vector<double> tmi_window_buffer; // scratch buffer for the TMI calculation
 
   struct action_sequence_data_t
   {
@@ -3298,8 +3502,8 @@ struct player_collected_data_t
   void analyze( const player_t& );
   void collect_data( const player_t& );
   void print_tmi_debug_csv( const sc_timeline_t* nma, const std::vector<double>& weighted_value, const player_t& p );
-  double calculate_tmi( const health_changes_timeline_t& tl, int window, double f_length, const player_t& p );
-  double calculate_max_spike_damage( const health_changes_timeline_t& tl, int window );
+  double calculate_tmi( const health_changes_timeline_t& tl, int window, double f_length, const player_t& p,
+                        double* max_spike = nullptr );
   std::ostream& data_str( std::ostream& s ) const;
 };
 
@@ -3496,6 +3700,23 @@ struct scaling_metric_data_t {
     name( name ), value( tl.mean() ), stddev( tl.mean_stddev() ), metric( m ) {}
 };
 
+/* Free lists of action states shared by all actions of an actor, one list per state type. An
+ * action binds to the list of its state type on its first allocation, so states released by
+ * one action are reused by every other action with the same state layout.
+ */
+struct action_state_pool_t : private noncopyable
+{
+  std::unordered_map<std::type_index, action_state_t*> free_lists;
+  // State allocations in total, and after the first iteration (steady state)
+  uint64_t n_allocated, n_steady_allocated;
+
+  action_state_pool_t() : n_allocated( 0 ), n_steady_allocated( 0 )
+  { }
+  ~action_state_pool_t();
+
+  action_state_t*& free_list( const action_state_t* state );
+};
+
 struct player_t : public actor_t
 {
   static const int default_level = 110;
@@ -3557,7 +3778,7 @@ struct player_t : public actor_t
   dbc_t       dbc;
 
   // Option Parsing
-  std::vector<std::unique_ptr<option_t>> options;
+  option_registry_t options;
 
   // Stat Timelines to Display
   std::vector<stat_e> stat_timelines;
@@ -3736,6 +3957,7 @@ struct player_t : public actor_t
 
   // Callbacks
   effect_callbacks_t<action_callback_t> callbacks;
+  action_state_pool_t state_pool;
   auto_dispose< std::vector<special_effect_t*> > special_effects;
   std::vector<std::function<void(player_t*)> > callbacks_on_demise;
 
@@ -4029,6 +4251,10 @@ struct player_t : public actor_t
   virtual void combat_begin();
   virtual void combat_end();
   virtual void merge( player_t& other );
+  // Class modules that merge collected data of their own in merge() return true. That data is not
+  // stored in results files, so load_results= warns about it.
+  virtual bool merges_module_data() const
+  { return false; }
 
   virtual void datacollection_begin();
   virtual void datacollection_end();
@@ -4274,7 +4500,7 @@ struct player_t : public actor_t
   {
     // Push_front so derived classes (eg. enemy_t) can override existing options
     // (eg. target_level)
-    options.insert( options.begin(), std::move( o ) );
+    options.push_front( std::move( o ) );
   }
   void recreate_talent_str( talent_format_e format = TALENT_FORMAT_NUMBERS );
   virtual std::string create_profile( save_e = SAVE_ALL );
@@ -4533,7 +4759,7 @@ private:
   }
 public:
 
-  // Static (default), Dynamic, Disabled
+  // Dynamic (default), Disabled
   regen_type_e regen_type;
 
   // Last iteration time regenration occurred. Set at player_t::arise()
@@ -4594,25 +4820,59 @@ struct target_specific_t
 {
   bool owner_;
 public:
-  target_specific_t( bool owner = true ) : owner_( owner )
+  target_specific_t( bool owner = true ) : owner_( owner ), block_used( 0 ), block_capacity( 0 )
   { }
 
   T*& operator[](  const player_t* target ) const
   {
     assert( target );
-    if ( data.empty() )
+    if ( data.size() <= target -> actor_index )
     {
       data.resize( target -> sim -> actor_list.size() );
     }
     return data[ target -> actor_index ];
   }
+
+  /* Construct an object in storage owned by this target_specific_t. Objects are allocated in
+   * blocks sized after the actor list, so the data of one source for all of its targets is laid
+   * out densely, instead of one heap allocation per (source, target) pair. Adds recycled by
+   * raid events keep their actor index, and thus their already constructed data. */
+  template <typename... Args>
+  T* create( Args&&... args ) const
+  {
+    if ( block_used == block_capacity )
+    {
+      block_capacity = std::max( data.size(), size_t( 4 ) );
+      blocks.push_back( std::unique_ptr<char[]>( new char[ block_capacity * sizeof( T ) ] ) );
+      block_used = 0;
+    }
+
+    T* obj = new ( blocks.back().get() + block_used * sizeof( T ) ) T( std::forward<Args>( args )... );
+    block_used++;
+    objects.push_back( obj );
+
+    return obj;
+  }
+
   ~target_specific_t()
   {
     if ( owner_ )
-      range::dispose( data );
+    {
+      for ( size_t i = 0; i < data.size(); i++ )
+      {
+        if ( data[ i ] && range::find( objects, data[ i ] ) == objects.end() )
+          delete data[ i ];
+      }
+    }
+
+    for ( size_t i = objects.size(); i > 0; i-- )
+      objects[ i - 1 ] -> ~T();
   }
 private:
   mutable std::vector<T*> data;
+  mutable std::vector<std::unique_ptr<char[]>> blocks;
+  mutable std::vector<T*> objects;
+  mutable size_t block_used, block_capacity;
 };
 
 struct player_event_t : public event_t
@@ -4766,6 +5026,41 @@ public:
   { return active_during_iteration || ( dynamic && sim -> report_pets_separately == 1 ); }
 };
 
+// Pet Pool =================================================================
+
+/* A pool of identical, short lived pets (e.g., Wild Imps) summoned from a single factory.
+ * Members are recycled: spawning summons the first sleeping member instead of searching a
+ * class-specific array. The pool is filled during create_pets(), so actor indices stay
+ * identical between the main and child sims and player_t::merge keeps working; it does not
+ * create fewer pets than the arrays it replaces. Members other than the first one can be made
+ * quiet, and report their actions through the first member's stats (see shared_stats()), unless
+ * report_pets_separately is used. */
+struct pet_pool_t
+{
+  typedef std::function<pet_t*()> factory_t;
+  typedef std::vector<pet_t*>::const_iterator const_iterator;
+
+  std::vector<pet_t*> pets;
+
+  // Create capacity members, all but the first one quiet if quiet is set
+  void create( size_t capacity, const factory_t& factory, bool quiet = true );
+
+  // First sleeping member, or nullptr if all members are active
+  pet_t* acquire() const;
+  // Summon the first sleeping member for the given duration
+  pet_t* spawn( timespan_t duration = timespan_t::zero() );
+
+  stats_t* shared_stats( const pet_t* pet, stats_t* own ) const;
+  size_t n_active() const;
+
+  bool empty() const { return pets.empty(); }
+  size_t size() const { return pets.size(); }
+  pet_t* primary() const { return pets.empty() ? nullptr : pets.front(); }
+  pet_t* operator[]( size_t idx ) const { return pets[ idx ]; }
+  const_iterator begin() const { return pets.begin(); }
+  const_iterator end() const { return pets.end(); }
+};
+
 
 // Gain =====================================================================
 
@@ -5028,13 +5323,23 @@ public:
    * - is_valid: gets invalidated by the callback from the target list source.
    *  When the target list is requested in action_t::target_list(), it gets recalculated if
    *  flag is false, otherwise cached version is used
+   * - is_default: list holds the default targeting (primary target, followed by the other
+   *  active enemies), so active enemy list changes can be applied to it in place. primary and
+   *  size record the state the list was built for, to detect later modifications.
    */
   struct target_cache_t {
     std::vector< player_t* > list;
     bool is_valid;
-    target_cache_t() : is_valid( false ) {}
+    bool is_default;
+    player_t* primary;
+    size_t size;
+    target_cache_t() : is_valid( false ), is_default( false ), primary( nullptr ), size( 0 ) {}
   } mutable target_cache;
 
+  // Reusable copies of the target list for target_if and cycle_targets, which evaluate
+  // expressions that may regenerate the target cache while the list is being iterated
+  std::vector< player_t* > target_if_list, cycle_target_list;
+
   enum target_if_mode_e
   {
     TARGET_IF_NONE,
@@ -5380,9 +5685,10 @@ public:
    */
   cooldown_t line_cooldown;
   const action_priority_t* signature;
-  std::vector<std::unique_ptr<option_t>> options;
+  option_registry_t options;
 
-  action_state_t* state_cache;
+  /// Free list of the action's state type in player -> state_pool, bound on first use
+  action_state_t** state_cache;
 
   /// State of the last execute()
   action_state_t* execute_state;
@@ -5394,6 +5700,20 @@ public:
 private:
   std::vector<travel_event_t*> travel_events;
 
+  /**
+   * Proc callback dispatch masks, built on first use for each proc callback list (of the owner, or
+   * a target of the action) that the action triggers. Bit i of the mask is set if the i'th callback
+   * of the list can trigger for this action. The list size at build time detects callbacks
+   * registered afterwards.
+   */
+  struct callback_mask_t
+  {
+    const std::vector<action_callback_t*>* list;
+    size_t size;
+    uint64_t mask;
+  };
+  std::vector<callback_mask_t> callback_masks;
+
 public:
   action_t( action_e type, const std::string& token, player_t* p, const spell_data_t* s = spell_data_t::nil() );
 
@@ -5417,8 +5737,9 @@ public:
   virtual void parse_effect_data( const spelleffect_data_t& );
   virtual void parse_options( const std::string& options_str );
   void parse_target_str();
+  uint64_t callback_mask( const std::vector<action_callback_t*>& list );
   void add_option( std::unique_ptr<option_t> new_option )
-  { options.insert( options.begin(), std::move(new_option) ); }
+  { options.push_front( std::move( new_option ) ); }
   void   check_spec( specialization_e );
   void   check_spell( const spell_data_t* );
   dot_t* find_dot( player_t* target ) const;
@@ -5529,6 +5850,8 @@ public:
   virtual size_t available_targets( std::vector< player_t* >& ) const;
 
   virtual std::vector< player_t* >& target_list() const;
+  bool is_default_target_list( const std::vector< player_t* >& tl ) const;
+  void update_target_cache( player_t* changed ) const;
 
   virtual player_t* find_target_by_number( int number ) const;
 
@@ -6444,6 +6767,9 @@ struct action_callback_t : private noncopyable
   virtual void initialize() { }
   virtual void activate() { active = true; }
   virtual void deactivate() { active = false; }
+  // Can the callback ever trigger for the action. Used to build the per-action callback dispatch
+  // masks (see action_t::callback_mask), so the result must not change after initialization.
+  virtual bool can_trigger( const action_t* ) const { return true; }
 
   static void trigger( const std::vector<action_callback_t*>& v, action_t* a, void* call_data = nullptr )
   {
@@ -6525,6 +6851,9 @@ struct dbc_proc_callback_t : public action_callback_t
 
   virtual void initialize() override;
 
+  bool can_trigger( const action_t* a ) const override
+  { return ! weapon || a -> weapon == weapon; }
+
   void trigger( action_t* a, void* call_data ) override
   {
     if ( cooldown && cooldown -> down() ) return;
@@ -7283,6 +7612,21 @@ bool download_glyph( player_t* player, std::string& glyph_name, const std::strin
                      cache::behavior_e b = cache::items() );
 }
 
+// Binary Results ===========================================================
+
+// Compact binary results files, which allow reports to be generated again without simulating.
+// Implemented in sim/sc_results.cpp.
+namespace results
+{
+// Capture the merged results of the sim before they are analyzed
+void snapshot( sim_t& );
+// Write the captured results, followed by scale factor and plot results
+bool save( sim_t&, const std::string& file_name );
+// Load a results file into an initialized sim (set up with the options that produced the file)
+// and analyze it, in place of simulating
+bool load( sim_t&, const std::string& file_name );
+}
+
 // HTTP Download  ===========================================================
 
 namespace http
@@ -7295,8 +7639,10 @@ struct proxy_t
 };
 void set_proxy( const std::string& type, const std::string& host, const unsigned port );
 
-void cache_load( const std::string& file_name );
-void cache_save( const std::string& file_name );
+// Use (and create if needed) the persistent url cache in directory. Entries are read on first use.
+void cache_open( const std::string& directory );
+// Evict old entries from the persistent cache, if any were added since it was opened
+void cache_close();
 bool clear_cache( sim_t*, const std::string& name, const std::string& value );
 
 bool get( std::string& result, const std::string& url, const std::string& cleanurl, cache::behavior_e b,
@@ -7531,8 +7877,10 @@ inline void player_t::do_dynamic_regen()
   if ( sim -> current_time() == last_regen )
     return;
 
-  regen( sim -> current_time() - last_regen );
+  // Update the timestamp first, resource gains made by regen() must not regenerate again
+  timespan_t elapsed = sim -> current_time() - last_regen;
   last_regen = sim -> current_time();
+  regen( elapsed );
 
   if ( dynamic_regen_pets )
   {
@@ -8081,6 +8429,37 @@ void effect_callbacks_t<T_CB>::reset()
   T_CB::reset( all_callbacks );
 }
 
+template <typename T_CB>
+void effect_callbacks_t<T_CB>::trigger( proc_types type, proc_types2 type2, action_t* a, action_state_t* state )
+{
+  if ( ! a -> player -> in_combat ) return;
+
+  const proc_list_t& list = procs[ type ][ type2 ];
+  std::size_t size = list.size();
+  if ( size == 0 ) return;
+
+  // Bit i of the mask selects list[ i ], callbacks past the first 64 are always dispatched
+  uint64_t mask = a -> callback_mask( list );
+  uint64_t invoked = 0;
+  std::size_t i = 0;
+  for ( ; i < size; ++i )
+  {
+    if ( i < 64 && ! ( mask & ( uint64_t( 1 ) << i ) ) )
+      continue;
+
+    T_CB* cb = list[ i ];
+    if ( cb -> active )
+    {
+      if ( ! cb -> allow_procs && a -> proc ) break;
+      cb -> trigger( a, state );
+      invoked++;
+    }
+  }
+
+  n_invoked += invoked;
+  n_skipped += size - invoked;
+}
+
 /**
  * Targetdata initializer for items. When targetdata is constructed (due to a call to
  * player_t::get_target_data failing to find an object for the given target), all targetdata
@@ -0,0 +1,179 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#include "allocation_audit.hpp"
+
+#if defined( SC_ALLOCATION_AUDIT )
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined( __GNUC__ ) && ! defined( SC_WINDOWS )
+#include <cxxabi.h>
+#include <dlfcn.h>
+#define SC_AUDIT_CALL_SITE __builtin_return_address( 0 )
+#else
+#define SC_AUDIT_CALL_SITE nullptr
+#endif
+
+namespace {
+
+// Lock free open addressing table of call site -> allocation count. Nothing in the allocation
+// path may allocate memory itself, so the table has a fixed size; call sites that do not fit
+// are counted in the last slot.
+const size_t MAX_SITES = 8192;
+
+std::atomic<uintptr_t> site_address[ MAX_SITES ];
+std::atomic<uint64_t> site_count[ MAX_SITES ];
+
+thread_local bool recording = false;
+thread_local uint64_t n_allocations = 0;
+
+void record_allocation( void* site )
+{
+  n_allocations++;
+
+  uintptr_t address = reinterpret_cast<uintptr_t>( site );
+  size_t slot = ( address >> 4 ) % ( MAX_SITES - 1 );
+  for ( size_t probe = 0; probe < MAX_SITES - 1; ++probe, slot = ( slot + 1 ) % ( MAX_SITES - 1 ) )
+  {
+    uintptr_t current = site_address[ slot ].load( std::memory_order_relaxed );
+    if ( current == 0 && site_address[ slot ].compare_exchange_strong( current, address ) )
+      current = address;
+
+    if ( current == address )
+    {
+      site_count[ slot ].fetch_add( 1, std::memory_order_relaxed );
+      return;
+    }
+  }
+
+  site_count[ MAX_SITES - 1 ].fetch_add( 1, std::memory_order_relaxed );
+}
+
+void* audited_allocate( size_t size, void* site )
+{
+  if ( recording )
+    record_allocation( site );
+
+  void* p = std::malloc( size ? size : 1 );
+  if ( ! p )
+    throw std::bad_alloc();
+  return p;
+}
+
+std::string describe( uintptr_t address )
+{
+  char buf[ 32 ];
+  snprintf( buf, sizeof( buf ), "%p", reinterpret_cast<void*>( address ) );
+  std::string str = buf;
+
+#if defined( __GNUC__ ) && ! defined( SC_WINDOWS )
+  Dl_info info;
+  if ( dladdr( reinterpret_cast<void*>( address ), &info ) && info.dli_sname )
+  {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle( info.dli_sname, nullptr, nullptr, &status );
+    str += ' ';
+    str += status == 0 && demangled ? demangled : info.dli_sname;
+    std::free( demangled );
+  }
+#endif
+
+  return str;
+}
+
+} // unnamed namespace
+
+bool allocation_audit::available()
+{ return true; }
+
+void allocation_audit::record( bool enable )
+{ recording = enable; }
+
+uint64_t allocation_audit::allocations()
+{ return n_allocations; }
+
+std::vector<std::pair<std::string, uint64_t> > allocation_audit::call_sites( size_t max_sites )
+{
+  bool was_recording = recording;
+  recording = false;
+
+  std::vector<std::pair<uintptr_t, uint64_t> > sites;
+  for ( size_t i = 0; i < MAX_SITES; ++i )
+  {
+    uint64_t count = site_count[ i ].load();
+    if ( count > 0 )
+      sites.push_back( std::make_pair( site_address[ i ].load(), count ) );
+  }
+
+  std::sort( sites.begin(), sites.end(),
+             []( const std::pair<uintptr_t, uint64_t>& l, const std::pair<uintptr_t, uint64_t>& r ) {
+               return l.second > r.second;
+             } );
+
+  std::vector<std::pair<std::string, uint64_t> > result;
+  for ( size_t i = 0; i < sites.size() && i < max_sites; ++i )
+  {
+    result.push_back( std::make_pair( sites[ i ].first ? describe( sites[ i ].first ) : "(unknown)",
+                                      sites[ i ].second ) );
+  }
+
+  recording = was_recording;
+  return result;
+}
+
+// Global allocation hooks ==================================================
+
+void* operator new( size_t size )
+{ return audited_allocate( size, SC_AUDIT_CALL_SITE ); }
+
+void* operator new[]( size_t size )
+{ return audited_allocate( size, SC_AUDIT_CALL_SITE ); }
+
+void* operator new( size_t size, const std::nothrow_t& ) noexcept
+{
+  if ( recording )
+    record_allocation( SC_AUDIT_CALL_SITE );
+  return std::malloc( size ? size : 1 );
+}
+
+void* operator new[]( size_t size, const std::nothrow_t& ) noexcept
+{
+  if ( recording )
+    record_allocation( SC_AUDIT_CALL_SITE );
+  return std::malloc( size ? size : 1 );
+}
+
+void operator delete( void* p ) noexcept
+{ std::free( p ); }
+
+void operator delete[]( void* p ) noexcept
+{ std::free( p ); }
+
+void operator delete( void* p, size_t ) noexcept
+{ std::free( p ); }
+
+void operator delete[]( void* p, size_t ) noexcept
+{ std::free( p ); }
+
+#else // SC_ALLOCATION_AUDIT
+
+bool allocation_audit::available()
+{ return false; }
+
+void allocation_audit::record( bool )
+{ }
+
+uint64_t allocation_audit::allocations()
+{ return 0; }
+
+std::vector<std::pair<std::string, uint64_t> > allocation_audit::call_sites( size_t )
+{ return std::vector<std::pair<std::string, uint64_t> >(); }
+
+#endif // SC_ALLOCATION_AUDIT
@@ -0,0 +1,31 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#pragma once
+#include "config.hpp"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* Heap allocation auditing. Builds with SC_ALLOCATION_AUDIT defined (make ALLOCATION_AUDIT=1)
+ * replace the global operator new/delete with counting versions. Allocations made by a thread
+ * while recording is enabled are counted, and attributed to the code calling operator new.
+ * In other builds, the functions below do nothing.
+ */
+namespace allocation_audit
+{
+// True if the allocation hooks are compiled in
+bool available();
+
+// Enable or disable recording of allocations on the calling thread
+void record( bool enable );
+
+// Number of allocations recorded on the calling thread
+uint64_t allocations();
+
+// Allocation call sites recorded by all threads, (description, count), most allocations first
+std::vector<std::pair<std::string, uint64_t> > call_sites( size_t max_sites );
+}
@@ -260,6 +260,14 @@ public:
     _count = 0u;
     _sum   = 0.0;
   }
+
+  // Save or load the collected data (see results::)
+  template <typename Archive>
+  void serialize( Archive& ar )
+  {
+    ar.value( _sum );
+    ar.value( _count );
+  }
 };
 
 /* Second simplest Samplest Data container. Tracks sum, count as well as min/max
@@ -329,6 +337,15 @@ public:
       }
     }
   }
+
+  template <typename Archive>
+  void serialize( Archive& ar )
+  {
+    base_t::serialize( ar );
+    ar.value( _found );
+    ar.value( _min );
+    ar.value( _max );
+  }
 };
 
 /* Extensive sample_data container with two runtime dependent modes:
@@ -569,6 +586,20 @@ public:
       _data.insert( _data.end(), other._data.begin(), other._data.end() );
   }
 
+  // Save or load the collected data (see results::). Only the samples are transferred, the
+  // statistics are computed by analyze().
+  template <typename Archive>
+  void serialize( Archive& ar )
+  {
+    if ( simple )
+      base_t::serialize( ar );
+    else
+    {
+      ar.values( _data );
+      is_sorted = false;
+    }
+  }
+
   std::ostream& data_str( std::ostream& s ) const
   {
     s << "Sample_Data \"" << name_str << "\": count: " << count();
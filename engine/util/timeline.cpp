@@ -1,12 +1,94 @@
 #include "timeline.hpp"
 #include <iostream>
 #ifdef UNIT_TEST
+#include <chrono>
+#include <random>
+
+namespace {
+
+// Theck-Meloree Index kernel, as implemented before sliding_window_exp_sum()
+double reference_exp_sum( const std::vector<double>& data, unsigned window, double scale, double& max_value )
+{
+  std::vector<double> average;
+  average.reserve( data.size() );
+  sliding_window_average( data, window, std::back_inserter( average ) );
+
+  std::vector<double> weighted_value = average;
+  max_value = *std::max_element( weighted_value.begin(), weighted_value.end() ) * window;
+
+  double sum = 0;
+  for ( auto& elem : weighted_value )
+  {
+    elem *= window;
+    elem = std::exp( scale * elem );
+    sum += elem;
+  }
+
+  return sum;
+}
+
+double elapsed( std::chrono::high_resolution_clock::time_point start )
+{
+  return std::chrono::duration<double>( std::chrono::high_resolution_clock::now() - start ).count();
+}
+
+} // UNNAMED NAMESPACE
 
 int main( int /*argc*/, char** /*argv*/ )
 {
-  tl::timeline_t<double> x;
+  // fast_exp() accuracy over its domain
+  double max_exp_error = 0;
+  for ( double x = -708.0; x <= 709.0; x += 0.001 )
+  {
+    max_exp_error = std::max( max_exp_error, std::fabs( fast_exp( x ) / std::exp( x ) - 1.0 ) );
+  }
+  std::cout << "fast_exp max relative error: " << max_exp_error << std::endl;
+
+  // Normalized health change timelines of a 450 second fight, 0.25 second bins, 6 second window
+  const double scale = 10;
+  const unsigned window = 24;
+  const size_t n_bins = 1800, n_timelines = 20000;
+
+  std::mt19937 gen( 1 );
+  std::normal_distribution<double> health_change( 0.01, 0.05 );
+  std::vector<std::vector<double>> timelines( 16, std::vector<double>( n_bins ) );
+  for ( auto& tl : timelines )
+  {
+    std::generate( tl.begin(), tl.end(), [ &gen, &health_change ]() { return health_change( gen ); } );
+  }
+
+  double max_sum_error = 0, max_spike_error = 0;
+  for ( const auto& tl : timelines )
+  {
+    std::vector<double> scratch;
+    double ref_max = 0, max = 0;
+    double ref = reference_exp_sum( tl, window, scale, ref_max );
+    double sum = sliding_window_exp_sum( tl, window, scale, max, scratch );
+    max_sum_error = std::max( max_sum_error, std::fabs( sum / ref - 1.0 ) );
+    max_spike_error = std::max( max_spike_error, std::fabs( max - ref_max ) );
+  }
+  std::cout << "sliding_window_exp_sum max relative error: " << max_sum_error
+            << ", max spike absolute error: " << max_spike_error << std::endl;
+
+  double checksum = 0, max_value = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for ( size_t i = 0; i < n_timelines; ++i )
+  {
+    checksum += reference_exp_sum( timelines[ i % timelines.size() ], window, scale, max_value );
+  }
+  double reference_time = elapsed( start );
+
+  std::vector<double> scratch;
+  start = std::chrono::high_resolution_clock::now();
+  for ( size_t i = 0; i < n_timelines; ++i )
+  {
+    checksum -= sliding_window_exp_sum( timelines[ i % timelines.size() ], window, scale, max_value, scratch );
+  }
+  double fused_time = elapsed( start );
 
-  std::cout << sizeof( double );
+  std::cout << n_timelines << " timelines of " << n_bins << " bins: reference " << reference_time
+            << "sec, fused " << fused_time << "sec, speedup " << reference_time / fused_time
+            << " (checksum " << checksum << ")" << std::endl;
 
   return 0;
 }
@@ -11,11 +11,15 @@
 #include <algorithm>
 #include <cassert>
 #include <numeric>
+#include <cmath>
+#include <cstdint>
 
 #include "generic.hpp"
 #include "sample_data.hpp"
 #include "sc_timespan.hpp"
 
+struct sim_t;
+
 template <typename Fwd, typename Out>
 void sliding_window_average( Fwd first, Fwd last, unsigned window, Out out )
 {
@@ -73,6 +77,141 @@ inline Range& sliding_window_average( Range& r, unsigned window, Out out )
   return r;
 }
 
+/* Fast exp(), written so that loops calling it can be auto-vectorized (no branches, table
+ * lookups, or library calls). Uses a Cody-Waite range reduction to |r| <= ln(2)/2 and a degree 12
+ * Taylor polynomial, for a relative error below 1e-15 compared to std::exp. The argument must be
+ * within [-708, 709], the caller is responsible for handling anything outside of it.
+ */
+inline double fast_exp( double x )
+{
+  // 1.5 * 2^52, adding it to a double of magnitude < 2^51 rounds to an integer stored in the
+  // low bits of the mantissa
+  static const double round_magic = 6755399441055744.0;
+  static const double log2e = 1.4426950408889634074;
+  static const double ln2_hi = 6.93147180369123816490e-01;
+  static const double ln2_lo = 1.90821492927058770002e-10;
+
+  double t = x * log2e + round_magic;
+  double k = t - round_magic;
+  double r = x - k * ln2_hi - k * ln2_lo;
+
+  double p = 1.0 / 479001600.0;
+  p = p * r + 1.0 / 39916800.0;
+  p = p * r + 1.0 / 3628800.0;
+  p = p * r + 1.0 / 362880.0;
+  p = p * r + 1.0 / 40320.0;
+  p = p * r + 1.0 / 5040.0;
+  p = p * r + 1.0 / 720.0;
+  p = p * r + 1.0 / 120.0;
+  p = p * r + 1.0 / 24.0;
+  p = p * r + 1.0 / 6.0;
+  p = p * r + 0.5;
+  p = p * r + 1.0;
+  p = p * r + 1.0;
+
+  // Construct 2^k directly from the integer in the low bits of t
+  int64_t t_bits, magic_bits;
+  std::memcpy( &t_bits, &t, sizeof( t ) );
+  std::memcpy( &magic_bits, &round_magic, sizeof( round_magic ) );
+  int64_t scale_bits = ( t_bits - magic_bits + 1023 ) << 52;
+  double scale;
+  std::memcpy( &scale, &scale_bits, sizeof( scale ) );
+
+  return p * scale;
+}
+
+/* Fused sliding window sum and exponential sum, the kernel of the Theck-Meloree Index.
+ *
+ * Computes the same values as sliding_window_average() multiplied by the window size (i.e., the
+ * sum of data within each window), and returns the sum of exp( scale * value ) over them. The
+ * largest window value is returned in max_value. On return, scratch holds the exponentially
+ * weighted values. It is reused between calls, so no memory is allocated once it has grown to the
+ * data size.
+ */
+inline double sliding_window_exp_sum( const std::vector<double>& data, unsigned window, double scale,
+                                      double& max_value, std::vector<double>& scratch )
+{
+  size_t n = data.size();
+  size_t half_window = window / 2;
+
+  scratch.resize( n );
+  max_value = 0;
+
+  if ( n == 0 )
+  {
+    return 0;
+  }
+
+  double* out = scratch.data();
+  const double* in = data.data();
+
+  if ( n >= window )
+  {
+    double window_sum = 0;
+    size_t right = 0, left = 0, i = 0;
+
+    for ( ; right < half_window; ++right )
+      window_sum += in[ right ];
+
+    for ( ; right < window; ++right )
+    {
+      window_sum += in[ right ];
+      out[ i++ ] = window_sum;
+    }
+
+    for ( ; right < n; ++right )
+    {
+      window_sum += in[ right ] - in[ left++ ];
+      out[ i++ ] = window_sum;
+    }
+
+    while ( i < n )
+    {
+      window_sum -= in[ left++ ];
+      out[ i++ ] = window_sum;
+    }
+  }
+  else
+  {
+    std::fill_n( out, n, std::accumulate( in, in + n, 0.0 ) / n * window );
+  }
+
+  double min_value = *std::min_element( out, out + n );
+  max_value = *std::max_element( out, out + n );
+
+  // Arguments outside fast_exp() domain overflow (or underflow) anyhow, use std::exp to get the
+  // correct infinity (or zero) semantics
+  double lo = scale * min_value, hi = scale * max_value;
+  if ( std::min( lo, hi ) < -708.0 || std::max( lo, hi ) > 709.0 )
+  {
+    double sum = 0;
+    for ( size_t i = 0; i < n; ++i )
+    {
+      out[ i ] = std::exp( scale * out[ i ] );
+      sum += out[ i ];
+    }
+    return sum;
+  }
+
+  for ( size_t i = 0; i < n; ++i )
+    out[ i ] = fast_exp( scale * out[ i ] );
+
+  // Independent partial sums, so the summation is not bound by the latency of a single chain
+  double sums[ 4 ] = { 0, 0, 0, 0 };
+  size_t i = 0;
+  for ( ; i + 4 <= n; i += 4 )
+  {
+    sums[ 0 ] += out[ i ];
+    sums[ 1 ] += out[ i + 1 ];
+    sums[ 2 ] += out[ i + 2 ];
+    sums[ 3 ] += out[ i + 3 ];
+  }
+  for ( ; i < n; ++i )
+    sums[ 0 ] += out[ i ];
+
+  return ( sums[ 0 ] + sums[ 1 ] ) + ( sums[ 2 ] + sums[ 3 ] );
+}
+
 // generic Timeline class
 class timeline_t
 {
@@ -134,6 +273,11 @@ public:
     return statistics::calculate_mean_stddev( data() );
   }
 
+  // Save or load the timeline data (see results::)
+  template <typename Archive>
+  void serialize( Archive& ar )
+  { ar.values( _data ); }
+
   // Merge with other timeline
   void merge( const timeline_t& other )
   {
@@ -394,6 +538,13 @@ struct sc_timeline_t : public timeline_t
   void build_derivative_timeline( sc_timeline_t& out ) const
   { base_t::build_sliding_average_timeline( out, 20 ); }
 
+  template <typename Archive>
+  void serialize( Archive& ar )
+  {
+    base_t::serialize( ar );
+    ar.value( bin_size );
+  }
+
 private:
   static std::vector<double> build_divisor_timeline( const extended_sample_data_t& simulation_length, double bin_size );
 };
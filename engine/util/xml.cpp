@@ -6,6 +6,8 @@
 #include "simulationcraft.hpp"
 #include "rapidxml/rapidxml_print.hpp"
 
+#include <deque>
+
 // XML Reader ==================================================================
 
 namespace { // UNNAMED NAMESPACE =========================================
@@ -32,15 +34,6 @@ new_xml_cache_t new_xml_cache;
 mutex_t xml_mutex;
 
 
-// simplify_xml =============================================================
-
-void simplify_xml( std::string& buffer )
-{
-  util::replace_all( buffer, "&lt;", "<" );
-  util::replace_all( buffer, "&gt;", ">" );
-  util::replace_all( buffer, "&amp;", "&" );
-}
-
 // is_white_space ===========================================================
 
 bool is_white_space( char c )
@@ -62,102 +55,175 @@ bool is_name_char( char c )
   return( c == '_' || c == '-' || c == ':' );
 }
 
-// parse_name ===============================================================
+// unescape =================================================================
 
-bool parse_name( std::string&            name_str,
-                 const std::string&      input,
-                 std::string::size_type& index )
+std::string unescape( const char* str, std::string::size_type size )
 {
-  name_str.clear();
-
-  char c = input[ index ];
+  static const struct { const char* from; std::string::size_type size; char to; } entities[] =
+  {
+    { "&lt;", 4, '<' },
+    { "&gt;", 4, '>' },
+    { "&amp;", 5, '&' },
+  };
 
-  if ( ! is_name_char( c ) )
-    return false;
+  std::string result;
+  result.reserve( size );
 
-  while ( is_name_char( c ) )
+  for ( std::string::size_type i = 0; i < size; ++i )
   {
-    name_str += c;
-    c = input[ ++index ];
+    char c = str[ i ];
+    if ( c == '&' )
+    {
+      for ( size_t j = 0; j < sizeof_array( entities ); ++j )
+      {
+        if ( size - i >= entities[ j ].size && ! strncmp( str + i, entities[ j ].from, entities[ j ].size ) )
+        {
+          c = entities[ j ].to;
+          i += entities[ j ].size - 1;
+          break;
+        }
+      }
+    }
+    result += c;
   }
 
-  return true;
+  return result;
 }
 
 } // UNNAMED NAMESPACE
 
+// xml_document_t ===========================================================
+
+// Storage of a document, owned by its root node. Nodes and strings are kept in deques, so that
+// pointers to them stay valid as the document grows.
+struct xml_document_t
+{
+  // Source of a parsed document. Names are terminated in place, and everything else points into
+  // the buffer by position and size.
+  std::string buffer;
+  // All nodes of the document except the root
+  std::deque<xml_node_t> nodes;
+  // Names and values of built nodes
+  std::deque<std::string> strings;
+
+  const char* store( const std::string& str )
+  {
+    strings.push_back( str );
+    return strings.back().c_str();
+  }
+};
+
+// xml_parm_t::value ========================================================
+
+std::string xml_parm_t::value() const
+{
+  if ( escaped )
+    return unescape( value_ptr, value_size );
+
+  return std::string( value_ptr, value_size );
+}
+
+// xml_parm_t::value_equals =================================================
+
+bool xml_parm_t::value_equals( const std::string& v ) const
+{
+  if ( escaped )
+    return value() == v;
+
+  return v.size() == value_size && ! v.compare( 0, value_size, value_ptr, value_size );
+}
+
+// xml_node_t::xml_node_t ===================================================
+
+xml_node_t::xml_node_t( const std::string& n ) :
+  document( new xml_document_t() )
+{
+  owned_document.reset( document );
+  name_ptr = document -> store( n );
+}
+
+xml_node_t::xml_node_t( xml_document_t* d, const char* n ) :
+  name_ptr( n ), document( d )
+{ }
+
+xml_node_t::~xml_node_t()
+{ }
+
 // xml_node_t::create_parameter =============================================
 
-void xml_node_t::create_parameter( const std::string&      input,
-                                   std::string::size_type& index )
+void xml_node_t::create_parameter( char*& input )
 {
   // required format:  name="value"
 
-  std::string name_str;
-  if ( ! parse_name( name_str, input, index ) )
+  char* name_str = input;
+  while ( is_name_char( *input ) )
+    input++;
+
+  if ( input == name_str || *input != '=' )
     return;
 
-  assert( input[ index ] == '=' );
-  index++;
-  char quote = input[ index ];
+  *input++ = '\0';
+
+  char quote = *input;
   assert( quote == '"' || quote == '\'' );
-  index++;
+  input++;
 
-  std::string::size_type start = index;
-  while ( input[ index ] != quote )
+  char* value_str = input;
+  bool escaped = false;
+  while ( *input && *input != quote )
   {
-    assert( input[ index ] );
-    index++;
+    if ( *input == '&' )
+      escaped = true;
+    input++;
   }
-  std::string value_str = input.substr( start, index - start );
-  index++;
-  simplify_xml( value_str );
+  assert( *input );
 
-  parameters.push_back( xml_parm_t( name_str, value_str ) );
+  parameters.push_back( xml_parm_t( name_str, value_str, input - value_str, escaped ) );
+  if ( *input )
+    input++;
 }
 
 // xml_node_t::create_node ==================================================
 
-std::shared_ptr<xml_node_t> xml_node_t::create_node( sim_t*                  sim,
-                                                     const std::string&      input,
-                                                     std::string::size_type& index )
+xml_node_t* xml_node_t::create_node( sim_t* sim,
+                                     char*& input )
 {
-  char c = input[ index ];
-  if ( c == '?' ) index++;
+  if ( *input == '?' ) input++;
 
-  std::string name_str;
-  parse_name( name_str, input, index );
-  assert( ! name_str.empty() );
+  char* name_str = input;
+  while ( is_name_char( *input ) )
+    input++;
+  assert( input != name_str );
+
+  document -> nodes.emplace_back( document, name_str );
+  xml_node_t* node = &document -> nodes.back();
 
-  std::shared_ptr<xml_node_t> node( new xml_node_t( name_str ) );
-  if ( ! node ) return node;
+  // Terminate the name in place, keeping the character it replaces
+  char c = *input;
+  *input = '\0';
 
-  while ( is_white_space( input[ index ] ) )
+  while ( is_white_space( c ) )
   {
-    node -> create_parameter( input, ++index );
+    node -> create_parameter( ++input );
+    c = *input;
   }
 
-  c = input[ index ];
-
   if ( c == '/' || c == '?' )
   {
-    index += 2;
+    input += 2;
   }
   else if ( c == '>' )
   {
-    node -> create_children( sim, input, ++index );
+    node -> create_children( sim, ++input );
   }
   else
   {
     if ( sim )
     {
-      int start = std::min( 0, ( ( int ) index - 32 ) );
-      sim -> errorf( "Unexpected character '%c' at index=%d node=%s context=%s\n",
-                     c, ( int ) index, node -> name(), input.substr( start, index - start ).c_str() );
-      sim -> out_std.raw() << input << "\n";
+      sim -> errorf( "Unexpected character '%c' at node=%s\n", c, node -> name() );
       sim -> cancel();
     }
-    return std::shared_ptr<xml_node_t>();
+    return nullptr;
   }
 
   return node;
@@ -165,79 +231,76 @@ std::shared_ptr<xml_node_t> xml_node_t::create_node( sim_t*                  sim
 
 // xml_node_t::create_children ==============================================
 
-int xml_node_t::create_children( sim_t*                  sim,
-                                 const std::string&      input,
-                                 std::string::size_type& index )
+int xml_node_t::create_children( sim_t* sim,
+                                 char*& input )
 {
   while ( ! sim || ! sim -> canceled )
   {
-    while ( is_white_space( input[ index ] ) ) index++;
+    while ( is_white_space( *input ) ) input++;
 
-    if ( input[ index ] == '<' )
+    if ( *input == '<' )
     {
-      index++;
+      input++;
 
-      if ( input[ index ] == '/' )
+      if ( *input == '/' )
       {
-        std::string name_str;
-        parse_name( name_str, input, ++index );
-        //assert( name_str == root -> name_str );
-        index++;
+        input++;
+        while ( is_name_char( *input ) ) input++;
+        if ( *input ) input++;
         break;
       }
-      else if ( input[ index ] == '!' )
+      else if ( *input == '!' )
       {
-        index++;
-        if ( input.substr( index, 7 ) == "[CDATA[" )
+        input++;
+        if ( ! strncmp( input, "[CDATA[", 7 ) )
         {
-          index += 7;
-          std::string::size_type finish = input.find( "]]>", index );
-          if ( finish == std::string::npos )
+          input += 7;
+          char* finish = strstr( input, "]]>" );
+          if ( ! finish )
           {
             if ( sim )
             {
-              sim -> errorf( "Unexpected EOF at index %d (%s)\n", ( int ) index, name() );
-              sim -> errorf( "%s\n", input.c_str() );
+              sim -> errorf( "Unexpected EOF in CDATA section (%s)\n", name() );
               sim -> cancel();
             }
             return 0;
           }
-          parameters.push_back( xml_parm_t( "cdata", input.substr( index, finish - index ) ) );
-          index = finish + 2;
+          parameters.push_back( xml_parm_t( "cdata", input, finish - input ) );
+          input = finish + 2;
         }
         else
         {
-          while ( input[ index ] && input[ index ] != '>' ) index++;
-          if ( ! input[ index ] ) break;
+          while ( *input && *input != '>' ) input++;
+          if ( ! *input ) break;
         }
-        index++;
+        input++;
       }
       else
       {
-        std::shared_ptr<xml_node_t> n = create_node( sim, input, index );
+        xml_node_t* n = create_node( sim, input );
         if ( ! n ) return 0;
         children.push_back( n );
       }
     }
-    else if ( input[ index ] == '\0' )
+    else if ( *input == '\0' )
     {
       break;
     }
     else
     {
-      std::string::size_type start = index;
-      while ( input[ index ] )
+      char* start = input;
+      while ( *input )
       {
-        if ( input[ index ] == '<' )
+        if ( *input == '<' )
         {
-          if ( isalpha( input[ index + 1 ] ) ) break;
-          if ( input[ index + 1 ] == '/' ) break;
-          if ( input[ index + 1 ] == '?' ) break;
-          if ( input[ index + 1 ] == '!' ) break;
+          if ( isalpha( input[ 1 ] ) ) break;
+          if ( input[ 1 ] == '/' ) break;
+          if ( input[ 1 ] == '?' ) break;
+          if ( input[ 1 ] == '!' ) break;
         }
-        index++;
+        input++;
       }
-      parameters.push_back( xml_parm_t( ".", input.substr( start, index - start ) ) );
+      parameters.push_back( xml_parm_t( ".", start, input - start ) );
     }
   }
 
@@ -248,16 +311,13 @@ int xml_node_t::create_children( sim_t*                  sim,
 
 xml_node_t* xml_node_t::search_tree( const std::string& node_name )
 {
-  if ( node_name.empty() || node_name == name_str )
+  if ( node_name.empty() || node_name == name_ptr )
     return this;
 
   for ( size_t i = 0; i < children.size(); ++i )
   {
-    if ( children[ i ] )
-    {
-      xml_node_t* node = children[ i ] -> search_tree( node_name );
-      if ( node ) return node;
-    }
+    xml_node_t* node = children[ i ] -> search_tree( node_name );
+    if ( node ) return node;
   }
 
   return nullptr;
@@ -269,19 +329,16 @@ xml_node_t* xml_node_t::search_tree( const std::string& node_name,
                                      const std::string& parm_name,
                                      const std::string& parm_value )
 {
-  if ( node_name.empty() || node_name == name_str )
+  if ( node_name.empty() || node_name == name_ptr )
   {
     xml_parm_t* parm = get_parm( parm_name );
-    if ( parm && parm -> value_str == parm_value ) return this;
+    if ( parm && parm -> value_equals( parm_value ) ) return this;
   }
 
   for ( size_t i = 0; i < children.size(); ++i )
   {
-    if ( children[ i ] )
-    {
-      xml_node_t* node = children[ i ] -> search_tree( node_name, parm_name, parm_value );
-      if ( node ) return node;
-    }
+    xml_node_t* node = children[ i ] -> search_tree( node_name, parm_name, parm_value );
+    if ( node ) return node;
   }
 
   return nullptr;
@@ -333,7 +390,7 @@ std::shared_ptr<xml_node_t> xml_node_t::get( sim_t*             sim,
   if ( ! http::get( result, url, cleanurl, caching, confirmation ) )
     return std::shared_ptr<xml_node_t>();
 
-  if ( std::shared_ptr<xml_node_t> node = xml_node_t::create( sim, result ) )
+  if ( std::shared_ptr<xml_node_t> node = xml_node_t::create( sim, std::move( result ) ) )
   {
     xml_cache_entry_t& c = xml_cache[ url ];
     c.root = node;
@@ -348,16 +405,16 @@ std::shared_ptr<xml_node_t> xml_node_t::get( sim_t*             sim,
 
 // xml_node_t::create =======================================================
 
-std::shared_ptr<xml_node_t> xml_node_t::create( sim_t* sim,
-                                                const std::string& input )
+std::shared_ptr<xml_node_t> xml_node_t::create( sim_t*      sim,
+                                                std::string input )
 {
   std::shared_ptr<xml_node_t> root = std::shared_ptr<xml_node_t>( new xml_node_t( "root" ) );
 
-  std::string buffer = input;
-  std::string::size_type index = 0;
+  // Parse in place, the nodes of the document point into the buffer
+  root -> document -> buffer.swap( input );
+  char* buffer = &root -> document -> buffer[ 0 ];
 
-  if ( root )
-    root -> create_children( sim, buffer, index );
+  root -> create_children( sim, buffer );
 
   return root;
 }
@@ -368,8 +425,8 @@ xml_node_t* xml_node_t::get_child( const std::string& name_str )
 {
   for ( size_t i = 0; i < children.size(); ++i )
   {
-    std::shared_ptr<xml_node_t>& node = children[ i ];
-    if ( node && ( name_str == node -> name_str ) ) return node.get();
+    xml_node_t* node = children[ i ];
+    if ( name_str == node -> name_ptr ) return node;
   }
 
   return nullptr;
@@ -382,10 +439,10 @@ std::vector<xml_node_t*> xml_node_t::get_children( const std::string& name_str )
   std::vector<xml_node_t*> nodes;
   for ( size_t i = 0; i < children.size(); ++i )
   {
-    std::shared_ptr<xml_node_t>& node = children[ i ];
-    if ( node && ( name_str.empty() || name_str == node -> name_str ) )
+    xml_node_t* node = children[ i ];
+    if ( name_str.empty() || name_str == node -> name_ptr )
     {
-      nodes.push_back( node.get() );
+      nodes.push_back( node );
     }
   }
 
@@ -396,7 +453,7 @@ std::vector<xml_node_t*> xml_node_t::get_children( const std::string& name_str )
 
 xml_node_t* xml_node_t::get_node( const std::string& path )
 {
-  if ( path.empty() || path == name_str )
+  if ( path.empty() || path == name_ptr )
     return this;
 
   std::string name_str;
@@ -426,7 +483,7 @@ xml_node_t* xml_node_t::get_node( const std::string& path,
 std::vector<xml_node_t*> xml_node_t::get_nodes( const std::string& path )
 {
   std::vector<xml_node_t*> nodes;
-  if ( path.empty() || path == name_str )
+  if ( path.empty() || path == name_ptr )
   {
     nodes.push_back( this );
   }
@@ -436,13 +493,10 @@ std::vector<xml_node_t*> xml_node_t::get_nodes( const std::string& path )
     xml_node_t* node = split_path( name_str, path );
     if ( ! node ) return nodes;
 
-    for ( size_t i = 0; i < children.size(); ++i )
+    for ( size_t i = 0; i < node -> children.size(); ++i )
     {
-      if ( node -> children[ i ] )
-      {
-        std::vector<xml_node_t*> n = node -> children[ i ] -> get_nodes( name_str );
-        nodes.insert( nodes.end(), n.begin(), n.end() );
-      }
+      std::vector<xml_node_t*> n = node -> children[ i ] -> get_nodes( name_str );
+      nodes.insert( nodes.end(), n.begin(), n.end() );
     }
   }
 
@@ -456,10 +510,10 @@ std::vector<xml_node_t*> xml_node_t::get_nodes( const std::string&        path,
                                                 const std::string&        parm_value )
 {
   std::vector<xml_node_t*> nodes;
-  if ( path.empty() || path == name_str )
+  if ( path.empty() || path == name_ptr )
   {
     xml_parm_t* parm = get_parm( parm_name );
-    if ( parm && parm -> value_str == parm_value )
+    if ( parm && parm -> value_equals( parm_value ) )
     {
       nodes.push_back( this );
     }
@@ -470,13 +524,10 @@ std::vector<xml_node_t*> xml_node_t::get_nodes( const std::string&        path,
     xml_node_t* node = split_path( name_str, path );
     if ( ! node ) return nodes;
 
-    for ( size_t i = 0; i < children.size(); ++i )
+    for ( size_t i = 0; i < node -> children.size(); ++i )
     {
-      if ( node -> children[ i ] )
-      {
-        std::vector<xml_node_t*> n = node -> children[ i ] -> get_nodes( name_str, parm_name, parm_value );
-        nodes.insert( nodes.end(), n.begin(), n.end() );
-      }
+      std::vector<xml_node_t*> n = node -> children[ i ] -> get_nodes( name_str, parm_name, parm_value );
+      nodes.insert( nodes.end(), n.begin(), n.end() );
     }
   }
 
@@ -496,7 +547,7 @@ bool xml_node_t::get_value( std::string&       value,
   xml_parm_t* parm = node -> get_parm( key );
   if ( ! parm ) return false;
 
-  value = parm -> value_str;
+  value = parm -> value();
 
   return true;
 }
@@ -514,7 +565,7 @@ bool xml_node_t::get_value( int&               value,
   xml_parm_t* parm = node -> get_parm( key );
   if ( ! parm ) return false;
 
-  value = atoi( parm -> value_str.c_str() );
+  value = atoi( parm -> value().c_str() );
 
   return true;
 }
@@ -532,7 +583,7 @@ bool xml_node_t::get_value( double&            value,
   xml_parm_t* parm = node -> get_parm( key );
   if ( ! parm ) return false;
 
-  value = atof( parm -> value_str.c_str() );
+  value = atof( parm -> value().c_str() );
 
   return true;
 }
@@ -549,7 +600,7 @@ void xml_node_t::print( FILE*       file,
   for ( size_t i = 0; i < parameters.size(); i++ )
   {
     xml_parm_t& parm = parameters[ i ];
-    util::fprintf( file, " %s=\"%s\"", parm.name(), parm.value_str.c_str() );
+    util::fprintf( file, " %s=\"%s\"", parm.name(), parm.value().c_str() );
   }
   util::fprintf( file, "\n" );
 
@@ -575,12 +626,12 @@ void xml_node_t::print_xml( FILE*       file,
   for ( size_t i = 0; i < parameters.size(); ++i )
   {
     xml_parm_t& parm = parameters[ i ];
-    std::string parm_value = parm.value_str;
+    std::string parm_value = parm.value();
     util::replace_all( parm_value, "&", "&amp;" );
     util::replace_all( parm_value, "\"", "&quot;" );
     util::replace_all( parm_value, "<", "&lt;" );
     util::replace_all( parm_value, ">", "&gt;" );
-    if ( parm.name_str == "." )
+    if ( ! strcmp( parm.name(), "." ) )
       content = parm_value;
     else
       util::fprintf( file, " %s=\"%s\"", parm.name(), parm_value.c_str() );
@@ -613,7 +664,7 @@ xml_parm_t* xml_node_t::get_parm( const std::string& parm_name )
 {
   for ( size_t i = 0; i < parameters.size(); ++i )
   {
-    if ( parm_name == parameters[ i ].name_str )
+    if ( parm_name == parameters[ i ].name() )
     {
       return &( parameters[ i ] );
     }
@@ -625,10 +676,18 @@ xml_parm_t* xml_node_t::get_parm( const std::string& parm_name )
 
 xml_node_t* xml_node_t::add_child( const std::string& name )
 {
-  std::shared_ptr<xml_node_t> node( new xml_node_t( name ) );
-  if ( node )
-    children.push_back( node );
-  return node.get();
+  document -> nodes.emplace_back( document, document -> store( name ) );
+  xml_node_t* node = &document -> nodes.back();
+  children.push_back( node );
+  return node;
+}
+
+// xml_node_t::add_parm_str =================================================
+
+void xml_node_t::add_parm_str( const std::string& name, const std::string& value )
+{
+  const char* value_str = document -> store( value );
+  parameters.push_back( xml_parm_t( document -> store( name ), value_str, value.size() ) );
 }
 
 // XML Writer ================================================================
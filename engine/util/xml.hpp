@@ -107,22 +107,36 @@ private:
 
 // XML Reader ==================================================================
 
+struct xml_document_t;
+
+// Names and values point into the storage of the document the node belongs to. For parsed
+// documents that is the source buffer, parsed in place; attribute values are unescaped when read.
 struct xml_parm_t
 {
-  std::string name_str;
-  std::string value_str;
-  xml_parm_t( const std::string& n, const std::string& v ) : name_str( n ), value_str( v ) {}
-  const char* name() { return name_str.c_str(); }
+  const char* name_ptr;
+  const char* value_ptr;
+  std::string::size_type value_size;
+  bool escaped;
+
+  xml_parm_t( const char* n, const char* v, std::string::size_type size, bool e = false ) :
+    name_ptr( n ), value_ptr( v ), value_size( size ), escaped( e ) {}
+  const char* name() const { return name_ptr; }
+  std::string value() const;
+  bool value_equals( const std::string& v ) const;
 };
 
 struct xml_node_t
 {
-  std::string name_str;
-  std::vector<std::shared_ptr<xml_node_t> > children;
+  const char* name_ptr;
+  std::vector<xml_node_t*> children;
   std::vector<xml_parm_t> parameters;
-  xml_node_t() {}
-  xml_node_t( const std::string& n ) : name_str( n ) {}
-  const char* name() { return name_str.c_str(); }
+  xml_document_t* document;
+  std::unique_ptr<xml_document_t> owned_document; // Root node only
+
+  xml_node_t( const std::string& n ); // Creates the root node of a new document
+  xml_node_t( xml_document_t* d, const char* n );
+  ~xml_node_t();
+  const char* name() { return name_ptr; }
   xml_node_t* get_child( const std::string& name );
   xml_node_t* get_node ( const std::string& path );
   xml_node_t* get_node ( const std::string& path, const std::string& parm_name, const std::string& parm_value );
@@ -134,9 +148,9 @@ struct xml_node_t
   bool get_value( double&      value, const std::string& path = std::string() );
   xml_parm_t* get_parm( const std::string& parm_name );
 
-  std::shared_ptr<xml_node_t> create_node     ( sim_t* sim, const std::string& input, std::string::size_type& index );
-  int         create_children ( sim_t* sim, const std::string& input, std::string::size_type& index );
-  void        create_parameter( const std::string& input, std::string::size_type& index );
+  xml_node_t* create_node     ( sim_t* sim, char*& input );
+  int         create_children ( sim_t* sim, char*& input );
+  void        create_parameter( char*& input );
 
   xml_node_t* search_tree( const std::string& node_name );
   xml_node_t* search_tree( const std::string& node_name, const std::string& parm_name, const std::string& parm_value );
@@ -146,15 +160,16 @@ struct xml_node_t
   void print_xml( FILE* f = stdout, int spacing = 0 );
   static std::shared_ptr<xml_node_t> get( sim_t* sim, const std::string& url, const std::string& cleanurl, cache::behavior_e b,
                           const std::string& confirmation = std::string() );
-  static std::shared_ptr<xml_node_t> create( sim_t* sim, const std::string& input );
+  static std::shared_ptr<xml_node_t> create( sim_t* sim, std::string input );
 
   xml_node_t* add_child( const std::string& name );
+  void add_parm_str( const std::string& name, const std::string& value );
   template <typename T>
   void add_parm( const std::string& name, const T& value )
   {
     std::ostringstream s;
     s << value;
-    parameters.push_back( xml_parm_t( name, s.str() ) );
+    add_parm_str( name, s.str() );
   }
 };
 
@@ -177,9 +177,8 @@ void SC_MainWindow::loadHistory()
   else
     showMaximized();
 
-  QString cache_file = TmpDir + "/simc_cache.dat";
-  std::string cache_file_str = cache_file.toStdString();
-  http::cache_load( cache_file_str.c_str() );
+  QString cache_dir = TmpDir + "/simc_cache";
+  http::cache_open( cache_dir.toStdString() );
 
   QVariant history = settings.value( "user_data/historyList" );
   if ( history.isValid() )
@@ -215,9 +214,7 @@ void SC_MainWindow::saveHistory()
   settings.setValue( "maximized", bool( windowState() & Qt::WindowMaximized ) );
   settings.endGroup();
 
-  QString cache_file = TmpDir + "/simc_cache.dat";
-  std::string cache_file_str = cache_file.toStdString();
-  http::cache_save( cache_file_str.c_str() );
+  http::cache_close();
 
   settings.beginGroup( "user_data" );
 
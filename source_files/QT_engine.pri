@@ -13,6 +13,7 @@
  HEADERS += engine/util/generic.hpp
  HEADERS += engine/util/concurrency.hpp
  HEADERS += engine/util/cache.hpp
+ HEADERS += engine/util/allocation_audit.hpp
  HEADERS += engine/sim/sc_option.hpp
  HEADERS += engine/sim/sc_expressions.hpp
  HEADERS += engine/report/sc_report.hpp
@@ -36,8 +37,11 @@
  SOURCES += engine/util/rng.cpp
  SOURCES += engine/util/io.cpp
  SOURCES += engine/util/concurrency.cpp
+ SOURCES += engine/util/allocation_audit.cpp
+ SOURCES += engine/sim/sc_trace.cpp
  SOURCES += engine/sim/sc_sim.cpp
  SOURCES += engine/sim/sc_scaling.cpp
+ SOURCES += engine/sim/sc_results.cpp
  SOURCES += engine/sim/sc_reforge_plot.cpp
  SOURCES += engine/sim/sc_raid_event.cpp
  SOURCES += engine/sim/sc_progress_bar.cpp
@@ -76,6 +80,7 @@
  SOURCES += engine/dbc/sc_item_data_import_ptr.cpp
  SOURCES += engine/dbc/sc_item_data_import_noptr.cpp
  SOURCES += engine/dbc/sc_item_data.cpp
+ SOURCES += engine/dbc/sc_data_file.cpp
  SOURCES += engine/dbc/sc_data.cpp
  SOURCES += engine/dbc/sc_const_data.cpp
  SOURCES += engine/class_modules/sc_warrior.cpp
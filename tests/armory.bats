@@ -0,0 +1,29 @@
+load test_helper
+
+function guild_import() {
+  STUB_DIR="$(mktemp -d "${BATS_TMPDIR}/simc_armory.XXXXXX")"
+  python3 "${BATS_TEST_DIRNAME}/http_stub_server.py" "${STUB_DIR}" &
+  STUB_PID=$!
+  for i in $(seq 50); do
+    [ -s "${STUB_DIR}/port" ] && break
+    sleep 0.1
+  done
+  OPTIONS="guild=us,stubrealm,stubguild proxy=http,127.0.0.1,$(cat "${STUB_DIR}/port") $@"
+  cd "${STUB_DIR}"
+  run "${SIMC_CLI_PATH}" ${OPTIONS} iterations=${SIMC_ITERATIONS} threads=2
+  cd -
+  kill "${STUB_PID}"
+}
+
+@test "Guild import downloads members concurrently" {
+  guild_import armory_threads=4
+  [ "${status}" -eq 0 ]
+  [ "$(grep -c '^Downloading character' <<< "${output}")" -eq 8 ]
+  grep -q 'requests=8 max_in_flight=[234]$' "${STUB_DIR}/stats"
+}
+
+@test "Guild import respects the download thread limit" {
+  guild_import armory_threads=1
+  [ "${status}" -eq 0 ]
+  grep -q 'requests=8 max_in_flight=1$' "${STUB_DIR}/stats"
+}
@@ -0,0 +1,67 @@
+load test_helper
+
+function batch_manifest() {
+  MANIFEST="${BATS_TMPDIR}/simc_batch.txt"
+  rm -f "${BATS_TMPDIR}"/simc_batch_*.json
+  echo "# Batch test manifest" > "${MANIFEST}"
+  echo "\"${SIMC_PROFILE}\" fight_style=Patchwerk" >> "${MANIFEST}"
+  echo "\"${SIMC_PROFILE}\" fight_style=HelterSkelter" >> "${MANIFEST}"
+}
+
+@test "Batch mode" {
+  batch_manifest
+  run "${SIMC_CLI_PATH}" batch="${MANIFEST}" iterations=${SIMC_ITERATIONS} threads=1
+  [ "${status}" -eq 0 ]
+  [ -s "${BATS_TMPDIR}/simc_batch_2.json" ]
+  [ -s "${BATS_TMPDIR}/simc_batch_3.json" ]
+}
+
+@test "Concurrent batch mode" {
+  batch_manifest
+  run "${SIMC_CLI_PATH}" batch="${MANIFEST}" batch_threads=2 iterations=${SIMC_ITERATIONS} threads=1
+  [ "${status}" -eq 0 ]
+  [ -s "${BATS_TMPDIR}/simc_batch_2.json" ]
+  [ -s "${BATS_TMPDIR}/simc_batch_3.json" ]
+}
+
+@test "Spell data overrides are rejected in batch entries" {
+  MANIFEST="${BATS_TMPDIR}/simc_batch_override.txt"
+  rm -f "${BATS_TMPDIR}"/simc_batch_override_*.json
+  echo "\"${SIMC_PROFILE}\" override.spell_data=spell.133.cooldown=60000" > "${MANIFEST}"
+  echo "\"${SIMC_PROFILE}\"" >> "${MANIFEST}"
+  run "${SIMC_CLI_PATH}" batch="${MANIFEST}" iterations=${SIMC_ITERATIONS} threads=1
+  [ "${status}" -ne 0 ]
+  printf '%s\n' "${lines[@]}" | grep -q 'Batch entry 1: Setup failure: override.spell_data'
+  [ ! -e "${BATS_TMPDIR}/simc_batch_override_1.json" ]
+  [ -s "${BATS_TMPDIR}/simc_batch_override_2.json" ]
+}
+
+@test "Process-wide http options are rejected in batch entries, and accepted on the command line" {
+  MANIFEST="${BATS_TMPDIR}/simc_batch_process.txt"
+  rm -f "${BATS_TMPDIR}"/simc_batch_process_*.json
+  echo "\"${SIMC_PROFILE}\" cache_players=only" > "${MANIFEST}"
+  echo "\"${SIMC_PROFILE}\" proxy=http,localhost,3128" >> "${MANIFEST}"
+  echo "\"${SIMC_PROFILE}\"" >> "${MANIFEST}"
+  run "${SIMC_CLI_PATH}" batch="${MANIFEST}" iterations=${SIMC_ITERATIONS} threads=1
+  [ "${status}" -ne 0 ]
+  printf '%s\n' "${lines[@]}" | grep -q 'Batch entry 1: Setup failure: cache_players'
+  printf '%s\n' "${lines[@]}" | grep -q 'Batch entry 2: Setup failure: proxy'
+  [ -s "${BATS_TMPDIR}/simc_batch_process_3.json" ]
+  echo "\"${SIMC_PROFILE}\"" > "${MANIFEST}"
+  run "${SIMC_CLI_PATH}" batch="${MANIFEST}" cache_items=1 iterations=${SIMC_ITERATIONS} threads=1
+  [ "${status}" -eq 0 ]
+}
+
+@test "Batch entries save results and write reports like a single simulation" {
+  MANIFEST="${BATS_TMPDIR}/simc_batch_results.txt"
+  RESULTS="${BATS_TMPDIR}/simc_batch_results.json"
+  rm -f "${RESULTS}" "${BATS_TMPDIR}/simc_batch_results_load.json"
+  echo "\"${SIMC_PROFILE}\" save_results=${RESULTS} json=${BATS_TMPDIR}/simc_batch_results_sim.json" > "${MANIFEST}"
+  run "${SIMC_CLI_PATH}" batch="${MANIFEST}" iterations=${SIMC_ITERATIONS} threads=1
+  [ "${status}" -eq 0 ]
+  [ -s "${RESULTS}" ]
+  echo "\"${SIMC_PROFILE}\" load_results=${RESULTS} json=${BATS_TMPDIR}/simc_batch_results_load.json" > "${MANIFEST}"
+  run "${SIMC_CLI_PATH}" batch="${MANIFEST}" threads=1
+  [ "${status}" -eq 0 ]
+  [ -s "${BATS_TMPDIR}/simc_batch_results_load.json" ]
+}
@@ -0,0 +1,46 @@
+load test_helper
+
+function export_data_file() {
+  DATA_FILE="${BATS_TMPDIR}/simc_client_data.bin"
+  rm -f "${DATA_FILE}"
+  run "${SIMC_CLI_PATH}" dbc_export="${DATA_FILE}"
+  [ "${status}" -eq 0 ]
+  [ -s "${DATA_FILE}" ]
+}
+
+@test "Client data file gives the same results as the built-in data" {
+  export_data_file
+  rm -f "${BATS_TMPDIR}"/simc_dbc_*.json
+  sim deterministic=1 threads=1 json="${BATS_TMPDIR}/simc_dbc_builtin.json"
+  [ "${status}" -eq 0 ]
+  run "${SIMC_CLI_PATH}" dbc_file="${DATA_FILE}" "${SIMC_PROFILE}" iterations=${SIMC_ITERATIONS} \
+    deterministic=1 threads=1 json="${BATS_TMPDIR}/simc_dbc_file.json"
+  [ "${status}" -eq 0 ]
+  python3 -c '
+import json, sys
+a, b = [ json.load( open( f ) ) for f in sys.argv[ 1: ] ]
+dps = lambda r: [ p[ "collected_data" ][ "dps" ][ "mean" ] for p in r[ "sim" ][ "players" ] ]
+sys.exit( dps( a ) != dps( b ) )' "${BATS_TMPDIR}/simc_dbc_builtin.json" "${BATS_TMPDIR}/simc_dbc_file.json"
+}
+
+@test "Damaged client data file is an error" {
+  export_data_file
+  head -c 100000 "${DATA_FILE}" > "${DATA_FILE}.truncated"
+  run "${SIMC_CLI_PATH}" dbc_file="${DATA_FILE}.truncated" "${SIMC_PROFILE}" iterations=1
+  [ "${status}" -ne 0 ]
+  # Item count of the first section, far beyond the size of the section
+  cp "${DATA_FILE}" "${DATA_FILE}.count"
+  printf '\xff\xff\xff\x7f' | dd of="${DATA_FILE}.count" bs=1 seek=$(( 32 + 12 )) conv=notrunc
+  run "${SIMC_CLI_PATH}" dbc_file="${DATA_FILE}.count" "${SIMC_PROFILE}" iterations=1
+  [ "${status}" -ne 0 ]
+  run "${SIMC_CLI_PATH}" dbc_file="${BATS_TMPDIR}/simc_no_such_file.bin" "${SIMC_PROFILE}" iterations=1
+  [ "${status}" -ne 0 ]
+}
+
+@test "Client data file in an options file is an error" {
+  export_data_file
+  OPTIONS_FILE="${BATS_TMPDIR}/simc_dbc_options.simc"
+  echo "dbc_file=${DATA_FILE}" > "${OPTIONS_FILE}"
+  run "${SIMC_CLI_PATH}" "${SIMC_PROFILE}" "${OPTIONS_FILE}" iterations=1
+  [ "${status}" -ne 0 ]
+}
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+import json
+import os
+import sys
+import threading
+import time
+
+from http.server import BaseHTTPRequestHandler, HTTPServer
+from socketserver import ThreadingMixIn
+from urllib.parse import urlsplit, unquote
+
+
+# Stub of the Blizzard community API for armory import tests, used as an http proxy
+# (proxy=http,127.0.0.1,<port>) so that simc sends it every request. Serves a fixed guild roster
+# and a generated level 110 fire mage for any character name. Character responses are delayed, and
+# the number of character requests and the most requests in flight at once are written to
+# <directory>/stats after every request.
+# Usage: http_stub_server.py <directory> [character delay in seconds]
+
+MEMBERS = ["Alpha", "Bravo", "Charlie", "Delta", "Echo", "Foxtrot", "Golf", "Hotel"]
+
+
+class StubState:
+    def __init__(self, directory, delay):
+        self.directory = directory
+        self.delay = delay
+        self.lock = threading.Lock()
+        self.requests = 0
+        self.in_flight = 0
+        self.max_in_flight = 0
+
+    def begin(self):
+        with self.lock:
+            self.requests += 1
+            self.in_flight += 1
+            self.max_in_flight = max(self.max_in_flight, self.in_flight)
+
+    def end(self):
+        with self.lock:
+            self.in_flight -= 1
+            with open(os.path.join(self.directory, "stats"), "w") as f:
+                f.write("requests={} max_in_flight={}\n".format(self.requests, self.max_in_flight))
+
+
+def roster():
+    return {"members": [{"rank": 1, "character": {"name": name, "level": 110, "class": 8}}
+                        for name in MEMBERS]}
+
+
+def character(server, name):
+    return {"name": name, "realm": server, "level": 110, "class": 8, "race": 1,
+            "talents": [{"selected": True, "calcSpec": "Z", "calcTalent": "0000000"}]}
+
+
+class StubHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.0"
+
+    def do_GET(self):
+        segments = [unquote(s) for s in urlsplit(self.path).path.split("/") if s]
+        body = None
+        if "guild" in segments:
+            body = roster()
+        elif "character" in segments:
+            i = segments.index("character")
+            if len(segments) > i + 2:
+                self.server.state.begin()
+                time.sleep(self.server.state.delay)
+                body = character(segments[i + 1], segments[i + 2])
+                self.server.state.end()
+
+        if body is None:
+            self.send_error(404)
+            return
+
+        data = json.dumps(body).encode("utf-8")
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def log_message(self, format, *args):
+        pass
+
+
+class StubServer(ThreadingMixIn, HTTPServer):
+    daemon_threads = True
+
+
+def main():
+    directory = sys.argv[1]
+    delay = len(sys.argv) > 2 and float(sys.argv[2]) or 0.2
+
+    server = StubServer(("127.0.0.1", 0), StubHandler)
+    server.state = StubState(directory, delay)
+
+    # Written last, the test waits for this file before starting simc
+    with open(os.path.join(directory, "port.tmp"), "w") as f:
+        f.write(str(server.server_address[1]))
+    os.rename(os.path.join(directory, "port.tmp"), os.path.join(directory, "port"))
+
+    server.serve_forever()
+
+if __name__ == "__main__":
+    main()
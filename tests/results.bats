@@ -0,0 +1,37 @@
+load test_helper
+
+@test "Save and load binary results" {
+  RESULTS="${BATS_TMPDIR}/simc_results.bin"
+  rm -f "${RESULTS}" "${BATS_TMPDIR}"/simc_results_*.json
+  run "${SIMC_CLI_PATH}" "${SIMC_PROFILE}" iterations=${SIMC_ITERATIONS} threads=2 \
+    save_results="${RESULTS}" json="${BATS_TMPDIR}/simc_results_sim.json"
+  [ "${status}" -eq 0 ]
+  [ -s "${RESULTS}" ]
+  run "${SIMC_CLI_PATH}" "${SIMC_PROFILE}" iterations=${SIMC_ITERATIONS} threads=2 \
+    load_results="${RESULTS}" json="${BATS_TMPDIR}/simc_results_load.json"
+  [ "${status}" -eq 0 ]
+  [ -s "${BATS_TMPDIR}/simc_results_load.json" ]
+  # Loaded results are analyzed again, and must report what the simulation reported
+  python3 -c '
+import json, math, sys
+def same( a, b, path ):
+  if isinstance( a, dict ) and isinstance( b, dict ):
+    assert sorted( a ) == sorted( b ), path
+    for k in a:
+      same( a[ k ], b[ k ], path + "." + k )
+  elif isinstance( a, list ) and isinstance( b, list ):
+    assert len( a ) == len( b ), path
+    for i, ( x, y ) in enumerate( zip( a, b ) ):
+      same( x, y, "%s[%d]" % ( path, i ) )
+  elif isinstance( a, float ) or isinstance( b, float ):
+    assert ( math.isnan( a ) and math.isnan( b ) ) or math.isclose( a, b, rel_tol = 1e-9, abs_tol = 1e-9 ), ( path, a, b )
+  else:
+    assert a == b, ( path, a, b )
+a, b = [ json.load( open( f ) )[ "sim" ] for f in sys.argv[ 1: ] ]
+same( a[ "raid_dps" ], b[ "raid_dps" ], "raid_dps" )
+assert len( a[ "players" ] ) == len( b[ "players" ] )
+for p, q in zip( a[ "players" ], b[ "players" ] ):
+  same( p[ "collected_data" ][ "dps" ], q[ "collected_data" ][ "dps" ], p[ "name" ] + ".dps" )
+  same( p[ "stats" ], q[ "stats" ], p[ "name" ] + ".stats" )' \
+    "${BATS_TMPDIR}/simc_results_sim.json" "${BATS_TMPDIR}/simc_results_load.json"
+}
@@ -0,0 +1,34 @@
+load test_helper
+
+@test "Spell query xml and json lines output" {
+  XML="${BATS_TMPDIR}/simc_spell_query.xml"
+  JSON="${BATS_TMPDIR}/simc_spell_query.jsonl"
+  rm -f "${XML}" "${JSON}"
+  run "${SIMC_CLI_PATH}" spell_query=spell.class=mage \
+    spell_query_xml_output_file="${XML}" spell_query_json_output_file="${JSON}"
+  [ "${status}" -eq 0 ]
+  [ -s "${JSON}" ]
+  [ "$(grep -c '^  <spell ' "${XML}")" -eq "$(wc -l < "${JSON}")" ]
+  python3 -c 'import json, sys; [ json.loads( line ) for line in open( sys.argv[ 1 ] ) ]' "${JSON}"
+}
+
+@test "Spell query json effect members match the xml output" {
+  XML="${BATS_TMPDIR}/simc_effect_query.xml"
+  JSON="${BATS_TMPDIR}/simc_effect_query.jsonl"
+  rm -f "${XML}" "${JSON}"
+  # Fireball
+  run "${SIMC_CLI_PATH}" spell_query=effect.spell_id=133 \
+    spell_query_xml_output_file="${XML}" spell_query_json_output_file="${JSON}"
+  [ "${status}" -eq 0 ]
+  python3 -c '
+import json, sys
+import xml.etree.ElementTree as et
+effects = [ json.loads( line ) for line in open( sys.argv[ 2 ] ) ]
+nodes = et.parse( sys.argv[ 1 ] ).getroot().findall( "effect" )
+assert effects and len( effects ) == len( nodes )
+for effect, node in zip( effects, nodes ):
+  assert effect.pop( "kind" ) == "effect"
+  assert { k: v for k, v in effect.items() if not isinstance( v, list ) } == node.attrib, ( effect, node.attrib )
+# The school damage effect keeps its numeric effect type
+assert any( e[ "type" ] == "2" and e[ "type_text" ] == "School Damage" and e[ "school" ] for e in effects )' "${XML}" "${JSON}"
+}
@@ -0,0 +1,53 @@
+load test_helper
+
+# Run the sim twice, logging and tracing, and compare the decoded trace with the combat log.
+# $1 names the output files.
+function check_trace() {
+  LOG="${BATS_TMPDIR}/simc_trace_log_$1.txt"
+  TRACE="${BATS_TMPDIR}/simc_trace_$1.bin"
+  rm -f "${LOG}" "${TRACE}"
+  sim iterations=1 threads=1 deterministic=1 log=1 output="${LOG}"
+  [ "${status}" -eq 0 ]
+  sim iterations=1 threads=1 deterministic=1 trace="${TRACE}" output=/dev/null
+  [ "${status}" -eq 0 ]
+  python3 "${BATS_TEST_DIRNAME}"/../util_scripts/decode_trace.py "${TRACE}" > "${TRACE}.txt"
+  # The log lines of every traced event type, in order, must be exactly the decoded trace
+  python3 -c '
+import re, sys
+traced = re.compile( "|".join( [
+  r" performs .* \([-0-9]+\)$",
+  r" consumes [-0-9.]+ .* for .* \([-0-9]+\)$",
+  r" hits .* for [-0-9]+ .* damage \(.*\)$",
+  r" ticks \([0-9]+ of [0-9]+\) .* for [-0-9]+ .* damage \(.*\)$",
+  r" heals .* for [-0-9]+ \([-0-9]+\) \(.*\)$",
+  r" ticks \([0-9]+ of [0-9]+\) .* for [-0-9]+ \([-0-9]+\) heal \(.*\)$",
+  r"^[0-9.]+ Target .* avoids ",
+  r" gains \S+_[0-9]+ \( value=\S+ \)$",
+  r" loses \S+$",
+  r" gains [-0-9.]+ \([-0-9.]+\) .* from .* \([-0-9.]+/[-0-9.]+\)$" ] ) )
+log = [ l.rstrip( "\n" ) for l in open( sys.argv[ 1 ] ) if traced.search( l ) ]
+trace = [ l.rstrip( "\n" ) for l in open( sys.argv[ 2 ] ) if "------" not in l ]
+assert any( " performs " in l for l in trace )
+for i, ( l, t ) in enumerate( zip( log, trace ) ):
+  assert l == t, "line %d: log \"%s\", trace \"%s\"" % ( i, l, t )
+assert len( log ) == len( trace ), ( len( log ), len( trace ) )' "${LOG}" "${TRACE}.txt"
+}
+
+@test "Decoded trace matches the combat log" {
+  check_trace default
+}
+
+@test "Decoded trace matches the combat log of a combo point spender" {
+  SIMC_PROFILE="$(dirname "${SIMC_PROFILE}")"/Druid_Feral_T19P.simc
+  check_trace feral
+}
+
+@test "Trace of a threaded sim" {
+  TRACE="${BATS_TMPDIR}/simc_trace_threads.bin"
+  rm -f "${TRACE}"
+  sim iterations=20 threads=2 trace="${TRACE}" output=/dev/null
+  [ "${status}" -eq 0 ]
+  run python3 "${BATS_TEST_DIRNAME}"/../util_scripts/decode_trace.py "${TRACE}"
+  [ "${status}" -eq 0 ]
+  [ "$(printf '%s\n' "${lines[@]}" | grep -c ' Iteration #')" -eq 20 ]
+}
@@ -0,0 +1,145 @@
+#!/usr/bin/python
+import errno
+import sys
+import struct
+
+
+# Converts a binary combat trace (trace=<file>) to the text of log=1. The trace is read one block
+# at a time, so that traces of many iterations can be decoded, or piped to grep, without loading
+# them into memory. Every sim thread writes its own blocks, which are interleaved in the file;
+# a "------ Thread N ------" line is printed where the thread changes, and --thread=N only decodes
+# the records of one thread. The record layouts are documented in engine/sim/sc_trace.cpp.
+# Usage: decode_trace.py <trace file> [--thread=N]
+TRACE_VERSION = 1
+
+RECORD_NAME = 1
+RECORD_ITERATION = 2
+RECORD_EXECUTE = 3
+RECORD_CONSUME = 4
+RECORD_DAMAGE = 5
+RECORD_HEAL = 6
+RECORD_AVOID = 7
+RECORD_BUFF_GAIN = 8
+RECORD_BUFF_LOSS = 9
+RECORD_RESOURCE_GAIN = 10
+
+HEADER = struct.Struct("<Bi")
+LAYOUTS = {
+    RECORD_ITERATION: struct.Struct("<i"),
+    RECORD_EXECUTE: struct.Struct("<IId"),
+    RECORD_CONSUME: struct.Struct("<IIIdd"),
+    RECORD_DAMAGE: struct.Struct("<IIIIIdii"),
+    RECORD_HEAL: struct.Struct("<IIIIddii"),
+    RECORD_AVOID: struct.Struct("<IIII"),
+    RECORD_BUFF_GAIN: struct.Struct("<IIid"),
+    RECORD_BUFF_LOSS: struct.Struct("<II"),
+    RECORD_RESOURCE_GAIN: struct.Struct("<IIIdddd"),
+}
+NAME = struct.Struct("<IH")
+
+
+def format_record(kind, n, f):
+    if kind == RECORD_ITERATION:
+        return "------ Iteration #%i ------" % (f[0] + 1)
+    if kind == RECORD_EXECUTE:
+        return "%s performs %s (%.0f)" % (n(f[0]), n(f[1]), f[2])
+    if kind == RECORD_CONSUME:
+        return "%s consumes %.1f %s for %s (%.0f)" % (n(f[0]), f[3], n(f[2]), n(f[1]), f[4])
+    if kind == RECORD_DAMAGE:
+        if f[6] < 0:
+            return "%s %s hits %s for %.0f %s damage (%s)" % (n(f[0]), n(f[1]), n(f[2]), f[5], n(f[3]), n(f[4]))
+        return "%s %s ticks (%d of %d) %s for %.0f %s damage (%s)" % (
+            n(f[0]), n(f[1]), f[6], f[7], n(f[2]), f[5], n(f[3]), n(f[4]))
+    if kind == RECORD_HEAL:
+        if f[6] < 0:
+            return "%s %s heals %s for %.0f (%.0f) (%s)" % (n(f[0]), n(f[1]), n(f[2]), f[4], f[5], n(f[3]))
+        return "%s %s ticks (%d of %d) %s for %.0f (%.0f) heal (%s)" % (
+            n(f[0]), n(f[1]), f[6], f[7], n(f[2]), f[4], f[5], n(f[3]))
+    if kind == RECORD_AVOID:
+        return "Target %s avoids %s %s (%s)" % (n(f[0]), n(f[1]), n(f[2]), n(f[3]))
+    if kind == RECORD_BUFF_GAIN:
+        return "%s gains %s_%d ( value=%.2f )" % (f[0] and n(f[0]) or "Raid", n(f[1]), f[2], f[3])
+    if kind == RECORD_BUFF_LOSS:
+        return "%s loses %s" % (f[0] and n(f[0]) or "Raid", n(f[1]))
+    if kind == RECORD_RESOURCE_GAIN:
+        return "%s gains %.2f (%.2f) %s from %s (%.2f/%.2f)" % (
+            n(f[0]), f[3], f[4], n(f[1]), n(f[2]), f[5], f[6])
+    raise ValueError("unknown record type {}".format(kind))
+
+
+def decode_block(block, names, out):
+    def n(name_id):
+        return names[name_id]
+
+    offset = 0
+    while offset < len(block):
+        kind, millis = HEADER.unpack_from(block, offset)
+        offset += HEADER.size
+        if kind == RECORD_NAME:
+            name_id, length = NAME.unpack_from(block, offset)
+            offset += NAME.size
+            names[name_id] = block[offset:offset + length].decode("utf-8", "replace")
+            offset += length
+            continue
+
+        layout = LAYOUTS[kind]
+        fields = layout.unpack_from(block, offset)
+        offset += layout.size
+        out.write("%.3f %s\n" % (millis / 1000.0, format_record(kind, n, fields)))
+
+
+def read_exactly(f, size):
+    data = f.read(size)
+    if len(data) != size:
+        raise EOFError
+    return data
+
+
+def decode(f, out, thread=None):
+    magic, version = struct.unpack("<4sI", read_exactly(f, 8))
+    if magic != b"SCTR" or version != TRACE_VERSION:
+        raise ValueError("not a version {} simc trace".format(TRACE_VERSION))
+
+    names = {}
+    last_writer = None
+    while True:
+        header = f.read(8)
+        if not header:
+            break
+        writer, size = struct.unpack("<II", header)
+        block = read_exactly(f, size)
+        if thread is not None and writer != thread:
+            continue
+
+        if thread is None and writer != last_writer and (last_writer is not None or writer != 0):
+            out.write("------ Thread %d ------\n" % writer)
+        last_writer = writer
+        decode_block(block, names.setdefault(writer, {0: ""}), out)
+
+
+def main():
+    thread = None
+    files = []
+    for arg in sys.argv[1:]:
+        if arg.startswith("--thread="):
+            thread = int(arg[len("--thread="):])
+        else:
+            files.append(arg)
+
+    if len(files) != 1:
+        sys.stderr.write("Usage: decode_trace.py <trace file> [--thread=N]\n")
+        sys.exit(1)
+
+    with open(files[0], "rb") as f:
+        try:
+            decode(f, sys.stdout, thread)
+        except EOFError:
+            sys.stderr.write("Truncated trace file '{}'\n".format(files[0]))
+            sys.exit(1)
+        except IOError as e:
+            # Output closed early, eg. piped to head
+            if e.errno != errno.EPIPE:
+                raise
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,55 @@
+#!/usr/bin/python
+import sys
+import os
+import subprocess
+import math
+import tempfile
+
+import numpy as np
+import xml.etree.ElementTree as ET
+
+
+# Measures the cpu time of multi-target simulations, which stress per-target data (target data,
+# dots, debuffs). Every profile is simulated against the eight enemies of aoe_enemies.simc, and
+# against a single enemy with waves of adds spawned by raid events.
+# Usage: measure_aoe_time.py [simc binary] [repetitions] [profile ...]
+def main():
+    simc_bin = len(sys.argv) > 1 and sys.argv[1] or "../engine/simc"
+    num_repetitions = len(sys.argv) > 2 and int(sys.argv[2]) or 10
+    profiles = sys.argv[3:] or [
+        "../profiles/Tier19M/Rogue_Assassination_T19M.simc",
+        "../profiles/Tier19M/Priest_Shadow_T19M.simc",
+        "../profiles/Tier19M/Hunter_MM_T19M.simc",
+    ]
+
+    scenarios = {
+        "aoe_enemies": ["../profiles/aoe_enemies.simc"],
+        "add_waves": ["raid_events=/adds,count=10,first=15,cooldown=30,duration=20"],
+    }
+
+    iterations = 500
+    threads = 1
+    output_dir = tempfile.mkdtemp()
+    xml_file = os.path.join(output_dir, "aoe.xml")
+
+    for profile in profiles:
+        for scenario, options in sorted(scenarios.items()):
+            list_cpu_seconds = []
+            for repetition in range(num_repetitions):
+                command = [simc_bin, profile] + options + [
+                    "deterministic=1", "iterations={}".format(iterations),
+                    "threads={}".format(threads), "output=/dev/null", "xml={}".format(xml_file)]
+                subprocess.call(command)
+
+                root = ET.parse(xml_file).getroot()
+                list_cpu_seconds.append(float(root.find("performance").find("cpu_seconds").text))
+
+            print("{profile} ({scenario}): mean={mean:.3f}s stddev={stddev:.3f}s stddev/sqrt(N)={err:.3f}s".format(
+                profile=os.path.basename(profile),
+                scenario=scenario,
+                mean=np.mean(list_cpu_seconds),
+                stddev=np.std(list_cpu_seconds),
+                err=np.std(list_cpu_seconds) / math.sqrt(num_repetitions)))
+
+if __name__ == "__main__":
+    main()
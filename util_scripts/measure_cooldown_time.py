@@ -0,0 +1,49 @@
+#!/usr/bin/python
+import sys
+import os
+import subprocess
+import math
+import tempfile
+
+import numpy as np
+import xml.etree.ElementTree as ET
+
+
+# Measures the cpu time and the number of processed events of simulations with charge based
+# cooldowns and frequent cooldown reductions (Restless Blades, Kindling, Fire Blast charges).
+# Usage: measure_cooldown_time.py [simc binary] [repetitions] [profile ...]
+def main():
+    simc_bin = len(sys.argv) > 1 and sys.argv[1] or "../engine/simc"
+    num_repetitions = len(sys.argv) > 2 and int(sys.argv[2]) or 10
+    profiles = sys.argv[3:] or [
+        "../profiles/Tier19M/Rogue_Outlaw_T19M.simc",
+        "../profiles/Tier19M/Mage_Fire_T19M.simc",
+    ]
+
+    iterations = 1000
+    threads = 1
+    output_dir = tempfile.mkdtemp()
+    xml_file = os.path.join(output_dir, "cooldown.xml")
+
+    for profile in profiles:
+        list_cpu_seconds = []
+        total_events = 0
+        for repetition in range(num_repetitions):
+            command = [simc_bin, profile,
+                       "deterministic=1", "iterations={}".format(iterations),
+                       "threads={}".format(threads), "output=/dev/null", "xml={}".format(xml_file)]
+            subprocess.call(command)
+
+            performance = ET.parse(xml_file).getroot().find("performance")
+            list_cpu_seconds.append(float(performance.find("cpu_seconds").text))
+            total_events = int(performance.find("total_events").text)
+
+        print("{profile}: mean={mean:.3f}s stddev={stddev:.3f}s stddev/sqrt(N)={err:.3f}s events/iteration={events:.0f}".format(
+            profile=os.path.basename(profile),
+            mean=np.mean(list_cpu_seconds),
+            stddev=np.std(list_cpu_seconds),
+            err=np.std(list_cpu_seconds) / math.sqrt(num_repetitions),
+            events=float(total_events) / iterations))
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,53 @@
+#!/usr/bin/python
+import sys
+import os
+import subprocess
+import math
+import tempfile
+
+import numpy as np
+import xml.etree.ElementTree as ET
+
+
+# Measures the cpu time of distance targeting simulations with an increasing number of enemies,
+# spread out on a grid in front of the player so that only some of them are in range of each
+# area of effect ability.
+# Usage: measure_distance_targeting.py [simc binary] [repetitions] [profile]
+def main():
+    simc_bin = len(sys.argv) > 1 and sys.argv[1] or "../engine/simc"
+    num_repetitions = len(sys.argv) > 2 and int(sys.argv[2]) or 5
+    profile = len(sys.argv) > 3 and sys.argv[3] or "../profiles/Tier19M/Mage_Fire_T19M.simc"
+
+    target_counts = [1, 2, 5, 10, 20, 30, 40, 50]
+    spacing = 6.0
+    iterations = 250
+    output_dir = tempfile.mkdtemp()
+    xml_file = os.path.join(output_dir, "distance.xml")
+
+    for num_targets in target_counts:
+        enemies = []
+        per_row = int(math.ceil(math.sqrt(num_targets)))
+        for i in range(num_targets):
+            enemies += ["enemy=enemy{}".format(i + 1),
+                        "x_pos={:.1f}".format(5 + spacing * (i % per_row)),
+                        "y_pos={:.1f}".format(spacing * (i // per_row - per_row / 2.0))]
+
+        list_cpu_seconds = []
+        for repetition in range(num_repetitions):
+            command = [simc_bin, profile] + enemies + [
+                "distance_targeting_enabled=1", "deterministic=1",
+                "iterations={}".format(iterations), "threads=1",
+                "output=/dev/null", "xml={}".format(xml_file)]
+            subprocess.call(command)
+
+            root = ET.parse(xml_file).getroot()
+            list_cpu_seconds.append(float(root.find("performance").find("cpu_seconds").text))
+
+        print("targets={n}: mean={mean:.3f}s stddev={stddev:.3f}s stddev/sqrt(N)={err:.3f}s".format(
+            n=num_targets,
+            mean=np.mean(list_cpu_seconds),
+            stddev=np.std(list_cpu_seconds),
+            err=np.std(list_cpu_seconds) / math.sqrt(num_repetitions)))
+
+if __name__ == "__main__":
+    main()
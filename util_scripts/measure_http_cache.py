@@ -0,0 +1,84 @@
+#!/usr/bin/python
+import sys
+import os
+import re
+import struct
+import subprocess
+import math
+import tempfile
+import time
+
+import numpy as np
+
+
+# Measures the startup cost of a large http cache. A cache of armory-sized entries is written in
+# both the single file layout of older versions (simc_cache.dat) and the one file per entry layout
+# (simc_cache/), and short simc invocations are timed with XDG_CACHE_HOME pointing at an empty
+# directory and at the populated cache. The difference is the per-process cost of the cache, for
+# whichever layout the binary uses.
+# Usage: measure_http_cache.py [simc binary] [repetitions] [cache entries] [entry size in bytes]
+def fnv1a(data):
+    h = 14695981039346656037
+    for c in bytearray(data):
+        h ^= c
+        h = (h * 1099511628211) & 0xffffffffffffffff
+    return h
+
+
+def sc_version():
+    with open(os.path.join(os.path.dirname(os.path.abspath(__file__)), "../engine/simulationcraft.hpp")) as f:
+        header = f.read()
+    major = re.search(r'#define SC_MAJOR_VERSION "([^"]*)"', header).group(1)
+    minor = re.search(r'#define SC_MINOR_VERSION "([^"]*)"', header).group(1)
+    return "{}-{}".format(major, minor)
+
+
+def populate(cache_home, num_entries, entry_size):
+    version = sc_version().encode("ascii") + b"\0"
+    entry_dir = os.path.join(cache_home, "simc_cache")
+    os.mkdir(entry_dir)
+    with open(os.path.join(cache_home, "simc_cache.dat"), "wb") as dat:
+        dat.write(version)
+        for i in range(num_entries):
+            url = "https://us.api.battle.net/wow/character/realm/Name{}?fields=talents,items".format(i).encode("ascii")
+            content = b"x" * entry_size
+            record = url + b"\0" + b"\0" + struct.pack("<I", len(content)) + content
+            dat.write(record)
+            with open(os.path.join(entry_dir, "{:016x}".format(fnv1a(url))), "wb") as f:
+                f.write(version + record)
+
+
+def measure(command, env, num_repetitions):
+    list_seconds = []
+    with open("/dev/null", "w") as devnull:
+        for repetition in range(num_repetitions):
+            start = time.time()
+            subprocess.call(command, stdout=devnull, stderr=devnull, env=env)
+            list_seconds.append(time.time() - start)
+    return list_seconds
+
+
+def main():
+    simc_bin = len(sys.argv) > 1 and sys.argv[1] or "../engine/simc"
+    num_repetitions = len(sys.argv) > 2 and int(sys.argv[2]) or 20
+    num_entries = len(sys.argv) > 3 and int(sys.argv[3]) or 10000
+    entry_size = len(sys.argv) > 4 and int(sys.argv[4]) or 16 * 1024
+
+    empty_home = tempfile.mkdtemp()
+    cache_home = tempfile.mkdtemp()
+    populate(cache_home, num_entries, entry_size)
+
+    command = [simc_bin, "spell_query=spell.id=774"]
+    for name, home in (("empty cache", empty_home), ("{} entries".format(num_entries), cache_home)):
+        env = dict(os.environ)
+        env["XDG_CACHE_HOME"] = home
+        list_seconds = measure(command, env, num_repetitions)
+        print("{name}: mean={mean:.4f}s stddev={stddev:.4f}s stddev/sqrt(N)={err:.4f}s min={min:.4f}s".format(
+            name=name,
+            mean=np.mean(list_seconds),
+            stddev=np.std(list_seconds),
+            err=np.std(list_seconds) / math.sqrt(num_repetitions),
+            min=np.min(list_seconds)))
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,49 @@
+#!/usr/bin/python
+import sys
+import os
+import glob
+import re
+import subprocess
+import math
+import tempfile
+
+import numpy as np
+
+
+# Measures the time taken to write the JSON report of a 20 actor raid, with full report details.
+# The report time is the one printed by the simulator ("JSON report took Xseconds."), so the
+# time spent simulating is not included.
+# Usage: measure_json_report.py [simc binary] [repetitions] [profile directory]
+def main():
+    simc_bin = len(sys.argv) > 1 and sys.argv[1] or "../engine/simc"
+    num_repetitions = len(sys.argv) > 2 and int(sys.argv[2]) or 10
+    profile_dir = len(sys.argv) > 3 and sys.argv[3] or "../profiles/Tier19M"
+
+    num_actors = 20
+    profiles = sorted(glob.glob(os.path.join(profile_dir, "*.simc")))[:num_actors]
+    iterations = 100
+    output_dir = tempfile.mkdtemp()
+    json_file = os.path.join(output_dir, "report.json")
+    report_time = re.compile(r"JSON report took ([0-9.eE+-]+)seconds\.")
+
+    list_seconds = []
+    for repetition in range(num_repetitions):
+        command = [simc_bin] + profiles + [
+            "deterministic=1", "iterations={}".format(iterations), "threads=1",
+            "report_details=1", "output=/dev/null", "json={}".format(json_file)]
+        output = subprocess.check_output(command).decode("utf-8", "replace")
+
+        match = report_time.search(output)
+        if not match:
+            sys.exit("No JSON report time in the simulator output")
+        list_seconds.append(float(match.group(1)))
+
+    print("{n} actors, {size} bytes: mean={mean:.3f}s stddev={stddev:.3f}s stddev/sqrt(N)={err:.3f}s".format(
+        n=len(profiles),
+        size=os.path.getsize(json_file),
+        mean=np.mean(list_seconds),
+        stddev=np.std(list_seconds),
+        err=np.std(list_seconds) / math.sqrt(num_repetitions)))
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,59 @@
+#!/usr/bin/python
+import sys
+import os
+import glob
+import subprocess
+import math
+import tempfile
+import time
+
+import numpy as np
+
+
+# Measures the startup time of a large multi-profile input, where option parsing (sim and player
+# options, repeated in every child sim) is a significant part of the work. All profiles of a
+# directory are copied several times with per-player option overrides, and simulated for a
+# single iteration so that the wall time is dominated by setup and initialization.
+# Usage: measure_option_parsing.py [simc binary] [repetitions] [profile directory] [threads]
+def main():
+    simc_bin = len(sys.argv) > 1 and sys.argv[1] or "../engine/simc"
+    num_repetitions = len(sys.argv) > 2 and int(sys.argv[2]) or 10
+    profile_dir = len(sys.argv) > 3 and sys.argv[3] or "../profiles/Tier19M"
+    threads = len(sys.argv) > 4 and int(sys.argv[4]) or 4
+
+    num_copies = 4
+    profiles = sorted(glob.glob(os.path.join(profile_dir, "*.simc")))
+    output_dir = tempfile.mkdtemp()
+    input_file = os.path.join(output_dir, "options.simc")
+
+    num_actors = 0
+    with open(input_file, "w") as f:
+        for profile in profiles:
+            name = os.path.splitext(os.path.basename(profile))[0]
+            f.write("input={}\n".format(os.path.abspath(profile)))
+            num_actors += 1
+            for copy in range(num_copies):
+                f.write("copy={}_{}\n".format(name, copy))
+                f.write("position={}\n".format(copy % 2 and "back" or "front"))
+                f.write("quiet=1\n")
+                num_actors += 1
+
+    list_seconds = []
+    with open("/dev/null", "w") as devnull:
+        for repetition in range(num_repetitions):
+            command = [simc_bin, input_file, "iterations={}".format(threads), "threads={}".format(threads),
+                       "deterministic=1", "output=/dev/null"]
+            start = time.time()
+            subprocess.call(command, stdout=devnull, stderr=devnull)
+            list_seconds.append(time.time() - start)
+
+    print("{n} actors, threads={threads}: mean={mean:.3f}s stddev={stddev:.3f}s stddev/sqrt(N)={err:.3f}s min={min:.3f}s".format(
+        n=num_actors,
+        threads=threads,
+        mean=np.mean(list_seconds),
+        stddev=np.std(list_seconds),
+        err=np.std(list_seconds) / math.sqrt(num_repetitions),
+        min=np.min(list_seconds)))
+
+if __name__ == "__main__":
+    main()
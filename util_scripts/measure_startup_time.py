@@ -0,0 +1,39 @@
+#!/usr/bin/python
+import sys
+import subprocess
+import math
+import time
+
+import numpy as np
+
+
+# Measures the wall time of short simc invocations, dominated by process startup (client data
+# initialization). Usage: measure_startup_time.py [simc binary] [repetitions]
+def main():
+    simc_bin = len(sys.argv) > 1 and sys.argv[1] or "../engine/simc"
+    num_repetitions = len(sys.argv) > 2 and int(sys.argv[2]) or 50
+
+    commands = {
+        "spell_query (live)": [simc_bin, "spell_query=spell.id=774"],
+        "spell_query (ptr)": [simc_bin, "ptr=1", "spell_query=spell.id=774"],
+        "spell_query (all)": [simc_bin, "spell_query=spell.class=druid"],
+        "no-op": [simc_bin],
+    }
+
+    for name, command in sorted(commands.items()):
+        list_seconds = []
+        with open("/dev/null", "w") as devnull:
+            for repetition in range(num_repetitions):
+                start = time.time()
+                subprocess.call(command, stdout=devnull, stderr=devnull)
+                list_seconds.append(time.time() - start)
+
+        print("{name}: mean={mean:.4f}s stddev={stddev:.4f}s stddev/sqrt(N)={err:.4f}s min={min:.4f}s".format(
+            name=name,
+            mean=np.mean(list_seconds),
+            stddev=np.std(list_seconds),
+            err=np.std(list_seconds) / math.sqrt(num_repetitions),
+            min=np.min(list_seconds)))
+
+if __name__ == "__main__":
+    main()
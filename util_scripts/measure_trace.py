@@ -0,0 +1,57 @@
+#!/usr/bin/python
+import sys
+import os
+import subprocess
+import math
+import tempfile
+import time
+
+import numpy as np
+
+
+# Measures the cost of recording the combat log as text (log=1) and as a binary trace (trace=).
+# log=1 limits the sim to a single thread and iteration, so all three variants run a single
+# iteration of the profile, repeated. The size of the text log and of the trace is printed, and the
+# trace is decoded once to time the offline conversion.
+# Usage: measure_trace.py [simc binary] [profile] [repetitions]
+def measure(command, num_repetitions):
+    list_seconds = []
+    with open(os.devnull, "w") as devnull:
+        for repetition in range(num_repetitions):
+            start = time.time()
+            subprocess.call(command, stdout=devnull, stderr=devnull)
+            list_seconds.append(time.time() - start)
+    return list_seconds
+
+
+def main():
+    simc_bin = len(sys.argv) > 1 and sys.argv[1] or "../engine/simc"
+    profile = len(sys.argv) > 2 and sys.argv[2] or "../profiles/Tier19M/Mage_Fire_T19M.simc"
+    num_repetitions = len(sys.argv) > 3 and int(sys.argv[3]) or 20
+
+    output_dir = tempfile.mkdtemp()
+    log_file = os.path.join(output_dir, "log.txt")
+    trace_file = os.path.join(output_dir, "trace.bin")
+    base = [simc_bin, profile, "iterations=1", "threads=1", "deterministic=1"]
+
+    variants = (("no log", base + ["output=" + os.devnull]),
+                ("log=1", base + ["log=1", "output=" + log_file]),
+                ("trace", base + ["trace=" + trace_file, "output=" + os.devnull]))
+    for name, command in variants:
+        list_seconds = measure(command, num_repetitions)
+        print("{name}: mean={mean:.4f}s stddev={stddev:.4f}s stddev/sqrt(N)={err:.4f}s min={min:.4f}s".format(
+            name=name,
+            mean=np.mean(list_seconds),
+            stddev=np.std(list_seconds),
+            err=np.std(list_seconds) / math.sqrt(num_repetitions),
+            min=np.min(list_seconds)))
+
+    decoder = os.path.join(os.path.dirname(os.path.abspath(__file__)), "decode_trace.py")
+    start = time.time()
+    with open(os.devnull, "w") as devnull:
+        subprocess.call([sys.executable, decoder, trace_file], stdout=devnull)
+    print("log: {} bytes, trace: {} bytes, decoded in {:.4f}s".format(
+        os.path.getsize(log_file), os.path.getsize(trace_file), time.time() - start))
+
+if __name__ == "__main__":
+    main()
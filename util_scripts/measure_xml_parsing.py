@@ -0,0 +1,110 @@
+#!/usr/bin/python
+import sys
+import os
+import re
+import struct
+import subprocess
+import math
+import tempfile
+import time
+
+import numpy as np
+
+
+# Measures the import of items from wowhead XML documents. A set of large synthetic item documents
+# (a few hundred kilobytes of tooltip markup each) is written to the http cache, in the layout of
+# measure_http_cache.py, and a raid of actors wearing those items is simulated for a single
+# iteration with item_db_source=wowhead, so that the wall time is dominated by XML parsing.
+# Usage: measure_xml_parsing.py [simc binary] [repetitions] [actors] [tooltip spans per item]
+SLOTS = [("head", 1), ("neck", 2), ("shoulders", 3), ("back", 16), ("chest", 5), ("wrists", 9),
+         ("hands", 10), ("waist", 6), ("legs", 7), ("feet", 8), ("finger1", 11), ("finger2", 11),
+         ("trinket1", 12), ("trinket2", 12)]
+
+
+def fnv1a(data):
+    h = 14695981039346656037
+    for c in bytearray(data):
+        h ^= c
+        h = (h * 1099511628211) & 0xffffffffffffffff
+    return h
+
+
+def sc_version():
+    with open(os.path.join(os.path.dirname(os.path.abspath(__file__)), "../engine/simulationcraft.hpp")) as f:
+        header = f.read()
+    major = re.search(r'#define SC_MAJOR_VERSION "([^"]*)"', header).group(1)
+    minor = re.search(r'#define SC_MINOR_VERSION "([^"]*)"', header).group(1)
+    return "{}-{}".format(major, minor)
+
+
+def item_xml(item_id, slot, num_spans):
+    tooltip = "".join('<table><tr><td><span class="q{0}">Line &amp; text {0}</span><br />'
+                      '<a href="/item={1}" class="q1">Link</a></td></tr></table>'.format(i, item_id)
+                      for i in range(num_spans))
+    tooltip += '<span>Equip: <a href="/spell=1234">Effect</a></span>'
+    return ('<?xml version="1.0" encoding="UTF-8"?><wowhead><item id="{id}">'
+            '<name><![CDATA[Benchmark Item {id}]]></name><level>880</level><quality id="4">Epic</quality>'
+            '<class id="4"><![CDATA[Armor]]></class><subclass id="4"><![CDATA[Plate Armor]]></subclass>'
+            '<icon displayId="1">inv_misc_questionmark</icon><inventorySlot id="{slot}">Slot</inventorySlot>'
+            '<htmlTooltip><![CDATA[{tooltip}]]></htmlTooltip>'
+            '<json><![CDATA["id":{id},"name":"Benchmark Item {id}","level":880,"slot":{slot},"classs":4,"subclass":4]]></json>'
+            '<jsonEquip><![CDATA["str":400,"sta":600,"critstrkrtng":300,"mastrtng":200]]></jsonEquip>'
+            '<link>http://www.wowhead.com/item={id}</link></item></wowhead>').format(
+                id=item_id, slot=slot, tooltip=tooltip).encode("ascii")
+
+
+def populate(cache_home, num_actors, num_spans):
+    version = sc_version().encode("ascii") + b"\0"
+    entry_dir = os.path.join(cache_home, "simc_cache")
+    os.mkdir(entry_dir)
+    with open(os.path.join(cache_home, "simc_cache.dat"), "wb") as dat:
+        dat.write(version)
+        for actor in range(num_actors):
+            for index, (slot_name, slot) in enumerate(SLOTS):
+                item_id = 900000 + actor * len(SLOTS) + index
+                url = "http://www.wowhead.com/item={}&xml".format(item_id).encode("ascii")
+                content = item_xml(item_id, slot, num_spans)
+                record = url + b"\0" + b"\0" + struct.pack("<I", len(content)) + content
+                dat.write(record)
+                with open(os.path.join(entry_dir, "{:016x}".format(fnv1a(url))), "wb") as f:
+                    f.write(version + record)
+
+
+def main():
+    simc_bin = len(sys.argv) > 1 and sys.argv[1] or "../engine/simc"
+    num_repetitions = len(sys.argv) > 2 and int(sys.argv[2]) or 10
+    num_actors = len(sys.argv) > 3 and int(sys.argv[3]) or 20
+    num_spans = len(sys.argv) > 4 and int(sys.argv[4]) or 2000
+
+    cache_home = tempfile.mkdtemp()
+    populate(cache_home, num_actors, num_spans)
+
+    input_file = os.path.join(cache_home, "items.simc")
+    with open(input_file, "w") as f:
+        for actor in range(num_actors):
+            f.write("warrior=Bench{}\nlevel=110\nrace=human\nspec=protection\n".format(actor))
+            for index, (slot_name, slot) in enumerate(SLOTS):
+                f.write("{}=,id={}\n".format(slot_name, 900000 + actor * len(SLOTS) + index))
+
+    env = dict(os.environ)
+    env["XDG_CACHE_HOME"] = cache_home
+    command = [simc_bin, input_file, "item_db_source=wowhead", "cache_items=only", "iterations=1",
+               "threads=1", "output=/dev/null"]
+
+    list_seconds = []
+    with open("/dev/null", "w") as devnull:
+        for repetition in range(num_repetitions):
+            start = time.time()
+            subprocess.call(command, stdout=devnull, stderr=devnull, env=env)
+            list_seconds.append(time.time() - start)
+
+    print("{n} items of {size} kB: mean={mean:.3f}s stddev={stddev:.3f}s stddev/sqrt(N)={err:.3f}s min={min:.3f}s".format(
+        n=num_actors * len(SLOTS),
+        size=len(item_xml(900000, 1, num_spans)) // 1024,
+        mean=np.mean(list_seconds),
+        stddev=np.std(list_seconds),
+        err=np.std(list_seconds) / math.sqrt(num_repetitions),
+        min=np.min(list_seconds)))
+
+if __name__ == "__main__":
+    main()